@@ -0,0 +1,70 @@
+//
+// Created by chris on 10/18/26.
+//
+// Snapshotting a long arm every tick for rollback, and loading one from disk
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <RobotArm/Simulation/ArmSnapshot.hpp>
+
+namespace
+{
+// Link, Hinge, Piston, Swivel pattern with every joint moving
+Simulation make_arm(std::size_t component_count)
+{
+	Simulation sim;
+	for (std::size_t i = 0; i < component_count; ++i)
+	{
+		switch (i % 4)
+		{
+			case 0: sim.add_link(1.0f); break;
+			case 1: sim.add_hinge(); sim.set_hinge_target_angle(i, 1.0f); break;
+			case 2: sim.add_piston(3.0f); sim.set_piston_target_length(i, 2.0f); break;
+			case 3: sim.add_swivel(); sim.set_swivel_rotation_speed(i, 0.5f); break;
+		}
+	}
+	return sim;
+}
+} // namespace
+
+// Capture, tick, roll back, the steady state of a rollback loop
+void BM_SnapshotRollback(benchmark::State& state)
+{
+	auto		sim = make_arm(static_cast<std::size_t>(state.range(0)));
+	ArmSnapshot snapshot;
+	for (auto _ : state)
+	{
+		snapshot.capture(sim);
+		sim.tick(0.001f);
+		snapshot.restore(sim);
+		benchmark::DoNotOptimize(sim.get_components().data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SnapshotRollback)->RangeMultiplier(8)->Range(64, 4096);
+
+// Plain tick of the same arm for scale
+void BM_TickOnly(benchmark::State& state)
+{
+	auto sim = make_arm(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state)
+	{
+		sim.tick(0.001f);
+		benchmark::DoNotOptimize(sim.get_components().data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TickOnly)->RangeMultiplier(8)->Range(64, 4096);
+
+// Mapping, checking and restoring a 10,000 component arm from a file
+void BM_LoadSnapshot(benchmark::State& state)
+{
+	auto		path = std::filesystem::temp_directory_path() / "arm_snapshot_benchmark.rsnap";
+	ArmSnapshot snapshot;
+	snapshot.capture(make_arm(10'000));
+	snapshot.save(path);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(ArmSnapshot::load(path).to_simulation().get_components().data());
+	std::filesystem::remove(path);
+}
+BENCHMARK(BM_LoadSnapshot)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,88 @@
+//
+// Created by chris on 10/18/26.
+//
+// What a slider drag costs to hand over: the lock free queue against the mutex guarded std::function list it replaced
+
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <mutex>
+#include <RobotArm/Simulation/SimulationThread.hpp>
+#include <vector>
+
+namespace
+{
+Simulation make_arm(std::vector<ComponentHandle>* hinges = nullptr)
+{
+	Simulation sim;
+	for (int i = 0; i < 4; ++i)
+	{
+		sim.add_link(1.0f);
+		auto hinge = sim.add_hinge();
+		if (hinges)
+			hinges->push_back(hinge);
+		sim.add_piston(3.0f);
+	}
+	return sim;
+}
+} // namespace
+
+// One post and one drain per iteration, the uncontended fast path
+void BM_QueuePushPop(benchmark::State& state)
+{
+	CommandQueue<SimulationCommand> queue(1024);
+	SimulationCommand				command{SimulationCommand::Type::SetHingeTargetAngle, {1, 0}, 0.5f};
+	for (auto _ : state)
+	{
+		queue.try_push(command);
+		benchmark::DoNotOptimize(queue.try_pop());
+	}
+}
+BENCHMARK(BM_QueuePushPop);
+
+// A frame worth of slider updates spread over range(0) joints, posted and applied as one batch
+void BM_PostAndApplyBatch(benchmark::State& state)
+{
+	auto						 joints = static_cast<std::uint32_t>(state.range(0));
+	std::vector<ComponentHandle> hinges;
+	SimulationThread			 thread(make_arm(&hinges), 0.001); // One step every 1000s, only the commands run
+	RenderData				 out;
+	auto						 now = SimulationThread::Clock::now();
+	for (auto _ : state)
+	{
+		for (std::uint32_t i = 0; i < 64; ++i)
+			thread.post({SimulationCommand::Type::SetHingeTargetAngle, hinges[i % joints], 0.01f * static_cast<float>(i)});
+		now += std::chrono::microseconds(100);
+		thread.get_render_data(out, now);
+	}
+	state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_PostAndApplyBatch)->Arg(1)->Arg(4);
+
+// The same batch through the previous mutex guarded list of closures, applied one by one
+void BM_MutexFunctionBatch(benchmark::State& state)
+{
+	auto											   joints = static_cast<std::uint32_t>(state.range(0));
+	Simulation										   sim	  = make_arm();
+	std::mutex										   mutex;
+	std::vector<std::function<void(Simulation&)>>	   commands;
+	std::vector<std::function<void(Simulation&)>>	   running;
+	for (auto _ : state)
+	{
+		for (std::uint32_t i = 0; i < 64; ++i)
+		{
+			std::size_t index = (i % joints) * 3 + 1;
+			float		angle = 0.01f * static_cast<float>(i);
+			std::lock_guard lock(mutex);
+			commands.push_back([=](Simulation& s) { s.set_hinge_target_angle(index, angle); });
+		}
+		{
+			std::lock_guard lock(mutex);
+			std::swap(commands, running);
+		}
+		for (auto& command : running)
+			command(sim);
+		running.clear();
+	}
+	state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_MutexFunctionBatch)->Arg(1)->Arg(4);
@@ -0,0 +1,73 @@
+//
+// Created by chris on 10/18/26.
+//
+// What handles cost over plain indices, and what editing a long arm live costs
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <vector>
+
+namespace
+{
+Simulation make_arm(std::size_t component_count, std::vector<ComponentHandle>& hinges)
+{
+	Simulation sim;
+	for (std::size_t i = 0; i < component_count; ++i)
+	{
+		if (i % 2 == 0)
+			sim.add_link(1.0f);
+		else
+			hinges.push_back(sim.add_hinge());
+	}
+	return sim;
+}
+} // namespace
+
+void BM_SetTargetByIndex(benchmark::State& state)
+{
+	std::vector<ComponentHandle> hinges;
+	auto						 sim = make_arm(static_cast<std::size_t>(state.range(0)), hinges);
+	float						 angle = 0.0f;
+	for (auto _ : state)
+	{
+		for (std::size_t i = 1; i < sim.get_components().size(); i += 2)
+			sim.set_hinge_target_angle(i, angle);
+		angle += 0.001f;
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(hinges.size()));
+}
+BENCHMARK(BM_SetTargetByIndex)->Arg(256);
+
+void BM_SetTargetByHandle(benchmark::State& state)
+{
+	std::vector<ComponentHandle> hinges;
+	auto						 sim = make_arm(static_cast<std::size_t>(state.range(0)), hinges);
+	float						 angle = 0.0f;
+	for (auto _ : state)
+	{
+		for (auto hinge : hinges)
+			sim.set_hinge_target_angle(hinge, angle);
+		angle += 0.001f;
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(hinges.size()));
+}
+BENCHMARK(BM_SetTargetByHandle)->Arg(256);
+
+// Removes a hinge from the middle and appends a new one, every other handle stays valid throughout
+void BM_RemoveAndAdd(benchmark::State& state)
+{
+	std::vector<ComponentHandle> hinges;
+	auto						 sim  = make_arm(static_cast<std::size_t>(state.range(0)), hinges);
+	std::size_t					 next = 0;
+	for (auto _ : state)
+	{
+		auto& hinge = hinges[next];
+		sim.remove_component(hinge);
+		hinge = sim.add_hinge();
+		next  = (next + 7) % hinges.size();
+		benchmark::DoNotOptimize(sim.get_chain().back());
+	}
+}
+BENCHMARK(BM_RemoveAndAdd)->RangeMultiplier(4)->Range(64, 1024);
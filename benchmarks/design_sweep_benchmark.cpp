@@ -0,0 +1,66 @@
+//
+// Created by chris on 10/18/26.
+//
+// Throughput of a design sweep, and what building candidates into pooled simulations saves over fresh ones
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <RobotArm/Simulation/DesignSweep.hpp>
+#include <vector>
+
+namespace
+{
+// Eight slots of four and two options alternating, 4096 candidates
+DesignSpace make_space()
+{
+	DesignSpace space;
+	for (int i = 0; i < 4; ++i)
+	{
+		space.slots.push_back(i % 2 == 0 ? link_options(0.5f, 2.0f, 4) : piston_options(1.5f, 3.0f, 4));
+		space.slots.push_back({{ComponentType::Hinge}, {ComponentType::Swivel}});
+	}
+	return space;
+}
+} // namespace
+
+// range(0) threads, reach only so the harness itself dominates
+void BM_DesignSweep(benchmark::State& state)
+{
+	auto					  space = make_space();
+	std::vector<DesignMetric> metrics{reach_metric()};
+	auto					  path = std::filesystem::temp_directory_path() / "design_sweep_benchmark.rsweep";
+	DesignSweepSettings		  settings{.thread_count = static_cast<std::size_t>(state.range(0))};
+	for (auto _ : state)
+		benchmark::DoNotOptimize(run_design_sweep(space, metrics, path, settings).candidates);
+	std::filesystem::remove(path);
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(space.candidate_count()));
+}
+BENCHMARK(BM_DesignSweep)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+// Building every candidate, range(0) = 1 reuses one simulation like the sweep does
+void BM_BuildCandidates(benchmark::State& state)
+{
+	auto					   space = make_space();
+	std::vector<std::uint32_t> choices(space.slots.size());
+	Simulation				   pooled;
+	for (auto _ : state)
+	{
+		for (std::uint64_t candidate = 0; candidate < space.candidate_count(); ++candidate)
+		{
+			space.decode(candidate, choices);
+			if (state.range(0) != 0)
+			{
+				space.build(choices, pooled);
+				benchmark::DoNotOptimize(pooled.get_chain().data());
+			}
+			else
+			{
+				Simulation fresh;
+				space.build(choices, fresh);
+				benchmark::DoNotOptimize(fresh.get_chain().data());
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(space.candidate_count()));
+}
+BENCHMARK(BM_BuildCandidates)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
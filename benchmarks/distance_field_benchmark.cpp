@@ -0,0 +1,72 @@
+//
+// Created by chris on 10/18/26.
+//
+// Clearance of a long arm to a cluttered scene, and what baking the scene costs up front
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <vector>
+
+namespace
+{
+// A ring of boxes and cylinders around the base, and a sphere-ish mesh above it
+std::vector<Obstacle> make_scene()
+{
+	std::vector<Obstacle> obstacles;
+	for (int i = 0; i < 8; ++i)
+	{
+		RigidTransform pose = RigidTransform{}.rotated_y(0.785f * static_cast<float>(i)).translated_y(1.0f);
+		pose.translation += pose.rotation[0] * 4.0f;
+		if (i % 2 == 0)
+			obstacles.emplace_back(BoxObstacle{pose, {0.5f, 1.0f, 0.5f}});
+		else
+			obstacles.emplace_back(CylinderObstacle{pose, 0.4f, 1.0f});
+	}
+	MeshObstacle octahedron;
+	octahedron.pose.translation = {0.0f, 6.0f, 0.0f};
+	octahedron.vertices = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+	octahedron.indices	= {0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4, 2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5};
+	obstacles.emplace_back(std::move(octahedron));
+	return obstacles;
+}
+
+// Link + Hinge pairs bent into an arc that stays inside the scene
+Simulation make_arm(std::size_t segments)
+{
+	Simulation sim;
+	for (std::size_t i = 0; i < segments / 2; ++i)
+	{
+		sim.add_link(0.2f);
+		sim.add_hinge();
+	}
+	std::vector<float> positions(sim.get_joint_count(), 0.03f);
+	sim.set_joint_positions(positions);
+	return sim;
+}
+} // namespace
+
+// get_render_data of a 100 segment arm, range(0) = 0 without environment as the baseline
+void BM_RenderDataClearance(benchmark::State& state)
+{
+	auto sim = make_arm(100);
+	if (state.range(0) != 0)
+		sim.set_environment(std::make_shared<const DistanceField>(DistanceField::bake(make_scene())));
+	RenderData out;
+	for (auto _ : state)
+	{
+		sim.get_render_data(out);
+		benchmark::DoNotOptimize(out.clearances.data());
+	}
+	state.SetItemsProcessed(state.iterations() * 100);
+}
+BENCHMARK(BM_RenderDataClearance)->Arg(0)->Arg(1);
+
+void BM_BakeScene(benchmark::State& state)
+{
+	auto						obstacles = make_scene();
+	DistanceFieldSettings settings{.voxel_size = 0.1f, .thread_count = static_cast<std::size_t>(state.range(0))};
+	for (auto _ : state)
+		benchmark::DoNotOptimize(DistanceField::bake(obstacles, settings).values().data());
+}
+BENCHMARK(BM_BakeScene)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
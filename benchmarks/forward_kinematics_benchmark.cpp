@@ -0,0 +1,169 @@
+//
+// Created by chris on 10/18/26.
+//
+// Cost of evaluating the joint chain of a long arm depending on how much of it moves
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <vector>
+
+namespace
+{
+// Idle Link, Hinge, Piston, Swivel pattern with a single spinning swivel at the very end
+Simulation make_arm(std::size_t component_count)
+{
+	Simulation sim;
+	for (std::size_t i = 0; i < component_count; ++i)
+	{
+		switch (i % 4)
+		{
+			case 0: sim.add_link(1.0f); break;
+			case 1: sim.add_hinge(); break;
+			case 2: sim.add_piston(3.0f); break;
+			case 3: sim.add_swivel(); break;
+		}
+	}
+	sim.add_swivel();
+	sim.set_swivel_rotation_speed(component_count, 1.0f);
+	return sim;
+}
+
+std::vector<Component> make_components(std::size_t component_count)
+{
+	std::vector<Component> components;
+	for (std::size_t i = 0; i < component_count; ++i)
+	{
+		float f = static_cast<float>(i);
+		switch (i % 4)
+		{
+			case 0: components.emplace_back(Link{1.0f}); break;
+			case 1: components.emplace_back(Hinge{0.01f * f, 0.0f}); break;
+			case 2: components.emplace_back(Piston{2.0f, 2.0f, 3.0f}); break;
+			case 3: components.emplace_back(Swivel{0.0f, 0.02f * f}); break;
+		}
+	}
+	return components;
+}
+} // namespace
+
+// Full glm::translate / rotate / scale on 4x4 matrices, the way the chain used to be built
+void BM_Mat4Chain(benchmark::State& state)
+{
+	auto components = make_components(static_cast<std::size_t>(state.range(0)));
+	std::vector<glm::mat4> models(components.size());
+	for (auto _ : state)
+	{
+		glm::mat4 joint{1.0f};
+		for (std::size_t i = 0; i < components.size(); ++i)
+		{
+			auto output = components[i].get_model_matrix(joint);
+			models[i]	= output.model_matrix;
+			joint		= output.joint_matrix;
+		}
+		benchmark::DoNotOptimize(models.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Rigid transforms with per axis rotation kernels, scale only when emitting the model matrix
+void BM_RigidChain(benchmark::State& state)
+{
+	auto components = make_components(static_cast<std::size_t>(state.range(0)));
+	std::vector<glm::mat4> models(components.size());
+	for (auto _ : state)
+	{
+		RigidTransform joint;
+		for (std::size_t i = 0; i < components.size(); ++i)
+		{
+			auto next_joint = components[i].get_joint_transform(joint);
+			models[i]		= components[i].emit_model_matrix(joint, next_joint);
+			joint			= next_joint;
+		}
+		benchmark::DoNotOptimize(models.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ChainDistalMotion(benchmark::State& state)
+{
+	auto sim = make_arm(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state)
+	{
+		sim.tick(0.001f);
+		benchmark::DoNotOptimize(sim.get_chain().data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ChainProximalMotion(benchmark::State& state)
+{
+	auto sim = make_arm(static_cast<std::size_t>(state.range(0)));
+	float angle = 1.0f;
+	for (auto _ : state)
+	{
+		// Flipping the base hinge target every frame keeps the whole chain dirty
+		sim.set_hinge_target_angle(1, angle);
+		angle = -angle;
+		sim.tick(0.001f);
+		benchmark::DoNotOptimize(sim.get_chain().data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Jacobian plus the derived measures a controller would evaluate every cycle
+void BM_JacobianAndManipulability(benchmark::State& state)
+{
+	auto						sim = make_arm(static_cast<std::size_t>(state.range(0)));
+	std::vector<JacobianColumn> jacobian(sim.get_joint_count());
+	for (auto _ : state)
+	{
+		sim.tick(0.001f);
+		sim.get_jacobian(jacobian);
+		benchmark::DoNotOptimize(translational_manipulability(jacobian));
+		benchmark::DoNotOptimize(velocity_ellipsoid(jacobian));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Whole chain moving and emitted as render data, range(1) = 1 also propagates the motion of every segment
+void BM_RenderDataSegmentMotion(benchmark::State& state)
+{
+	auto			  sim	  = make_arm(static_cast<std::size_t>(state.range(0)));
+	RenderDataOptions options{.compute_tip_velocity = true, .compute_clearance = false,
+							  .compute_segment_motion = state.range(1) != 0};
+	RenderData		  out;
+	float			  angle = 1.0f;
+	for (auto _ : state)
+	{
+		sim.set_hinge_target_angle(1, angle);
+		angle = -angle;
+		sim.tick(0.001f);
+		sim.get_render_data(out, options);
+		benchmark::DoNotOptimize(out.components.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Snake with the whole chain dirty every frame, range(1) threads scan it in blocks and 1 keeps the serial pass
+void BM_ChainParallelScan(benchmark::State& state)
+{
+	auto sim = make_arm(static_cast<std::size_t>(state.range(0)));
+	sim.set_chain_threads(static_cast<std::size_t>(state.range(1)));
+	float angle = 1.0f;
+	for (auto _ : state)
+	{
+		sim.set_hinge_target_angle(1, angle);
+		angle = -angle;
+		sim.tick(0.001f);
+		benchmark::DoNotOptimize(sim.get_chain().data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Mat4Chain)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_RigidChain)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_ChainDistalMotion)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_ChainProximalMotion)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_JacobianAndManipulability)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_RenderDataSegmentMotion)->ArgsProduct({{64, 1024}, {0, 1}});
+BENCHMARK(BM_ChainParallelScan)->ArgsProduct({{16384, 131072}, {1, 2, 4, 8}})->UseRealTime();
@@ -0,0 +1,66 @@
+//
+// Created by chris on 10/18/26.
+//
+// Joint efforts of a 50 joint arm, the budget is one control cycle at 1 kHz
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <vector>
+
+namespace
+{
+// Hinges, Swivels and Pistons in turn, each followed by a Link, every component with some mass
+Simulation make_arm(std::size_t joints)
+{
+	Simulation sim;
+	for (std::size_t i = 0; i < joints; ++i)
+	{
+		switch (i % 3)
+		{
+			case 0: sim.add_hinge(); break;
+			case 1: sim.add_swivel(); break;
+			default: sim.add_piston(1.5f); break;
+		}
+		sim.add_link(0.5f);
+	}
+	for (std::size_t i = 0; i < sim.get_components().size(); ++i)
+		sim.set_mass_properties(i, MassProperties::rod(0.5f, 0.5f));
+	std::vector<float> positions(sim.get_joint_count());
+	for (std::size_t j = 0; j < positions.size(); ++j)
+		positions[j] = j % 3 == 2 ? 1.2f : 0.1f * static_cast<float>(j % 7);
+	sim.set_joint_positions(positions);
+	return sim;
+}
+} // namespace
+
+// Arbitrary rates and accelerations, the pose changes every iteration so forward kinematics is part of it
+void BM_InverseDynamics(benchmark::State& state)
+{
+	auto			   sim	  = make_arm(static_cast<std::size_t>(state.range(0)));
+	auto			   joints = sim.get_joint_count();
+	std::vector<float> positions(joints), velocities(joints, 0.3f), accelerations(joints, -0.2f), efforts(joints);
+	sim.get_joint_positions(positions);
+	for (auto _ : state)
+	{
+		positions[0] += 1e-4f;
+		sim.set_joint_positions(positions);
+		sim.inverse_dynamics(velocities, accelerations, efforts);
+		benchmark::DoNotOptimize(efforts.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(joints));
+}
+BENCHMARK(BM_InverseDynamics)->Arg(50)->Arg(500);
+
+// The holding efforts at rest, with the chain already cached
+void BM_HoldingEfforts(benchmark::State& state)
+{
+	auto			   sim = make_arm(static_cast<std::size_t>(state.range(0)));
+	std::vector<float> efforts(sim.get_joint_count());
+	for (auto _ : state)
+	{
+		sim.get_joint_efforts(efforts);
+		benchmark::DoNotOptimize(efforts.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(efforts.size()));
+}
+BENCHMARK(BM_HoldingEfforts)->Arg(50);
@@ -0,0 +1,66 @@
+//
+// Created by chris on 10/18/26.
+//
+// Time per damped least squares solve for typical 6-10 joint arms
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/InverseKinematics.hpp>
+#include <vector>
+
+namespace
+{
+// Base link, then joints cycling Hinge, Piston, Swivel with a short link after every one of them
+Simulation make_arm(std::size_t joint_count)
+{
+	Simulation sim;
+	sim.add_link(1.0f);
+	for (std::size_t joint = 0; joint < joint_count; ++joint)
+	{
+		switch (joint % 3)
+		{
+			case 0: sim.add_hinge(); break;
+			case 1: sim.add_piston(2.0f); break;
+			case 2: sim.add_swivel(); break;
+		}
+		sim.add_link(0.5f);
+	}
+	return sim;
+}
+
+// Tip of the same arm in a different pose, so the target is always reachable
+glm::vec3 make_target(const Simulation& sim)
+{
+	Simulation posed	 = sim;
+	auto	   components = posed.get_components();
+	for (std::size_t i = 0; i < components.size(); ++i)
+	{
+		float f = 0.3f + 0.1f * static_cast<float>(i);
+		if (std::holds_alternative<Hinge>(components[i]))
+			posed.set_hinge_target_angle(i, f);
+		else if (std::holds_alternative<Piston>(components[i]))
+			posed.set_piston_target_length(i, 1.5f);
+		else if (std::holds_alternative<Swivel>(components[i]))
+			posed.set_swivel_angle(i, f);
+	}
+	posed.tick(10.0f);
+	return posed.get_render_data().tip_pos;
+}
+} // namespace
+
+void BM_IkSolve(benchmark::State& state)
+{
+	auto			   sim	  = make_arm(static_cast<std::size_t>(state.range(0)));
+	auto			   target = make_target(sim);
+	std::vector<float> solution(sim.get_joint_count());
+	IkSolver		   solver;
+	int				   iterations = 0;
+	for (auto _ : state)
+	{
+		auto result = solver.solve(sim, target, solution);
+		iterations	= result.iterations;
+		benchmark::DoNotOptimize(solution.data());
+	}
+	state.counters["solver_iterations"] = iterations;
+}
+
+BENCHMARK(BM_IkSolve)->DenseRange(6, 10, 2)->Unit(benchmark::kMicrosecond);
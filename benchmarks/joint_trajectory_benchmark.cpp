@@ -0,0 +1,73 @@
+//
+// Created by chris on 10/18/26.
+//
+// Spline evaluation cost per joint, for a single trajectory and for many played at once
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/JointTrajectory.hpp>
+#include <vector>
+
+namespace
+{
+// Hinges only, so any waypoint is in range
+Simulation make_arm(std::size_t joints)
+{
+	Simulation sim;
+	for (std::size_t i = 0; i < joints; ++i)
+	{
+		sim.add_link(0.5f);
+		sim.add_hinge();
+	}
+	return sim;
+}
+
+JointTrajectory make_trajectory(const Simulation& sim, SplineOrder order)
+{
+	std::size_t		   joints = sim.get_joint_count();
+	std::vector<float> waypoints;
+	for (int waypoint = 0; waypoint < 8; ++waypoint)
+		for (std::size_t j = 0; j < joints; ++j)
+			waypoints.push_back(static_cast<float>((waypoint * 7 + j * 3) % 11) * 0.2f - 1.0f);
+	return plan_trajectory(sim, waypoints, {.order = order});
+}
+} // namespace
+
+// Just the Horner loops over the coefficient table
+void BM_EvaluateSpline(benchmark::State& state)
+{
+	auto  sim		 = make_arm(static_cast<std::size_t>(state.range(0)));
+	auto  order		 = state.range(1) == 3 ? SplineOrder::Cubic : SplineOrder::Quintic;
+	auto  trajectory = make_trajectory(sim, order);
+	float time		 = 0.0f;
+	std::size_t		   segment = 0;
+	std::vector<float> positions(trajectory.stride());
+	for (auto _ : state)
+	{
+		time	= time + 0.001f > trajectory.duration() ? 0.0f : time + 0.001f;
+		segment = trajectory.find_segment(time, segment);
+		trajectory.evaluate(segment, time, positions);
+		benchmark::DoNotOptimize(positions.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetLabel(order == SplineOrder::Cubic ? "cubic" : "quintic");
+}
+BENCHMARK(BM_EvaluateSpline)->ArgsProduct({{6, 16, 64}, {3, 5}});
+
+// Many arms, each on its own trajectory, including writing the joints into the simulations
+void BM_ExecutorTick(benchmark::State& state)
+{
+	auto					joints = static_cast<std::size_t>(state.range(0));
+	auto					arms   = static_cast<std::size_t>(state.range(1));
+	std::vector<Simulation> sims(arms, make_arm(joints));
+	auto					trajectory = make_trajectory(sims.front(), SplineOrder::Quintic);
+	TrajectoryExecutor		executor;
+	for (auto _ : state)
+	{
+		if (executor.active_count() == 0) // Restarts are rare, the trajectory lasts thousands of ticks
+			for (auto& sim : sims)
+				executor.run(sim, trajectory);
+		executor.tick(0.001f);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(joints * arms));
+}
+BENCHMARK(BM_ExecutorTick)->ArgsProduct({{6, 16}, {1, 256}});
@@ -0,0 +1,116 @@
+//
+// Created by chris on 10/18/26.
+//
+// Forward kinematics of many arms with the same topology, one Simulation per arm against arms side by side in SIMD
+// lanes. Every iteration poses every arm anew, so nothing is served from the chain cache
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <RobotArm/Simulation/KinematicsBatch.hpp>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t ARM_COUNT	 = 1024;
+constexpr std::size_t POSE_COUNT = 64;
+
+// Link, Hinge, Piston, Swivel pattern
+Simulation make_arm(std::size_t component_count)
+{
+	Simulation sim;
+	for (std::size_t i = 0; i < component_count; ++i)
+	{
+		switch (i % 4)
+		{
+			case 0: sim.add_link(1.0f); break;
+			case 1: sim.add_hinge(); break;
+			case 2: sim.add_piston(3.0f); break;
+			case 3: sim.add_swivel(); break;
+		}
+	}
+	return sim;
+}
+
+std::vector<std::vector<float>> make_poses(const Simulation& sim)
+{
+	std::mt19937						  rng(3);
+	std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+	std::uniform_real_distribution<float> length(Piston::MIN_LENGTH, 3.0f);
+	std::vector<std::vector<float>>		  poses(POSE_COUNT);
+	for (auto& pose : poses)
+	{
+		for (const auto& component : sim.get_components())
+		{
+			if (std::holds_alternative<Piston>(component))
+				pose.push_back(length(rng));
+			else if (!std::holds_alternative<Link>(component))
+				pose.push_back(angle(rng));
+		}
+	}
+	return poses;
+}
+} // namespace
+
+// What a batch of Simulations does today, tip and model matrices through get_render_data
+void BM_RenderDataPerArm(benchmark::State& state)
+{
+	auto					arm	  = make_arm(static_cast<std::size_t>(state.range(0)));
+	auto					poses = make_poses(arm);
+	std::vector<Simulation> arms(ARM_COUNT, arm);
+	RenderData				out;
+	std::size_t				frame = 0;
+	for (auto _ : state)
+	{
+		for (std::size_t a = 0; a < arms.size(); ++a)
+		{
+			arms[a].set_joint_positions(poses[(a + frame) % POSE_COUNT]);
+			arms[a].get_render_data(out, {.compute_tip_velocity = false, .compute_clearance = false});
+			benchmark::DoNotOptimize(out.tip_pos);
+		}
+		++frame;
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ARM_COUNT));
+}
+
+// Only the joint chain of every Simulation, the part the batch replaces
+void BM_ChainPerArm(benchmark::State& state)
+{
+	auto					arm	  = make_arm(static_cast<std::size_t>(state.range(0)));
+	auto					poses = make_poses(arm);
+	std::vector<Simulation> arms(ARM_COUNT, arm);
+	std::size_t				frame = 0;
+	for (auto _ : state)
+	{
+		for (std::size_t a = 0; a < arms.size(); ++a)
+		{
+			arms[a].set_joint_positions(poses[(a + frame) % POSE_COUNT]);
+			benchmark::DoNotOptimize(arms[a].get_chain().back());
+		}
+		++frame;
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ARM_COUNT));
+}
+
+// Second argument is the lane count, 16 and 8 fall back to the SSE kernel without AVX-512 or AVX2
+void BM_KinematicsBatch(benchmark::State& state)
+{
+	auto			arm	  = make_arm(static_cast<std::size_t>(state.range(0)));
+	auto			poses = make_poses(arm);
+	KinematicsBatch batch(arm, static_cast<std::size_t>(state.range(1)));
+	for (std::size_t a = 0; a < ARM_COUNT; ++a)
+		batch.add_arm(arm);
+	std::size_t frame = 0;
+	for (auto _ : state)
+	{
+		for (std::size_t a = 0; a < ARM_COUNT; ++a)
+			batch.set_joint_positions(a, poses[(a + frame) % POSE_COUNT]);
+		batch.compute();
+		benchmark::DoNotOptimize(batch.get_tip_position(ARM_COUNT - 1));
+		++frame;
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ARM_COUNT));
+}
+
+BENCHMARK(BM_RenderDataPerArm)->Arg(8)->Arg(32);
+BENCHMARK(BM_ChainPerArm)->Arg(8)->Arg(32);
+BENCHMARK(BM_KinematicsBatch)->ArgsProduct({{8, 32}, {4, 8, 16}});
@@ -0,0 +1,41 @@
+//
+// Created by chris on 10/18/26.
+//
+// Reachability sampling throughput in samples per second, by thread count
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/ReachabilityMap.hpp>
+
+namespace
+{
+// Six joints of every kind, about the size of the arms we size work cells for
+Simulation make_arm()
+{
+	Simulation sim;
+	sim.add_link(1.0f);
+	sim.add_swivel();
+	sim.add_hinge();
+	sim.add_piston(2.0f);
+	sim.add_hinge();
+	sim.add_link(1.0f);
+	sim.add_hinge();
+	sim.add_swivel();
+	sim.add_link(0.5f);
+	return sim;
+}
+} // namespace
+
+void BM_GenerateReachabilityMap(benchmark::State& state)
+{
+	auto				 sim = make_arm();
+	ReachabilitySettings settings{.samples = 200'000, .thread_count = static_cast<std::size_t>(state.range(0))};
+	std::uint64_t		 samples = 0;
+	for (auto _ : state)
+	{
+		auto map = ReachabilityMap::generate(sim, settings);
+		samples += map.sample_count();
+		benchmark::DoNotOptimize(map.voxels().data());
+	}
+	state.counters["samples_per_second"] = benchmark::Counter(static_cast<double>(samples), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_GenerateReachabilityMap)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
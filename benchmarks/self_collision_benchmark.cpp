@@ -0,0 +1,43 @@
+//
+// Created by chris on 10/18/26.
+//
+// Self collision check on long arms, stretched out and coiled up so that many segments overlap
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/SelfCollision.hpp>
+#include <vector>
+
+namespace
+{
+// Link + Hinge pairs, every hinge bent by angle. A small angle coils the arm into overlapping rings
+Simulation make_arm(std::size_t segments, float angle)
+{
+	Simulation sim;
+	for (std::size_t i = 0; i < segments / 2; ++i)
+	{
+		sim.add_link(0.5f);
+		sim.add_hinge();
+	}
+	std::vector<float> positions(sim.get_joint_count(), angle);
+	sim.set_joint_positions(positions);
+	return sim;
+}
+} // namespace
+
+void BM_SelfCollision(benchmark::State& state)
+{
+	auto  segments = static_cast<std::size_t>(state.range(0));
+	float angle	   = static_cast<float>(state.range(1)) * 0.01f;
+	auto  sim	   = make_arm(segments, angle);
+	std::vector<float>	  positions(sim.get_joint_count(), angle);
+	SelfCollisionDetector detector;
+	for (auto _ : state)
+	{
+		// Invalidates the chain so forward kinematics is part of the measurement, like a detect after every tick
+		sim.set_joint_positions(positions);
+		benchmark::DoNotOptimize(detector.detect(sim).data());
+	}
+	state.counters["candidates"] = static_cast<double>(detector.candidate_count());
+	state.counters["contacts"]	 = static_cast<double>(detector.get_contacts().size());
+}
+BENCHMARK(BM_SelfCollision)->ArgsProduct({{50, 500}, {0, 5, 30}})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,69 @@
+//
+// Created by chris on 10/18/26.
+//
+// Scaling of SimulationBatch with the number of threads, reported in arm ticks per second
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/SimulationBatch.hpp>
+
+namespace
+{
+constexpr std::size_t ARM_COUNT			  = 4096;
+constexpr std::size_t ARM_COMPONENTS		  = 20;
+constexpr std::size_t STEPS_PER_ITERATION = 10;
+
+void populate(SimulationBatch& batch)
+{
+	for (std::size_t arm = 0; arm < ARM_COUNT; ++arm)
+	{
+		auto& sim = batch.add_simulation();
+		for (std::size_t i = 0; i < ARM_COMPONENTS; ++i)
+		{
+			switch (i % 4)
+			{
+				case 0: sim.add_link(1.0f); break;
+				case 1:
+					sim.add_hinge();
+					sim.set_hinge_target_angle(i, 0.001f * static_cast<float>(arm));
+					break;
+				case 2:
+					sim.add_piston(3.0f);
+					sim.set_piston_target_length(i, 2.5f);
+					break;
+				case 3:
+					sim.add_swivel();
+					sim.set_swivel_rotation_speed(i, 0.5f);
+					break;
+			}
+		}
+	}
+}
+} // namespace
+
+void BM_BatchTick(benchmark::State& state)
+{
+	SimulationBatch batch(static_cast<std::size_t>(state.range(0)));
+	populate(batch);
+	for (auto _ : state)
+	{
+		batch.tick(0.001f, STEPS_PER_ITERATION);
+	}
+	state.counters["arm_ticks"] = benchmark::Counter(static_cast<double>(state.iterations() * ARM_COUNT * STEPS_PER_ITERATION),
+													 benchmark::Counter::kIsRate);
+}
+
+void BM_BatchRenderData(benchmark::State& state)
+{
+	SimulationBatch batch(static_cast<std::size_t>(state.range(0)));
+	populate(batch);
+	for (auto _ : state)
+	{
+		batch.compute_render_data();
+		benchmark::DoNotOptimize(batch.get_render_data().data());
+	}
+	state.counters["arms"] = benchmark::Counter(static_cast<double>(state.iterations() * ARM_COUNT),
+												benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_BatchTick)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK(BM_BatchRenderData)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
@@ -0,0 +1,93 @@
+//
+// Created by chris on 10/18/26.
+//
+// Compares the variant based Simulation with the structure-of-arrays SoASimulation
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <RobotArm/Simulation/SoASimulation.hpp>
+
+// Repeats Link, Hinge, Piston, Swivel and gives every joint something to do
+template <class Sim>
+Sim make_arm(std::size_t component_count)
+{
+	Sim sim;
+	for (std::size_t i = 0; i < component_count; ++i)
+	{
+		switch (i % 4)
+		{
+			case 0: sim.add_link(1.0f); break;
+			case 1:
+				sim.add_hinge();
+				sim.set_hinge_target_angle(i, 1.0f);
+				break;
+			case 2:
+				sim.add_piston(3.0f);
+				sim.set_piston_target_length(i, 2.5f);
+				break;
+			case 3:
+				sim.add_swivel();
+				sim.set_swivel_rotation_speed(i, 0.5f);
+				break;
+		}
+	}
+	return sim;
+}
+
+template <class Sim>
+void BM_Tick(benchmark::State& state)
+{
+	auto sim = make_arm<Sim>(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state)
+	{
+		sim.tick(0.001f);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Sim>
+void BM_RenderData(benchmark::State& state)
+{
+	auto sim = make_arm<Sim>(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(sim.get_render_data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Tick<Simulation>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_Tick<SoASimulation>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_RenderData<Simulation>)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_RenderData<SoASimulation>)->RangeMultiplier(4)->Range(16, 4096);
+
+// A long arm where only one swivel in 64 components spins, the usual state of an arm holding a pose
+template <class Sim>
+void BM_TickMostlyIdle(benchmark::State& state)
+{
+	Sim sim;
+	for (std::size_t i = 0; i < static_cast<std::size_t>(state.range(0)); ++i)
+	{
+		switch (i % 4)
+		{
+			case 0: sim.add_link(1.0f); break;
+			case 1: sim.add_hinge(); break;
+			case 2: sim.add_piston(3.0f); break;
+			case 3:
+				sim.add_swivel();
+				if (i % 64 == 3)
+					sim.set_swivel_rotation_speed(i, 0.5f);
+				break;
+		}
+	}
+	for (auto _ : state)
+	{
+		sim.tick(0.001f);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TickMostlyIdle<Simulation>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_TickMostlyIdle<SoASimulation>)->RangeMultiplier(4)->Range(64, 4096);
@@ -0,0 +1,97 @@
+//
+// Created by chris on 10/18/26.
+//
+// Compile time arm topology against the variant based Simulation, one tick plus one render data pass per iteration
+
+#include <benchmark/benchmark.h>
+#include <RobotArm/Simulation/StaticSimulation.hpp>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+// Link, Hinge, Piston, Swivel repeated, the same pattern both arms are built from
+template <std::size_t I>
+using PatternComponent = std::tuple_element_t<I % 4, std::tuple<Link, Hinge, Piston, Swivel>>;
+
+template <class T>
+T make_component()
+{
+	if constexpr (std::same_as<T, Link>)
+		return Link{1.0f};
+	else if constexpr (std::same_as<T, Piston>)
+		return Piston{Piston::MIN_LENGTH, 3.0f, 3.0f};
+	else if constexpr (std::same_as<T, Hinge>)
+		return Hinge{0.0f, 1.0f};
+	else
+		return Swivel{1.0f, 0.0f};
+}
+
+template <std::size_t... I>
+auto make_static_arm(std::index_sequence<I...>)
+{
+	return StaticSimulation<PatternComponent<I>...>{make_component<PatternComponent<I>>()...};
+}
+
+template <std::size_t N>
+auto make_static_arm()
+{
+	return make_static_arm(std::make_index_sequence<N>{});
+}
+
+Simulation make_dynamic_arm(std::size_t component_count)
+{
+	Simulation sim;
+	for (std::size_t i = 0; i < component_count; ++i)
+	{
+		switch (i % 4)
+		{
+			case 0: sim.add_link(1.0f); break;
+			case 1:
+				sim.add_hinge();
+				sim.set_hinge_target_angle(i, 1.0f);
+				break;
+			case 2:
+				sim.add_piston(3.0f);
+				sim.set_piston_target_length(i, 3.0f);
+				break;
+			case 3:
+				sim.add_swivel();
+				sim.set_swivel_rotation_speed(i, 1.0f);
+				break;
+		}
+	}
+	return sim;
+}
+
+// Every swivel spins, so the whole chain is dirty every tick and the cache doesn't hide anything
+template <class Arm>
+void run(benchmark::State& state, Arm& arm)
+{
+	RenderData out;
+	for (auto _ : state)
+	{
+		arm.tick(0.001f);
+		arm.get_render_data(out);
+		benchmark::DoNotOptimize(out.tip_pos);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(out.components.size()));
+}
+} // namespace
+
+void BM_DynamicArm(benchmark::State& state)
+{
+	auto arm = make_dynamic_arm(static_cast<std::size_t>(state.range(0)));
+	run(state, arm);
+}
+BENCHMARK(BM_DynamicArm)->Arg(5)->Arg(20)->Arg(100);
+
+template <std::size_t N>
+void BM_StaticArm(benchmark::State& state)
+{
+	auto arm = make_static_arm<N>();
+	run(state, arm);
+}
+BENCHMARK_TEMPLATE(BM_StaticArm, 5);
+BENCHMARK_TEMPLATE(BM_StaticArm, 20);
+BENCHMARK_TEMPLATE(BM_StaticArm, 100);
@@ -0,0 +1,87 @@
+//
+// Created by chris on 10/18/26.
+//
+// What recording costs on top of a plain tick, and how many bytes a frame ends up taking
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <RobotArm/Simulation/Trajectory.hpp>
+
+namespace
+{
+// Everything moving at once, the worst case for the predictor
+Simulation make_moving_arm()
+{
+	Simulation sim;
+	for (int i = 0; i < 3; ++i)
+	{
+		sim.add_link(1.0f);
+		sim.add_hinge();
+		sim.add_piston(3.0f);
+		sim.add_swivel();
+	}
+	for (std::size_t i = 0; i < 3; ++i)
+	{
+		sim.set_hinge_target_angle(i * 4 + 1, 1000.0f);
+		sim.set_piston_target_length(i * 4 + 2, 3.0f);
+		sim.set_swivel_rotation_speed(i * 4 + 3, 1.0f);
+	}
+	return sim;
+}
+} // namespace
+
+void BM_TickOnly(benchmark::State& state)
+{
+	auto sim = make_moving_arm();
+	for (auto _ : state)
+	{
+		sim.tick(0.001f);
+		benchmark::DoNotOptimize(sim.get_chain().back());
+	}
+}
+BENCHMARK(BM_TickOnly);
+
+void BM_TickAndRecord(benchmark::State& state)
+{
+	auto path = std::filesystem::temp_directory_path() / "robot_arm_trajectory_benchmark.rtraj";
+	auto sim  = make_moving_arm();
+	{
+		TrajectoryRecorder recorder(path, sim);
+		for (auto _ : state)
+		{
+			sim.tick(0.001f);
+			recorder.record(sim);
+		}
+		recorder.finish();
+		state.counters["bytes_per_frame"] =
+			static_cast<double>(recorder.bytes_written()) / static_cast<double>(recorder.frame_count());
+		state.counters["mb_per_hour_1khz"] =
+			state.counters["bytes_per_frame"] * 3600.0 * 1000.0 / (1024.0 * 1024.0);
+	}
+	std::filesystem::remove(path);
+}
+BENCHMARK(BM_TickAndRecord);
+
+void BM_Seek(benchmark::State& state)
+{
+	auto path = std::filesystem::temp_directory_path() / "robot_arm_seek_benchmark.rtraj";
+	auto sim  = make_moving_arm();
+	{
+		TrajectoryRecorder recorder(path, sim);
+		for (int i = 0; i < 600'000; ++i) // 10 minutes at 1 kHz
+		{
+			sim.tick(0.001f);
+			recorder.record(sim);
+		}
+	}
+	TrajectoryPlayer player(path);
+	double			 time = 0.0;
+	for (auto _ : state)
+	{
+		time = std::fmod(time + 37.123, player.duration()); // Jumps around, never plays forward
+		player.seek(time);
+		benchmark::DoNotOptimize(player.tip_position());
+	}
+	std::filesystem::remove(path);
+}
+BENCHMARK(BM_Seek);
@@ -10,80 +10,73 @@
 #include <QDoubleSpinBox>
 #include <QRadioButton>
 #include <QButtonGroup>
+#include <RobotArm/Simulation/SlotMap.hpp>
 #include <vector>
 #include <functional>
 
 class PistonWidget : public QWidget {
 	Q_OBJECT
 public:
-	explicit PistonWidget(std::size_t index, float maxLength = 5.0f, QWidget* parent = nullptr);
+	explicit PistonWidget(ComponentHandle handle, float maxLength = 5.0f, float targetLength = 1.0f, QWidget* parent = nullptr);
 
-	void setIndex(std::size_t index);
-	std::size_t index() const { return m_index; }
+	ComponentHandle handle() const { return m_handle; }
 
 signals:
-	void targetLengthChanged(std::size_t index, float length);
-	void removeRequested(std::size_t index);
+	void targetLengthChanged(ComponentHandle handle, float length);
+	void removeRequested(ComponentHandle handle);
 
 private:
-	std::size_t m_index;
+	ComponentHandle m_handle;
 	QSlider* m_lengthSlider;
 	QLabel* m_lengthLabel;
-	QLabel* m_titleLabel;
 	float m_maxLength;
 };
 
 class HingeWidget : public QWidget {
 	Q_OBJECT
 public:
-	explicit HingeWidget(std::size_t index, float initialAngle = 0.0f, QWidget* parent = nullptr);
+	explicit HingeWidget(ComponentHandle handle, float initialAngle = 0.0f, QWidget* parent = nullptr);
 
-	void setIndex(std::size_t index);
-	std::size_t index() const { return m_index; }
+	ComponentHandle handle() const { return m_handle; }
 
 signals:
-	void targetAngleChanged(std::size_t index, float angle);
-	void removeRequested(std::size_t index);
+	void targetAngleChanged(ComponentHandle handle, float angle);
+	void removeRequested(ComponentHandle handle);
 
 private:
-	std::size_t m_index;
+	ComponentHandle m_handle;
 	QSlider* m_angleSlider;
 	QLabel* m_angleLabel;
-	QLabel* m_titleLabel;
 };
 
 class SwivelWidget : public QWidget {
 	Q_OBJECT
 public:
-	explicit SwivelWidget(std::size_t index, float initialSpeed = 0.0f, QWidget* parent = nullptr);
+	explicit SwivelWidget(ComponentHandle handle, float initialSpeed = 0.0f, QWidget* parent = nullptr);
 
-	void setIndex(std::size_t index);
-	std::size_t index() const { return m_index; }
+	ComponentHandle handle() const { return m_handle; }
 
 signals:
-	void rotationalSpeedChanged(std::size_t index, float speed);
-	void removeRequested(std::size_t index);
+	void rotationalSpeedChanged(ComponentHandle handle, float speed);
+	void removeRequested(ComponentHandle handle);
 
 private:
-	std::size_t m_index;
+	ComponentHandle m_handle;
 	QDoubleSpinBox* m_speedSpinBox;
-	QLabel* m_titleLabel;
 };
 
 class LinkWidget : public QWidget {
 	Q_OBJECT
 public:
-	explicit LinkWidget(std::size_t index, float length = 1.0f, QWidget* parent = nullptr);
+	explicit LinkWidget(ComponentHandle handle, float length = 1.0f, QWidget* parent = nullptr);
 
-	void setIndex(std::size_t index);
-	std::size_t index() const { return m_index; }
+	ComponentHandle handle() const { return m_handle; }
 
 signals:
-	void removeRequested(std::size_t index);
+	void removeRequested(ComponentHandle handle);
 
 private:
-	std::size_t m_index;
-	QLabel* m_titleLabel;
+	ComponentHandle m_handle;
 };
 
 class RobotArmControls : public QWidget {
@@ -96,17 +89,19 @@ signals:
 	void hingeAdded();
 	void swivelAdded();
 	void linkAdded(float length);
-	void pistonTargetLengthChanged(std::size_t index, float length);
-	void hingeTargetAngleChanged(std::size_t index, float angle);
-	void swivelRotationalSpeedChanged(std::size_t index, float speed);
-	void componentRemoved(std::size_t index);
+	void pistonTargetLengthChanged(ComponentHandle handle, float length);
+	void hingeTargetAngleChanged(ComponentHandle handle, float angle);
+	void swivelRotationalSpeedChanged(ComponentHandle handle, float speed);
+	// The widget stays until removeComponentWidget is called for it, once the simulation accepted the removal
+	void componentRemoveRequested(ComponentHandle handle);
 
 public slots:
-	void addPistonWidget(float maxLength = 5.0f);
-	void addHingeWidget(float initialAngle = 0.0f);
-	void addSwivelWidget(float speed = 0.0f);
-	void addLinkWidget(float length = 1.0f);
-	void removeComponentWidget(std::size_t index);
+	// handle is what the simulation returned for the component, the widget sends it back with every change
+	void addPistonWidget(ComponentHandle handle, float maxLength = 5.0f, float targetLength = 1.0f);
+	void addHingeWidget(ComponentHandle handle, float initialAngle = 0.0f);
+	void addSwivelWidget(ComponentHandle handle, float speed = 0.0f);
+	void addLinkWidget(ComponentHandle handle, float length = 1.0f);
+	void removeComponentWidget(ComponentHandle handle);
 	void clear();
 
 private slots:
@@ -114,11 +109,11 @@ private slots:
 	void onAddComponentClicked();
 
 private:
-	void rebuildIndices();
 	void updateParameterVisibility();
+	void insertComponentWidget(ComponentHandle handle, QWidget* widget);
 
 	QVBoxLayout* m_componentsLayout;
-	std::vector<QWidget*> m_componentWidgets;
+	std::vector<QWidget*> m_componentWidgets; // Indexed by handle slot, nullptr for free slots
 
 	// Component type selection
 	QButtonGroup* m_componentTypeGroup;
@@ -6,18 +6,29 @@
 #define ROBOTARM_SCENE_HPP
 #include "RobotArm/Rendering/Camera.hpp"
 #include "RobotArm/Rendering/RenderQueue.hpp"
-#include "RobotArm/Simulation/Simulation.hpp"
+#include "RobotArm/Simulation/SimulationThread.hpp"
+#include "RobotArm/Simulation/Trajectory.hpp"
+#include <chrono>
+#include <filesystem>
+#include <optional>
 
 class Scene
 {
-	Simulation m_simulation;
+	SimulationThread m_simulation;
 	Camera m_camera;
+	RenderData m_render_data; // Reused every frame so the simulation doesn't allocate
+	std::optional<TrajectoryPlayer> m_replay;
+	std::chrono::steady_clock::time_point m_replay_start;
 
 	public:
 	Scene() = default;
-	void submit_to(RenderQueue& queue) const;
+	void submit_to(RenderQueue& queue);
 	Camera& get_camera();
-	Simulation& get_simulation();
+	SimulationThread& get_simulation();
+	// Shows a recorded trajectory on a loop instead of the live simulation
+	void replay(const std::filesystem::path& path);
+	// Draws the velocity of every joint frame, not just the tip
+	void show_segment_velocities(bool show);
 };
 
 #endif // ROBOTARM_SCENE_HPP
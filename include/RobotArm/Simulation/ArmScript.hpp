@@ -0,0 +1,51 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_ARMSCRIPT_HPP
+#define ROBOTARM_ARMSCRIPT_HPP
+#include <glm/glm.hpp>
+#include <istream>
+#include <ostream>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <vector>
+
+// Plain text formats for driving a Simulation without the UI, one statement per line and # starts a comment.
+//
+// Arm description, components in storage order:
+//   link <length> | piston <max_length> | hinge | swivel
+// optionally followed by state, anything left out keeps the default of the add_* call:
+//   parent <index>|base      what it attaches to, the component before by default. Has to keep the arm depth first
+//   length <l> target <t>    Piston
+//   angle <a> target <t>     Hinge
+//   angle <a> speed <s>      Swivel
+//   mass <kg> com <x y z> inertia <9 values, row major, about the center of mass>
+// and anywhere
+//   gravity <x y z>
+//
+// Command script, commands fire once the simulated clock reaches <time>, they have to be sorted by time:
+//   <time> piston <idx> <target_length>
+//   <time> hinge <idx> <target_angle>
+//   <time> swivel_speed <idx> <speed>
+//   <time> swivel_angle <idx> <angle>
+//   <time> reach <x> <y> <z>           (solves IK for the tip and sets the resulting joint targets)
+//
+// Both parsers throw std::runtime_error naming the offending line.
+
+enum class ScriptCommandType {PistonTarget, HingeTarget, SwivelSpeed, SwivelAngle, Reach};
+
+struct ScriptCommand
+{
+	float			  time;
+	ScriptCommandType type;
+	std::size_t		  index = 0;	// Component index, unused by Reach
+	float			  value = 0.0f; // Unused by Reach
+	glm::vec3		  target{0.0f}; // Only used by Reach
+};
+
+[[nodiscard]] Simulation				 parse_arm_description(std::istream& in);
+// Text form of everything an ArmSnapshot holds but the handles, parse_arm_description reads it back exactly
+void									 write_arm_description(std::ostream& out, const Simulation& sim);
+[[nodiscard]] std::vector<ScriptCommand> parse_command_script(std::istream& in);
+
+#endif // ROBOTARM_ARMSCRIPT_HPP
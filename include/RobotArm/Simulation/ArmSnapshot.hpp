@@ -0,0 +1,49 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_ARMSNAPSHOT_HPP
+#define ROBOTARM_ARMSNAPSHOT_HPP
+#include <cstddef>
+#include <filesystem>
+#include <RobotArm/Simulation/MappedFile.hpp>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <span>
+#include <vector>
+
+// Versioned binary image of an arm: the tree, the full state of every component, mass properties, gravity and the
+// handle table, so handles taken before a snapshot still resolve after restoring it. The environment isn't part of it.
+//
+// Layout: header, then columns in storage order: one fixed size record per component, parents, handle slots and mass
+// properties, then the slot table of the handles. Little endian.
+// The same bytes serve as an in memory snapshot for rollback and as a file. Loading maps the file and checks it once,
+// restoring copies the columns straight from the mapping into the simulation. A text form is write_arm_description.
+class ArmSnapshot
+{
+	std::vector<std::byte>	   m_owned; // Captured snapshots
+	MappedFile				   m_file;	// Loaded snapshots
+	std::span<const std::byte> m_bytes;
+
+public:
+	ArmSnapshot() = default;
+	ArmSnapshot(ArmSnapshot&&) noexcept			   = default;
+	ArmSnapshot& operator=(ArmSnapshot&&) noexcept = default;
+	ArmSnapshot(const ArmSnapshot&)				   = delete;
+	ArmSnapshot& operator=(const ArmSnapshot&)	   = delete;
+
+	// Reuses the buffer of this snapshot, taking one every tick doesn't allocate once it is large enough
+	void capture(const Simulation& sim);
+	// Puts sim into exactly the captured state and reuses its capacity. Tick statistics and environment are kept
+	void					 restore(Simulation& sim) const;
+	[[nodiscard]] Simulation to_simulation() const;
+
+	// Throws std::runtime_error for anything that isn't a valid snapshot, so restoring it can't fail
+	[[nodiscard]] static ArmSnapshot load(const std::filesystem::path& path);
+	void							 save(const std::filesystem::path& path) const;
+
+	[[nodiscard]] bool						 empty() const { return m_bytes.empty(); }
+	[[nodiscard]] std::span<const std::byte> bytes() const { return m_bytes; }
+	[[nodiscard]] std::size_t				 component_count() const;
+};
+
+#endif // ROBOTARM_ARMSNAPSHOT_HPP
@@ -0,0 +1,124 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_COMMANDQUEUE_HPP
+#define ROBOTARM_COMMANDQUEUE_HPP
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+// Bounded lock free multi producer single consumer ring buffer.
+// Every slot carries a sequence number telling whose turn it is: producers claim a position with a CAS on the tail and
+// publish by bumping the slot sequence, the consumer reads slots in order until it finds one that isn't published yet.
+// A full queue makes try_push fail instead of waiting, so producers never block. The capacity is rounded up to a power
+// of two.
+template <class T>
+	requires std::is_trivially_copyable_v<T>
+class CommandQueue
+{
+	struct Slot
+	{
+		std::atomic<std::uint64_t> sequence;
+		T						   value;
+	};
+
+	// Producers and the consumer hammer different ends, keep them off each others cache lines
+	static constexpr std::size_t CACHE_LINE = 64;
+
+	std::uint64_t									 m_mask;
+	std::unique_ptr<Slot[]>							 m_slots;
+	alignas(CACHE_LINE) std::atomic<std::uint64_t>	 m_tail{0}; // Next position a producer claims
+	std::atomic<std::uint64_t>						 m_dropped{0};
+	alignas(CACHE_LINE) std::atomic<std::uint64_t>	 m_head{0}; // Next position the consumer reads, only it writes
+
+public:
+	explicit CommandQueue(std::size_t capacity)
+		: m_mask(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1)
+	{
+		m_slots = std::make_unique<Slot[]>(m_mask + 1);
+		for (std::uint64_t i = 0; i <= m_mask; ++i)
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	CommandQueue(const CommandQueue&)			 = delete;
+	CommandQueue& operator=(const CommandQueue&) = delete;
+
+	// Any thread, false if the queue was full and the value got dropped
+	bool try_push(const T& value)
+	{
+		std::uint64_t position = m_tail.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Slot&		  slot	   = m_slots[position & m_mask];
+			std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+			auto		  diff	   = static_cast<std::int64_t>(sequence - position);
+			if (diff == 0)
+			{
+				if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					slot.value = value;
+					slot.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				// The consumer hasn't freed this slot from the previous lap yet
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+			{
+				position = m_tail.load(std::memory_order_relaxed); // Another producer got there first
+			}
+		}
+	}
+
+	// Consumer thread only
+	std::optional<T> try_pop()
+	{
+		std::uint64_t position = m_head.load(std::memory_order_relaxed);
+		Slot&		  slot	   = m_slots[position & m_mask];
+		if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+			return std::nullopt; // Empty, or a producer claimed the slot but hasn't finished writing it
+		T value = slot.value;
+		slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+		m_head.store(position + 1, std::memory_order_relaxed);
+		return value;
+	}
+
+	// Consumer thread only, pops everything published so far and returns how many values were appended
+	template <class Container>
+	std::size_t drain(Container& out)
+	{
+		std::uint64_t start	   = m_head.load(std::memory_order_relaxed);
+		std::uint64_t position = start;
+		while (true)
+		{
+			Slot& slot = m_slots[position & m_mask];
+			if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+				break;
+			out.push_back(slot.value);
+			slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+			++position;
+		}
+		m_head.store(position, std::memory_order_relaxed);
+		return static_cast<std::size_t>(position - start);
+	}
+
+	// Monitoring, a snapshot that may be stale by the time it is read
+	[[nodiscard]] std::size_t depth() const
+	{
+		std::uint64_t head = m_head.load(std::memory_order_relaxed);
+		std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+		return tail > head ? static_cast<std::size_t>(tail - head) : 0;
+	}
+	[[nodiscard]] std::size_t	capacity() const { return static_cast<std::size_t>(m_mask + 1); }
+	[[nodiscard]] std::uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+};
+
+#endif // ROBOTARM_COMMANDQUEUE_HPP
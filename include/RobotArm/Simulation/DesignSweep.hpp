@@ -0,0 +1,97 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_DESIGNSWEEP_HPP
+#define ROBOTARM_DESIGNSWEEP_HPP
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <RobotArm/Simulation/ArmScript.hpp>
+#include <RobotArm/Simulation/ReachabilityMap.hpp>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One choice for a slot of a design, size is the Link length or the Piston max_length and unused by the others
+struct ComponentOption
+{
+	ComponentType type;
+	float		  size = 0.0f;
+};
+
+// Every candidate is a serial chain with one component per slot, picked from the options of that slot. A slot with
+// joints of several types sweeps over joint orderings, one with Links of several lengths over the geometry.
+struct DesignSpace
+{
+	std::vector<std::vector<ComponentOption>> slots; // Chain order
+
+	// Product of the option counts, saturates at the largest std::uint64_t
+	[[nodiscard]] std::uint64_t candidate_count() const;
+	// Option index of every slot, candidates are counted with the first slot changing fastest
+	void decode(std::uint64_t candidate, std::span<std::uint32_t> choices) const;
+	// Clears sim and builds the chosen arm into it, reusing its capacity
+	void build(std::span<const std::uint32_t> choices, Simulation& sim) const;
+};
+
+// count evenly spaced options from first to last
+[[nodiscard]] std::vector<ComponentOption> link_options(float first, float last, std::size_t count);
+[[nodiscard]] std::vector<ComponentOption> piston_options(float first, float last, std::size_t count);
+
+// One column of the output. It gets its own copy of the candidate, so whatever it does to the arm doesn't reach the
+// other metrics. Runs on the pool threads and has to be safe to call concurrently, exceptions are recorded as NaN.
+struct DesignMetric
+{
+	static constexpr std::size_t MAX_NAME_LENGTH = 31;
+
+	std::string						  name;
+	std::function<float(Simulation&)> evaluate;
+};
+
+// Distance from the base to the tip with the arm stretched out, Pistons at full length and every angle at 0
+[[nodiscard]] DesignMetric reach_metric();
+// Reachable volume in cubic meters, the voxels of a ReachabilityMap generated on the calling thread
+[[nodiscard]] DesignMetric coverage_metric(ReachabilitySettings settings);
+// Simulated seconds from the start of script until the arm comes to rest after its last command, infinity if it is
+// still moving at time_limit. Reach commands solve IK on a solver per thread
+[[nodiscard]] DesignMetric cycle_time_metric(std::vector<ScriptCommand> script, float dt = 1.0f / 240.0f,
+											 float time_limit = 60.0f);
+
+struct DesignSweepSettings
+{
+	std::uint64_t samples	   = 0; // 0 enumerates every candidate, otherwise draws this many uniformly with replacement
+	std::uint64_t seed		   = 1;
+	std::size_t	  batch_size   = 4096; // Candidates evaluated between two writes, bounds the memory of a sweep
+	std::size_t	  thread_count = std::thread::hardware_concurrency();
+};
+
+struct DesignSweepStatistics
+{
+	std::uint64_t candidates = 0;
+	std::uint64_t failures	 = 0; // Metric evaluations that threw
+	double		  seconds	 = 0.0;
+};
+
+// Evaluates metrics over a design space on a ThreadPool and streams one row per candidate into a columnar file.
+// Candidates are built into simulations taken from a pool, so past the first batch a sweep doesn't allocate per
+// candidate unless the metrics do. Rows are written batch by batch in candidate order, samples are derived from their
+// index alone, and so the file doesn't depend on the thread count.
+DesignSweepStatistics run_design_sweep(const DesignSpace& space, std::span<const DesignMetric> metrics,
+									   const std::filesystem::path& output, DesignSweepSettings settings = {});
+
+// A sweep read back into whole columns.
+// Layout: header, metric names, then one block per batch holding the candidate indices, the option of every slot and
+// every metric as contiguous little endian columns. Blocks are 8 byte aligned.
+struct DesignSweepResults
+{
+	std::vector<std::string>				metric_names;
+	std::vector<std::uint64_t>				candidates;
+	std::vector<std::vector<std::uint32_t>> choices; // Per slot
+	std::vector<std::vector<float>>			metrics; // Per metric
+
+	[[nodiscard]] static DesignSweepResults load(const std::filesystem::path& path);
+};
+
+#endif // ROBOTARM_DESIGNSWEEP_HPP
@@ -0,0 +1,106 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_DISTANCEFIELD_HPP
+#define ROBOTARM_DISTANCEFIELD_HPP
+#include <cstdint>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <RobotArm/Simulation/MappedFile.hpp>
+#include <RobotArm/Simulation/RigidTransform.hpp>
+#include <span>
+#include <thread>
+#include <variant>
+#include <vector>
+
+// Static obstacles in the scene, each placed by a pose. Boxes and cylinders are centered on it, cylinders stand on
+// the local y axis like Piston
+struct BoxObstacle
+{
+	RigidTransform pose;
+	glm::vec3	   half_extents;
+};
+struct CylinderObstacle
+{
+	RigidTransform pose;
+	float		   radius;
+	float		   half_height;
+};
+// Closed triangle mesh in its own frame, every three indices are one triangle
+struct MeshObstacle
+{
+	RigidTransform			   pose;
+	std::vector<glm::vec3>	   vertices;
+	std::vector<std::uint32_t> indices;
+};
+using Obstacle = std::variant<BoxObstacle, CylinderObstacle, MeshObstacle>;
+
+// Exact signed distance, negative inside
+[[nodiscard]] float signed_distance(const Obstacle& obstacle, glm::vec3 point);
+
+struct DistanceFieldSettings
+{
+	float		voxel_size	 = 0.05f;
+	float		padding		 = 1.0f; // Margin around the obstacles where the field is sampled
+	std::size_t thread_count = std::thread::hardware_concurrency();
+};
+
+struct DistanceSample
+{
+	float	  distance;
+	glm::vec3 gradient; // Points away from the nearest obstacle, not normalized
+};
+
+// How far one arm segment is from the obstacles
+struct Clearance
+{
+	float	  distance;	 // Between the capsule surface and the nearest obstacle, negative when they overlap
+	glm::vec3 direction; // Unit vector from the closest point of the segment towards the obstacle
+};
+
+// Signed distance to a set of obstacles, baked into a regular grid so a query is 8 lookups no matter how many or how
+// complicated the obstacles are. Distance and gradient are trilinearly interpolated between grid points.
+// Baking evaluates every obstacle at every grid point on a ThreadPool. Like ReachabilityMap the result can be saved
+// and is used straight from the mapping when loaded, load_or_bake only bakes when the cached file was made from
+// different obstacles or settings.
+// Outside the grid the distance to the grid is added to the sample on its border, which is only an estimate.
+class DistanceField
+{
+	glm::vec3			   m_origin{0.0f}; // Position of the first grid point
+	float				   m_voxel_size = 0.0f;
+	glm::ivec3			   m_size{0};	   // Grid points per axis
+	std::uint64_t		   m_key		= 0; // Hash of what was baked, see load_or_bake
+	std::vector<float>	   m_owned;		   // Baked fields
+	MappedFile			   m_file;		   // Loaded fields
+	std::span<const float> m_values;	   // x fastest, then y, then z
+
+public:
+	DistanceField() = default;
+	DistanceField(DistanceField&&) noexcept			   = default;
+	DistanceField& operator=(DistanceField&&) noexcept = default;
+	DistanceField(const DistanceField&)				   = delete;
+	DistanceField& operator=(const DistanceField&)	   = delete;
+
+	[[nodiscard]] static DistanceField bake(std::span<const Obstacle> obstacles, DistanceFieldSettings settings = {});
+	[[nodiscard]] static DistanceField load(const std::filesystem::path& path);
+	void							   save(const std::filesystem::path& path) const;
+	// Loads path if it was baked from the same obstacles and settings, otherwise bakes and overwrites it
+	[[nodiscard]] static DistanceField load_or_bake(const std::filesystem::path& path,
+													std::span<const Obstacle> obstacles, DistanceFieldSettings settings = {});
+
+	// Infinite distance when there are no obstacles
+	[[nodiscard]] DistanceSample sample(glm::vec3 point) const;
+	// Smallest distance along the segment a-b minus radius. Samples are at most a voxel apart and skip ahead as far as
+	// the distance allows, so a minimum between two samples can be missed by up to half a voxel
+	[[nodiscard]] Clearance clearance(glm::vec3 a, glm::vec3 b, float radius) const;
+
+	[[nodiscard]] bool					   empty() const { return m_values.empty(); }
+	[[nodiscard]] glm::vec3				   origin() const { return m_origin; }
+	[[nodiscard]] float					   voxel_size() const { return m_voxel_size; }
+	[[nodiscard]] glm::ivec3			   size() const { return m_size; }
+	[[nodiscard]] std::uint64_t			   key() const { return m_key; }
+	[[nodiscard]] std::span<const float>   values() const { return m_values; }
+};
+
+#endif // ROBOTARM_DISTANCEFIELD_HPP
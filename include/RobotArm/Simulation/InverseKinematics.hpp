@@ -0,0 +1,58 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_INVERSEKINEMATICS_HPP
+#define ROBOTARM_INVERSEKINEMATICS_HPP
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <span>
+#include <vector>
+
+struct IkSettings
+{
+	int	  max_iterations = 64;
+	float damping		 = 0.05f;	// lambda of the damped least squares step, trades accuracy for stability near singularities
+	float tolerance		 = 1e-3f;	// Tip distance to the target that counts as solved
+	float max_step		 = 2.0f;	// Clamps the tip error per iteration so far targets don't overshoot
+	float hinge_limit	 = 3.1415f; // Hinges stay in [-hinge_limit, hinge_limit], same range as the UI
+};
+
+struct IkResult
+{
+	bool  converged	 = false;
+	int	  iterations = 0;
+	float error		 = 0.0f; // Remaining distance between tip and target
+};
+
+// Damped least squares solver for the tip position.
+// Solves over every Piston, Hinge and Swivel between the base and the tip, starting from the current state of the arm.
+// The tip is the last component in storage, on branching arms the other branches are left alone. Swivels that are
+// spinning stay locked since they'd move away from the solution anyway.
+// Keeps its scratch buffers between solves, so after the first solve for an arm of a given size nothing allocates.
+class IkSolver
+{
+	IkSettings					m_settings;
+	std::vector<std::size_t>	m_path;		  // Components from the base to the tip, every one attached to the one before
+	std::vector<Component>		m_components; // Working copy of the components on m_path, indexed like it
+	std::vector<std::size_t>	m_free_joints;	// Position in m_path of every joint taking part in the solve
+	std::vector<std::uint32_t>	m_free_columns; // and its Jacobian column in the simulation
+	std::vector<float>			m_lower;
+	std::vector<float>			m_upper;
+	std::vector<RigidTransform> m_free_transforms;
+	std::vector<JacobianColumn> m_jacobian;
+
+	void	  load(const Simulation& sim);
+	glm::vec3 forward_kinematics();
+	IkResult  iterate(const Simulation& sim, glm::vec3 target);
+
+public:
+	explicit IkSolver(IkSettings settings = {});
+
+	// Writes the solved positions into the targets of the joints between the base and the tip, Swivels are placed
+	// directly. Every other joint keeps its target and whatever motion it was making
+	IkResult solve(Simulation& sim, glm::vec3 target);
+	// Leaves sim untouched, solution holds one position per joint in Simulation::get_joint_count() order
+	IkResult solve(const Simulation& sim, glm::vec3 target, std::span<float> solution);
+};
+
+#endif // ROBOTARM_INVERSEKINEMATICS_HPP
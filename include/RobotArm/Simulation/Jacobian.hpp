@@ -0,0 +1,38 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_JACOBIAN_HPP
+#define ROBOTARM_JACOBIAN_HPP
+#include <glm/glm.hpp>
+#include <span>
+
+// One column of the 6xN geometric Jacobian, the tip twist caused by a unit velocity of a single joint
+struct JacobianColumn
+{
+	glm::vec3 linear;
+	glm::vec3 angular;
+};
+
+struct Twist
+{
+	glm::vec3 linear;
+	glm::vec3 angular;
+};
+
+struct VelocityEllipsoid
+{
+	glm::vec3 radii; // Largest first, a unit joint velocity vector can move the tip this fast along the axis
+	glm::mat3 axes;	 // Column i is the direction of radii[i]
+};
+
+// None of these allocate, they are meant to run every control cycle
+[[nodiscard]] Twist map_joint_velocities(std::span<const JacobianColumn> jacobian,
+										 std::span<const float>			 joint_velocities);
+// Yoshikawa's measure sqrt(det(J J^T)), zero for arms with fewer than 6 joints
+[[nodiscard]] float manipulability(std::span<const JacobianColumn> jacobian);
+// Same measure using only the linear rows, which is what matters when only the tip position is controlled
+[[nodiscard]] float translational_manipulability(std::span<const JacobianColumn> jacobian);
+[[nodiscard]] VelocityEllipsoid velocity_ellipsoid(std::span<const JacobianColumn> jacobian);
+
+#endif // ROBOTARM_JACOBIAN_HPP
@@ -0,0 +1,87 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_JOINTTRAJECTORY_HPP
+#define ROBOTARM_JOINTTRAJECTORY_HPP
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <span>
+#include <vector>
+
+enum class SplineOrder {Cubic, Quintic};
+
+struct PlannerSettings
+{
+	SplineOrder order				 = SplineOrder::Quintic; // Quintic also has zero acceleration at every waypoint
+	float		swivel_speed_limit	 = Hinge::ROTATION_SPEED; // Swivels have no speed of their own to go by
+	float		min_segment_duration = 0.01f;
+};
+
+// Time parameterised spline through joint space waypoints, one polynomial segment per pair of waypoints.
+// Coefficients are stored per segment as [coefficient][joint] with the joint count padded to LANES, so evaluating
+// all joints is a Horner loop over contiguous, padded rows of floats that the compiler vectorizes.
+class JointTrajectory
+{
+public:
+	static constexpr std::size_t LANES = 8;
+
+private:
+	std::size_t		   m_joint_count		= 0;
+	std::size_t		   m_stride				= 0; // Joint count rounded up to LANES
+	std::size_t		   m_coefficient_count	= 0; // 4 for cubic, 6 for quintic
+	std::vector<float> m_times;					 // Start of every segment plus the end of the last one
+	std::vector<float> m_coefficients;			 // [segment][coefficient][stride], in segment local time
+	std::vector<float> m_final_positions;
+
+	friend JointTrajectory plan_trajectory(const Simulation&, std::span<const float>, PlannerSettings);
+
+public:
+	[[nodiscard]] std::size_t joint_count() const { return m_joint_count; }
+	[[nodiscard]] std::size_t stride() const { return m_stride; }
+	[[nodiscard]] std::size_t segment_count() const { return m_times.empty() ? 0 : m_times.size() - 1; }
+	[[nodiscard]] float		  duration() const { return m_times.empty() ? 0.0f : m_times.back(); }
+	[[nodiscard]] std::span<const float> final_positions() const { return m_final_positions; }
+
+	// Segment containing time, starting the search at hint so playing forward is O(1)
+	[[nodiscard]] std::size_t find_segment(float time, std::size_t hint = 0) const;
+	// positions needs stride() floats, the padding lanes are written too
+	void evaluate(std::size_t segment, float time, std::span<float> positions) const;
+	void evaluate_velocity(std::size_t segment, float time, std::span<float> velocities) const;
+	// Convenience overload, finds the segment itself
+	void evaluate(float time, std::span<float> positions) const;
+};
+
+// Plans from the current joint positions of sim through every waypoint, waypoints holds get_joint_count() floats per
+// waypoint in Jacobian order. Segment durations follow the slowest joint, then the whole trajectory is stretched until
+// no joint exceeds its speed (PISTON_SPEED, ROTATION_SPEED, swivel_speed_limit). Starts and ends at rest.
+// Throws std::invalid_argument for malformed waypoints or piston lengths out of range.
+[[nodiscard]] JointTrajectory plan_trajectory(const Simulation& sim, std::span<const float> waypoints,
+											  PlannerSettings settings = {});
+
+// Plays trajectories on any number of simulations, evaluating all of them in one pass per tick.
+// Joints are placed directly with Simulation::set_joint_positions, the simulations must outlive their trajectories.
+class TrajectoryExecutor
+{
+	struct Entry
+	{
+		Simulation*		sim;
+		JointTrajectory trajectory;
+		float			time	= 0.0f;
+		std::size_t		segment = 0;
+	};
+
+	std::vector<Entry> m_entries;
+	std::vector<float> m_positions; // Scratch, sized to the widest trajectory
+
+public:
+	// Replaces whatever trajectory sim was running
+	void run(Simulation& sim, JointTrajectory trajectory);
+	void stop(const Simulation& sim);
+	// Advances every trajectory by dt and writes the joint positions, finished ones end on their last waypoint
+	void tick(float dt);
+
+	[[nodiscard]] bool		  is_running(const Simulation& sim) const;
+	[[nodiscard]] std::size_t active_count() const { return m_entries.size(); }
+};
+
+#endif // ROBOTARM_JOINTTRAJECTORY_HPP
@@ -0,0 +1,77 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_KINEMATICSBATCH_HPP
+#define ROBOTARM_KINEMATICSBATCH_HPP
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <RobotArm/Simulation/RigidTransform.hpp>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <span>
+#include <vector>
+
+// Forward kinematics of many arms that share one topology and only differ in their joint positions.
+// Arms are stored in groups of lane_count side by side (AoSoA): every joint position and every float of every joint
+// transform is an array with one entry per arm of the group, so one pass over the shared topology computes a whole
+// group with each arm in its own SIMD lane. The kernel is compiled for SSE, AVX2 and AVX-512 and picked at runtime,
+// sin and cos are evaluated for a whole group at once instead of calling std::sin per joint.
+// Joint transforms match Simulation::get_chain within float rounding, sin and cos agree with the standard library to
+// a few ulp for angles up to a few thousand radians.
+class KinematicsBatch
+{
+public:
+	// One component of the shared topology, storage order like Simulation
+	struct Step
+	{
+		ComponentType type;
+		std::uint32_t parent; // Simulation::NO_PARENT on the base
+		std::uint32_t joint;  // Column of the joint position, unused by Links
+		float		  length; // Links only, they are part of the topology
+	};
+
+private:
+	using Kernel = void (*)(std::span<const Step> steps, std::size_t joint_count, const float* positions, float* joints,
+							std::size_t group_count);
+
+	std::vector<Step>  m_steps;
+	std::size_t		   m_joint_count = 0;
+	std::size_t		   m_lane_count	 = 0;
+	std::size_t		   m_arm_count	 = 0;
+	std::vector<float> m_positions; // Per group joint_count x lane_count
+	std::vector<float> m_joints;	// Per group component_count x 12 x lane_count, rotation columns then translation
+	Kernel			   m_kernel = nullptr;
+
+	[[nodiscard]] const float* lanes(std::size_t arm, std::size_t idx) const;
+
+public:
+	// 16 with AVX-512, 8 with AVX2 and 4 otherwise, the widest the running CPU has a kernel for
+	[[nodiscard]] static std::size_t native_lane_count();
+
+	// Takes the component types, parents and Link lengths of topology. lane_count has to be 4, 8 or 16, a width the
+	// CPU can't run falls back to the SSE kernel with that layout
+	explicit KinematicsBatch(const Simulation& topology, std::size_t lane_count = native_lane_count());
+
+	// Returns the index of the new arm. Throws std::invalid_argument if sim has a different topology
+	std::size_t add_arm(const Simulation& sim);
+	// Positions in Jacobian column order like Simulation::set_joint_positions
+	std::size_t add_arm(std::span<const float> positions);
+	void		set_joint_positions(std::size_t arm, std::span<const float> positions);
+	void		clear();
+
+	// Joint transform of every component of every arm
+	void compute();
+
+	// Valid after compute
+	[[nodiscard]] RigidTransform get_joint(std::size_t arm, std::size_t idx) const;
+	// The joint of the last component in storage, like RenderData::tip_pos
+	[[nodiscard]] glm::vec3 get_tip_position(std::size_t arm) const;
+	void					get_tip_positions(std::span<glm::vec3> positions) const;
+
+	[[nodiscard]] std::size_t			size() const { return m_arm_count; }
+	[[nodiscard]] std::size_t			lane_count() const { return m_lane_count; }
+	[[nodiscard]] std::size_t			joint_count() const { return m_joint_count; }
+	[[nodiscard]] std::span<const Step> get_steps() const { return m_steps; }
+};
+
+#endif // ROBOTARM_KINEMATICSBATCH_HPP
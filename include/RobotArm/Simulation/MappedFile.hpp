@@ -0,0 +1,42 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_MAPPEDFILE_HPP
+#define ROBOTARM_MAPPEDFILE_HPP
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+// Whole file mapping through POSIX mmap, move only. Errors are reported as std::system_error.
+class MappedFile
+{
+	int			m_fd	   = -1;
+	std::byte*	m_data	   = nullptr;
+	std::size_t m_size	   = 0;
+	bool		m_writable = false;
+
+	void map();
+	void unmap();
+
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&)			 = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	[[nodiscard]] static MappedFile open_read(const std::filesystem::path& path);
+	// Creates or truncates the file and maps size bytes of it for writing
+	[[nodiscard]] static MappedFile create(const std::filesystem::path& path, std::size_t size);
+
+	// Grows or shrinks a writable mapping, pointers into the old mapping are invalidated
+	void resize(std::size_t size);
+
+	[[nodiscard]] std::span<std::byte>		 bytes() { return {m_data, m_size}; }
+	[[nodiscard]] std::span<const std::byte> bytes() const { return {m_data, m_size}; }
+	[[nodiscard]] std::size_t				 size() const { return m_size; }
+};
+
+#endif // ROBOTARM_MAPPEDFILE_HPP
@@ -0,0 +1,84 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_REACHABILITYMAP_HPP
+#define ROBOTARM_REACHABILITYMAP_HPP
+#include <cstdint>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <RobotArm/Simulation/MappedFile.hpp>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <span>
+#include <thread>
+#include <vector>
+
+enum class ReachabilitySampling
+{
+	// Latin hypercube, every joint range split into one stratum per sample and each stratum hit exactly once with
+	// jitter. Unlike a full grid it keeps the sample count and still stratifies arms with many joints
+	Stratified,
+	Random // Independent uniform samples
+};
+
+struct ReachabilitySettings
+{
+	float				 voxel_size = 0.05f;
+	std::uint64_t		 samples	= 1'000'000;
+	ReachabilitySampling sampling	= ReachabilitySampling::Stratified;
+	float				 hinge_limit = 3.1415f; // Hinges are sampled in [-hinge_limit, hinge_limit], Swivels all around
+	std::uint64_t		 seed		 = 1;
+	std::size_t			 thread_count = std::thread::hardware_concurrency();
+};
+
+// One occupied voxel, manipulability is the translational Yoshikawa measure of the poses that reached it
+struct ReachabilityVoxel
+{
+	std::uint64_t morton; // Interleaved voxel coordinates, see morton_encode
+	std::uint32_t hits;
+	float		  min_manipulability;
+	float		  mean_manipulability;
+	float		  max_manipulability;
+};
+static_assert(sizeof(ReachabilityVoxel) == 24);
+
+// Sparse voxel grid of every tip position an arm can reach.
+// Sampling runs the forward kinematics of Simulation on a ThreadPool, every partition of the samples fills its own
+// grid which are merged at the end. Samples are derived from their index alone, so the same settings give the same
+// hits regardless of the thread count. Voxels are sorted by Morton code, which keeps neighbours close in memory and
+// lets lookups binary search. Saved maps are used straight from the mapping, loading doesn't copy or parse anything.
+class ReachabilityMap
+{
+	float							   m_voxel_size	  = 0.0f;
+	std::uint64_t					   m_sample_count = 0;
+	std::vector<ReachabilityVoxel>	   m_owned; // Generated maps
+	MappedFile						   m_file;	// Loaded maps
+	std::span<const ReachabilityVoxel> m_voxels;
+
+public:
+	// 21 bits per axis, coordinates are offset so the grid is centered on the arm base
+	static constexpr std::int32_t MORTON_OFFSET = 1 << 20;
+
+	ReachabilityMap() = default;
+	ReachabilityMap(ReachabilityMap&&) noexcept			   = default;
+	ReachabilityMap& operator=(ReachabilityMap&&) noexcept = default;
+	ReachabilityMap(const ReachabilityMap&)				   = delete;
+	ReachabilityMap& operator=(const ReachabilityMap&)	   = delete;
+
+	[[nodiscard]] static ReachabilityMap generate(const Simulation& sim, ReachabilitySettings settings = {});
+	[[nodiscard]] static ReachabilityMap load(const std::filesystem::path& path);
+	void								 save(const std::filesystem::path& path) const;
+
+	[[nodiscard]] std::span<const ReachabilityVoxel> voxels() const { return m_voxels; }
+	[[nodiscard]] float								 voxel_size() const { return m_voxel_size; }
+	[[nodiscard]] std::uint64_t						 sample_count() const { return m_sample_count; }
+
+	// nullptr if no sample ended up in the voxel containing position
+	[[nodiscard]] const ReachabilityVoxel* find(glm::vec3 position) const;
+	[[nodiscard]] glm::vec3				   voxel_center(std::uint64_t morton) const;
+
+	[[nodiscard]] static std::uint64_t morton_encode(glm::ivec3 voxel);
+	[[nodiscard]] static glm::ivec3	   morton_decode(std::uint64_t morton);
+};
+
+#endif // ROBOTARM_REACHABILITYMAP_HPP
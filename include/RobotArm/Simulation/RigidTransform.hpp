@@ -0,0 +1,57 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_RIGIDTRANSFORM_HPP
+#define ROBOTARM_RIGIDTRANSFORM_HPP
+#include <cmath>
+#include <glm/glm.hpp>
+
+// Rotation plus translation, the 3x4 part of an affine matrix. Every joint in the chain is rigid, scale only
+// matters for the meshes and is applied when the model matrix is emitted.
+// The rotate kernels only touch the two columns the axis mixes instead of doing a general glm::rotate.
+struct RigidTransform
+{
+	glm::mat3 rotation{1.0f};
+	glm::vec3 translation{0.0f};
+
+	// All of these move in the local frame, same as glm::translate / glm::rotate on the right
+	[[nodiscard]] RigidTransform translated_y(float distance) const
+	{
+		return {rotation, translation + rotation[1] * distance};
+	}
+	[[nodiscard]] RigidTransform rotated_y(float angle) const
+	{
+		float c = std::cos(angle);
+		float s = std::sin(angle);
+		return {{rotation[0] * c - rotation[2] * s, rotation[1], rotation[0] * s + rotation[2] * c}, translation};
+	}
+	[[nodiscard]] RigidTransform rotated_z(float angle) const
+	{
+		float c = std::cos(angle);
+		float s = std::sin(angle);
+		return {{rotation[0] * c + rotation[1] * s, rotation[1] * c - rotation[0] * s, rotation[2]}, translation};
+	}
+
+	[[nodiscard]] glm::vec3 transform_point(glm::vec3 point) const { return rotation * point + translation; }
+
+	[[nodiscard]] glm::mat4 to_mat4() const
+	{
+		return {glm::vec4(rotation[0], 0.0f), glm::vec4(rotation[1], 0.0f), glm::vec4(rotation[2], 0.0f),
+				glm::vec4(translation, 1.0f)};
+	}
+	// Scale is applied in the local frame, like glm::scale on the right
+	[[nodiscard]] glm::mat4 to_mat4(glm::vec3 scale) const
+	{
+		return {glm::vec4(rotation[0] * scale.x, 0.0f), glm::vec4(rotation[1] * scale.y, 0.0f),
+				glm::vec4(rotation[2] * scale.z, 0.0f), glm::vec4(translation, 1.0f)};
+	}
+
+	// Applies rhs in the local frame of lhs
+	friend RigidTransform operator*(const RigidTransform& lhs, const RigidTransform& rhs)
+	{
+		return {lhs.rotation * rhs.rotation, lhs.transform_point(rhs.translation)};
+	}
+};
+
+#endif // ROBOTARM_RIGIDTRANSFORM_HPP
@@ -0,0 +1,82 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_SELFCOLLISION_HPP
+#define ROBOTARM_SELFCOLLISION_HPP
+#include <cstdint>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <span>
+#include <vector>
+
+// Every component approximated by a capsule around the segment a-b, matching the meshes Scene draws
+struct Capsule
+{
+	glm::vec3 a;
+	glm::vec3 b;
+	float	  radius;
+	// Distance from the base along the unfolded arm covered by the capsule, used to tell which capsules touch by
+	// construction
+	float arc_start;
+	float arc_end;
+};
+
+// Capsule of one component from its parent joint and its own joint, the same shape get_render_data measures the
+// clearance to obstacles with
+[[nodiscard]] Capsule make_capsule(const Component& component, const RigidTransform& parent,
+								   const RigidTransform& joint, float arc_start = 0.0f);
+
+struct SelfContact
+{
+	std::size_t first; // Component indices, first < second
+	std::size_t second;
+	float		depth;	// How far the capsules overlap
+	glm::vec3	point;	// Halfway between the closest points of both axes
+};
+
+// Finds segments of the arm passing through each other.
+// Sweep and prune over capsule bounds on the axis the arm currently spreads along most, keeping the sort order between
+// calls so it is close to linear. Surviving pairs are gathered block by block into flat arrays and the capsule distance
+// is computed for a whole block in one branch free loop.
+// Capsules that already touch when the arm is stretched out (neighbours, or anything joined only by a Hinge or Swivel)
+// are never reported, keeping those apart is up to joint limits.
+class SelfCollisionDetector
+{
+	std::vector<Capsule>	   m_capsules;
+	std::vector<std::uint32_t> m_parents; // Of the arm in the last call
+	bool					   m_is_serial = true;
+	struct Bounds
+	{
+		glm::vec3	  min;
+		glm::vec3	  max;
+		std::uint32_t capsule;
+	};
+	// Sorted by the lower bound on the sweep axis, kept between calls so the next sort has little to do
+	std::vector<Bounds> m_bounds;
+
+	struct CandidatePair
+	{
+		std::uint32_t first;
+		std::uint32_t second;
+	};
+	std::vector<CandidatePair> m_pairs; // Survivors of the broadphase, first < second
+
+	std::vector<SelfContact> m_contacts;
+
+	void build_capsules(const Simulation& sim);
+	// Distance along the arm between the end of capsule low and the start of high, through the fork on branching arms
+	[[nodiscard]] float path_length_between(std::uint32_t low, std::uint32_t high) const;
+	void broadphase();
+	void narrowphase();
+
+public:
+	// Checks the current pose, the returned contacts stay valid until the next call
+	std::span<const SelfContact> detect(const Simulation& sim);
+
+	[[nodiscard]] std::span<const Capsule>	   get_capsules() const { return m_capsules; }
+	[[nodiscard]] std::span<const SelfContact> get_contacts() const { return m_contacts; }
+	// Pairs that survived the broadphase in the last call
+	[[nodiscard]] std::size_t candidate_count() const { return m_pairs.size(); }
+};
+
+#endif // ROBOTARM_SELFCOLLISION_HPP
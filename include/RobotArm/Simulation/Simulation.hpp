@@ -4,16 +4,50 @@
 
 #ifndef ROBOTARM_SIMULATION_HPP
 #define ROBOTARM_SIMULATION_HPP
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <memory>
+#include <optional>
+#include <RobotArm/Simulation/DistanceField.hpp>
+#include <RobotArm/Simulation/Jacobian.hpp>
+#include <RobotArm/Simulation/RigidTransform.hpp>
+#include <RobotArm/Simulation/SlotMap.hpp>
+#include <span>
 #include <variant>
 #include <vector>
 
+// Output of the full mat4 reference path, the simulation itself carries the chain as RigidTransform
 struct ModelMatrixChainOutput
 {
 	glm::mat4 model_matrix; // translation, rotation and scale of current component
 	glm::mat4 joint_matrix; // translation and rotation of where the next component is attached to
 };
 
+// Sums up the tip velocity in a single pass over the chain without remembering every rotating joint.
+// Relies on sum(w_i x (tip - p_i)) = (sum w_i) x tip - sum(w_i x p_i)
+class TipVelocityAccumulator
+{
+	glm::vec3 m_linear{0.0f};
+	glm::vec3 m_angular{0.0f};
+	glm::vec3 m_moment{0.0f};
+
+public:
+	void add_linear(glm::vec3 velocity);
+	void add_angular(glm::vec3 pivot, glm::vec3 omega);
+	[[nodiscard]] glm::vec3 velocity_at(glm::vec3 tip) const;
+};
+
+// Rigid body of a component in its joint frame, where the next component attaches, so it moves with the joint.
+// Components are massless until given one through Simulation::set_mass_properties
+struct MassProperties
+{
+	float	  mass = 0.0f;
+	glm::vec3 center_of_mass{0.0f};
+	glm::mat3 inertia{0.0f}; // About the center of mass, in the joint frame
+
+	// Uniform thin rod along y that ends at the joint, a Link or the moving rod of a Piston
+	[[nodiscard]] static MassProperties rod(float mass, float length);
+};
 
 // Extends or retracts
 struct Piston
@@ -24,8 +58,18 @@ struct Piston
 	float target_length = 1.0f;
 	float max_length = 1.0f;
 
-	void tick(float dt);
+	bool tick(float dt); // Returns whether the length changed
 	[[nodiscard]] ModelMatrixChainOutput get_model_matrix(glm::mat4 joint_matrix) const;
+	// Where the next component attaches, given where this one is attached
+	[[nodiscard]] RigidTransform get_joint_transform(const RigidTransform& parent) const;
+	// joint is get_joint_transform(parent), passed in so nothing is evaluated twice
+	[[nodiscard]] glm::mat4 emit_model_matrix(const RigidTransform& parent, const RigidTransform& joint) const;
+	[[nodiscard]] float velocity() const; // Signed extension speed, 0 once the target or the end of the stroke is reached
+	[[nodiscard]] float position() const { return current_length; }
+	void set_position(float f) { current_length = target_length = f; } // Places it directly, without moving there
+	void add_tip_velocity(TipVelocityAccumulator& accumulator, const RigidTransform& joint) const;
+	// Joints contribute one Jacobian column each, tip is the world position of the end of the chain
+	[[nodiscard]] JacobianColumn get_jacobian_column(const RigidTransform& joint, glm::vec3 tip) const;
 };
 
 
@@ -34,19 +78,34 @@ struct Hinge
 	static constexpr float ROTATION_SPEED = 3.1415f / 2.0f; // 90° / sec
 	float current_angle = 0.0f;
 	float target_angle = 0.0f;
-	void tick(float dt);
+	bool tick(float dt); // Returns whether the angle changed
 	[[nodiscard]] ModelMatrixChainOutput get_model_matrix(glm::mat4 joint_matrix) const;
+	[[nodiscard]] RigidTransform get_joint_transform(const RigidTransform& parent) const;
+	[[nodiscard]] glm::mat4 emit_model_matrix(const RigidTransform& parent, const RigidTransform& joint) const;
+	[[nodiscard]] float velocity() const; // Signed angular speed around Z, 0 once the target is reached
+	[[nodiscard]] float position() const { return current_angle; }
+	void set_position(float f) { current_angle = target_angle = f; }
+	void add_tip_velocity(TipVelocityAccumulator& accumulator, const RigidTransform& joint) const;
+	[[nodiscard]] JacobianColumn get_jacobian_column(const RigidTransform& joint, glm::vec3 tip) const;
 };
 
 
 // Rotates radially
 struct Swivel
 {
+	static constexpr float JOINT_HEIGHT = 0.15f; // The joint frame sits on top of the swivel, half its height
 	float rotational_speed = 0.0f;
 	float angle = 0.0f;
 
-	void tick(float dt);
+	bool tick(float dt); // Returns whether the angle changed
 	[[nodiscard]] ModelMatrixChainOutput get_model_matrix(glm::mat4 joint_matrix) const;
+	[[nodiscard]] RigidTransform get_joint_transform(const RigidTransform& parent) const;
+	[[nodiscard]] glm::mat4 emit_model_matrix(const RigidTransform& parent, const RigidTransform& joint) const;
+	[[nodiscard]] float velocity() const { return rotational_speed; }
+	[[nodiscard]] float position() const { return angle; }
+	void set_position(float f) { angle = f; }
+	void add_tip_velocity(TipVelocityAccumulator& accumulator, const RigidTransform& joint) const;
+	[[nodiscard]] JacobianColumn get_jacobian_column(const RigidTransform& joint, glm::vec3 tip) const;
 };
 
 
@@ -54,8 +113,11 @@ struct Swivel
 struct Link
 {
 	float length;
-	void tick(float) {}
+	bool tick(float) { return false; }
 	[[nodiscard]] ModelMatrixChainOutput get_model_matrix(glm::mat4 joint_matrix) const;
+	[[nodiscard]] RigidTransform get_joint_transform(const RigidTransform& parent) const;
+	[[nodiscard]] glm::mat4 emit_model_matrix(const RigidTransform& parent, const RigidTransform& joint) const;
+	void add_tip_velocity(TipVelocityAccumulator&, const RigidTransform&) const {}
 
 };
 
@@ -65,37 +127,238 @@ class Component : public ComponentBase
 {
 public:
 	using ComponentBase::ComponentBase;
-	void tick(float dt);
+	bool tick(float dt);
 	[[nodiscard]] ModelMatrixChainOutput get_model_matrix(glm::mat4 joint_matrix) const;
+	[[nodiscard]] RigidTransform get_joint_transform(const RigidTransform& parent) const;
+	[[nodiscard]] glm::mat4 emit_model_matrix(const RigidTransform& parent, const RigidTransform& joint) const;
+	void add_tip_velocity(TipVelocityAccumulator& accumulator, const RigidTransform& joint) const;
+	// Whether the next tick can change anything, false exactly when the velocity is zero
+	[[nodiscard]] bool is_moving() const;
+	[[nodiscard]] float velocity() const; // Joint rate, always 0 for Links
+	// Motion of a unit joint rate at the joint itself, the Jacobian column with the joint as tip. Zero for Links
+	[[nodiscard]] JacobianColumn get_joint_axis(const RigidTransform& joint) const;
 };
 
 enum class ComponentType {Piston, Hinge, Swivel, Link};
 
+// World frame motion of the joint frame of one component, where the next component attaches
+struct SegmentMotion
+{
+	glm::vec3 position;
+	glm::vec3 linear_velocity;
+	glm::vec3 angular_velocity;
+	glm::vec3 linear_acceleration;
+	glm::vec3 angular_acceleration;
+};
+
 struct RenderData
 {
 	std::vector<std::pair<ComponentType, glm::mat4>> components;
 	glm::vec3 tip_pos;
 	glm::vec3 tip_vel;
+	std::vector<Clearance> clearances; // One per component, empty without an environment
+	std::vector<SegmentMotion> segment_motion; // One per component if asked for in RenderDataOptions
+};
+
+struct RenderDataOptions
+{
+	bool compute_tip_velocity = true; // tip_vel stays zero when disabled
+	bool compute_clearance	  = true; // Only does anything with an environment set
+	// Joints move at constant rates, so the accelerations are what the rotating parents add
+	bool compute_segment_motion = false;
+};
+
+// A component nothing is attached to, velocity is zero for everything at rest
+struct EndEffector
+{
+	ComponentHandle handle;
+	glm::vec3		position;
+	glm::vec3		velocity;
+};
+
+// Components tick() actually visited against the components of the arm, summed over every tick since the last reset
+struct TickStatistics
+{
+	std::uint64_t ticks				= 0;
+	std::uint64_t active_components = 0;
+	std::uint64_t total_components	= 0;
+
+	[[nodiscard]] double active_fraction() const;
 };
 
+class ThreadPool;
+
+// An arm is a tree of components. Every component attaches to the joint of its parent, which always comes before it,
+// and the storage is depth first so every subtree is one contiguous range. Forward kinematics stay a single pass in
+// storage order, and a serial chain is simply the tree where every parent is the component before.
 class Simulation
 {
-	std::vector<Component> m_components;
+public:
+	static constexpr std::uint32_t NO_PARENT = ~std::uint32_t{0}; // Attached to the base
+	// Dirty components from which a serial chain is worth splitting across threads, see set_chain_threads
+	static constexpr std::size_t PARALLEL_CHAIN_THRESHOLD = 8192;
+
+private:
+	std::vector<Component>	   m_components;
+	std::vector<std::uint32_t> m_parent;
+	// Beside the components rather than inside them, only inverse dynamics reads them
+	std::vector<MassProperties> m_mass_properties;
+	std::size_t				   m_branch_count = 0; // Components not attached to the one before them
+	// Forward kinematics cache of every joint transform, everything before m_first_dirty is still valid.
+	// Filled lazily by the const queries, so those must not run concurrently on the same Simulation
+	mutable std::vector<RigidTransform> m_joints;
+	mutable std::size_t					m_first_dirty = 0;
+	// Indices of the components that are moving in chain order, everything else is at rest and skipped by tick.
+	// Components enter through the set_* calls and leave on the tick they reach their target.
+	std::vector<std::uint32_t> m_active;
+	std::vector<std::uint8_t>  m_is_active;
+	std::vector<std::uint32_t> m_joint_column; // Jacobian column of every component, unused for Links
+	std::size_t				   m_joint_count = 0;
+	TickStatistics			   m_tick_statistics;
+	SlotMap					   m_handles; // Stable names for m_components, which stays in depth first order
+	mutable std::vector<TipVelocityAccumulator> m_path_velocities; // Scratch of get_end_effectors
+	glm::vec3									m_gravity{0.0f, -9.81f, 0.0f};
+	// World frame motion of every body and the loads it passes on to its parent, scratch of inverse_dynamics
+	struct BodyDynamics
+	{
+		SegmentMotion motion;
+		glm::vec3	  force;
+		glm::vec3	  moment; // About the joint origin
+	};
+	mutable std::vector<BodyDynamics> m_dynamics;
+	std::shared_ptr<const DistanceField>		m_environment;
+	// Every Simulation makes its own pool on the first update that needs one, a copy starts without. Sharing one would
+	// let two arms wait on the same pool from inside each other's loops
+	struct ChainPool
+	{
+		std::unique_ptr<ThreadPool> pool;
+
+		// Out of line where ThreadPool is complete, copies leave the pool behind
+		ChainPool();
+		ChainPool(const ChainPool&);
+		ChainPool(ChainPool&&) noexcept;
+		ChainPool& operator=(const ChainPool&);
+		ChainPool& operator=(ChainPool&&) noexcept;
+		~ChainPool();
+	};
+	mutable ChainPool					m_chain_pool;
+	std::size_t							m_chain_threads			   = 0; // 0 is one per core
+	std::size_t							m_parallel_chain_threshold = PARALLEL_CHAIN_THRESHOLD;
+	mutable std::vector<RigidTransform> m_block_starts; // Scratch of update_chain_parallel
+
+	void			mark_dirty(std::size_t idx);
+	void			update_chain() const;
+	ThreadPool*		chain_pool() const; // nullptr when the chain has to stay on the calling thread
+	void			update_chain_parallel(ThreadPool& pool) const;
+	void			activate(std::size_t idx);
+	void			rebuild_active_set();
+	ComponentHandle push_component(Component component);
+	ComponentHandle insert_component(std::size_t idx, std::uint32_t parent, Component component);
+	void			rebuild_topology(); // Joint columns, branch count and the active set after an insert or removal
+	std::size_t		index_of(ComponentHandle handle) const; // Throws for stale handles
+	// nullptr velocities means the current ones, nullptr accelerations means none
+	void run_inverse_dynamics(const float* velocities, const float* accelerations, std::span<float> efforts) const;
+
+	friend class ArmSnapshot; // Restores the whole state at once instead of going through add_* and set_*
+
 public:
 	void tick(float dt);
+	// Joint transform of every component in chain order, only recomputed from the first changed component
+	[[nodiscard]] std::span<const RigidTransform> get_chain() const;
 	[[nodiscard]] RenderData get_render_data() const;
+	// Writes into caller owned storage and reuses the capacity of out.components, so steady state frames don't allocate
+	void get_render_data(RenderData& out, RenderDataOptions options = {}) const;
 	[[nodiscard]] std::vector<ComponentType> get_component_types() const;
 
-	// Must be bounded between max_length and MIN_LENGTH
+	// Throws std::invalid_argument unless MIN_LENGTH <= f <= max_length
 	void set_piston_target_length(std::size_t idx, float f);
 	void set_hinge_target_angle(std::size_t idx, float f);
 	void set_swivel_rotation_speed(std::size_t idx, float f);
+	// Swivels have no target, this places them directly
+	void set_swivel_angle(std::size_t idx, float f);
+	// Whatever was attached to it moves up to its parent
 	void remove_component(std::size_t idx);
+	// Removes every component but keeps the capacity, gravity, environment and chain pool, for building many arms in a
+	// row
+	void clear();
+
+	// Same as above but addressed by handle, throw std::out_of_range once the component was removed
+	void set_piston_target_length(ComponentHandle handle, float f);
+	void set_hinge_target_angle(ComponentHandle handle, float f);
+	void set_swivel_rotation_speed(ComponentHandle handle, float f);
+	void set_swivel_angle(ComponentHandle handle, float f);
+	void remove_component(ComponentHandle handle);
+
+	// Attach to the last component in storage, which grows a serial chain
+	ComponentHandle add_piston(float max_length);
+	ComponentHandle add_hinge();
+	ComponentHandle add_swivel();
+	ComponentHandle add_link(float length);
+	// Attaches to the joint of parent, a null handle attaches to the base. The new component goes behind the subtree
+	// parent already has, so siblings keep the order they were attached in.
+	ComponentHandle attach(Component component, ComponentHandle parent);
+
+	// Parent index of every component, NO_PARENT for the ones on the base
+	[[nodiscard]] std::span<const std::uint32_t> get_parents() const { return m_parent; }
+	[[nodiscard]] bool							 is_serial() const { return m_branch_count == 0; }
+	// Position and velocity of every component nothing is attached to, in storage order, in one pass over the tree
+	void					 get_end_effectors(std::vector<EndEffector>& out) const;
+	[[nodiscard]] std::vector<EndEffector> get_end_effectors() const;
+
+	// Current chain position of a component, nullopt once it was removed
+	[[nodiscard]] std::optional<std::size_t> find(ComponentHandle handle) const { return m_handles.find(handle); }
+	[[nodiscard]] ComponentHandle			 get_handle(std::size_t idx) const { return m_handles.handle_at(idx); }
+	[[nodiscard]] const SlotMap&			 get_handles() const { return m_handles; }
+
+	[[nodiscard]] std::span<const Component> get_components() const;
+
+	// Static obstacles get_render_data reports the clearance of every component to. Shared because baking is
+	// expensive and copies of the arm (batches, reachability sampling) see the same scene, nullptr removes them
+	void set_environment(std::shared_ptr<const DistanceField> environment) { m_environment = std::move(environment); }
+	[[nodiscard]] const DistanceField* get_environment() const { return m_environment.get(); }
+	// Once at least threshold components of a serial chain need updating, the update runs as a blocked prefix scan on
+	// thread_count threads: every block composes its transforms on its own, the block totals are chained and every
+	// block is moved to where the blocks before it end. Matches the serial pass within float rounding. 0, the default,
+	// is one thread per core and 1 keeps everything on the calling thread. Inside a ThreadPool loop, e.g. ticked by a
+	// SimulationBatch, the chain is always updated serially since the cores are busy already.
+	void set_chain_threads(std::size_t thread_count, std::size_t threshold = PARALLEL_CHAIN_THRESHOLD);
+
+	// Pistons, Hinges and Swivels in chain order, Links don't have a degree of freedom
+	[[nodiscard]] std::size_t get_joint_count() const;
+	// Jacobian column of every component, unused for Links
+	[[nodiscard]] std::span<const std::uint32_t> get_joint_columns() const { return m_joint_column; }
+	// 6xN geometric Jacobian of the tip in one pass over the cached chain, jacobian needs get_joint_count() columns.
+	// The tip is the last component in storage, joints not on its path from the base get zero columns.
+	void get_jacobian(std::span<JacobianColumn> jacobian) const;
+	// Same for the end of component end_effector
+	void get_jacobian(std::span<JacobianColumn> jacobian, std::size_t end_effector) const;
+	// Current joint rates in the same order as the Jacobian columns
+	void get_joint_velocities(std::span<float> velocities) const;
+
+	// Hinge and Swivel torques and Piston forces in Jacobian column order that the joints need for the given rates
+	// and accelerations in the current pose, against gravity. Recursive Newton-Euler over the cached chain, one pass
+	// out from the base for the motion and one back for the loads, and nothing is allocated once warmed up.
+	void inverse_dynamics(std::span<const float> velocities, std::span<const float> accelerations,
+						  std::span<float> efforts) const;
+	// Same for the current joint velocities without acceleration, what the motors are holding right now
+	void get_joint_efforts(std::span<float> efforts) const;
+	void set_mass_properties(std::size_t idx, const MassProperties& properties);
+	void set_mass_properties(ComponentHandle handle, const MassProperties& properties);
+	[[nodiscard]] std::span<const MassProperties> get_mass_properties() const { return m_mass_properties; }
+	// World frame, the default pulls down the y axis
+	void					set_gravity(glm::vec3 gravity) { m_gravity = gravity; }
+	[[nodiscard]] glm::vec3 get_gravity() const { return m_gravity; }
+	// Piston lengths, Hinge and Swivel angles in Jacobian column order. Both throw std::invalid_argument unless there
+	// is exactly one position per joint
+	void get_joint_positions(std::span<float> positions) const;
+	// Places every joint directly and leaves it resting there, Swivels keep spinning at their speed
+	void set_joint_positions(std::span<const float> positions);
 
-	void add_piston(float max_length);
-	void add_hinge();
-	void add_swivel();
-	void add_link(float length);
+	// No component is moving, tick() does nothing and the chain stays cached
+	[[nodiscard]] bool		  is_at_rest() const { return m_active.empty(); }
+	[[nodiscard]] std::size_t get_active_count() const { return m_active.size(); }
+	[[nodiscard]] const TickStatistics& get_tick_statistics() const { return m_tick_statistics; }
+	void								reset_tick_statistics() { m_tick_statistics = {}; }
 };
 
 #endif // ROBOTARM_SIMULATION_HPP
@@ -0,0 +1,54 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_SIMULATIONBATCH_HPP
+#define ROBOTARM_SIMULATIONBATCH_HPP
+#include <cstdint>
+#include <RobotArm/Simulation/InverseKinematics.hpp>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <RobotArm/Simulation/ThreadPool.hpp>
+#include <span>
+#include <vector>
+
+struct BatchStatistics
+{
+	std::uint64_t arm_ticks	   = 0;
+	double		  tick_seconds = 0.0;
+
+	[[nodiscard]] double arm_ticks_per_second() const;
+};
+
+// Owns many independent arms and advances them on a work stealing pool.
+// Every arm is only ever touched by one thread per call and arms don't interact, so results are
+// identical no matter how many threads run the batch.
+class SimulationBatch
+{
+	std::vector<Simulation> m_simulations;
+	std::vector<RenderData> m_render_data; // Kept across calls so their buffers are reused
+	ThreadPool				m_pool;
+	BatchStatistics			m_statistics;
+
+	[[nodiscard]] std::size_t grain() const;
+
+public:
+	explicit SimulationBatch(std::size_t thread_count = std::thread::hardware_concurrency());
+
+	Simulation& add_simulation(Simulation simulation = {});
+	Simulation& get_simulation(std::size_t idx);
+	[[nodiscard]] std::size_t size() const;
+
+	// Ticks every arm steps times with a fixed dt
+	void tick(float dt, std::size_t steps = 1);
+	void compute_render_data();
+	// Indexed like the simulations, valid until the next compute_render_data
+	[[nodiscard]] std::span<const RenderData> get_render_data() const;
+
+	// Solves one tip target per arm and writes the joint targets into every arm, see IkSolver
+	void solve_ik(std::span<const glm::vec3> targets, std::span<IkResult> results, IkSettings settings = {});
+
+	[[nodiscard]] const BatchStatistics& get_statistics() const;
+	void reset_statistics();
+};
+
+#endif // ROBOTARM_SIMULATIONBATCH_HPP
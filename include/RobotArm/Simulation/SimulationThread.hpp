@@ -0,0 +1,140 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_SIMULATIONTHREAD_HPP
+#define ROBOTARM_SIMULATIONTHREAD_HPP
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <RobotArm/Simulation/CommandQueue.hpp>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <RobotArm/Simulation/TripleBuffer.hpp>
+#include <thread>
+#include <vector>
+
+// Render data of the last two fixed steps, so the reader can interpolate in between
+struct SimulationSnapshot
+{
+	RenderData							  previous;
+	RenderData							  current;
+	std::chrono::steady_clock::time_point time; // When current was produced
+};
+
+// One change to a running simulation. Components are named by handle, so commands stay valid while others are removed
+struct SimulationCommand
+{
+	enum class Type : std::uint8_t
+	{
+		SetPistonTargetLength,
+		SetHingeTargetAngle,
+		SetSwivelRotationSpeed,
+		SetSwivelAngle,
+		// Everything from here on changes the topology, handle is the one the new component gets or the removed one
+		AddPiston, // value is the max length
+		AddHinge,
+		AddSwivel,
+		AddLink, // value is the length
+		RemoveComponent
+	};
+
+	Type			type;
+	ComponentHandle handle;
+	float			value = 0.0f;
+
+	[[nodiscard]] bool changes_topology() const { return type >= Type::AddPiston; }
+	// False if handle was stale or a piston target out of range, nothing happened then
+	bool apply(Simulation& sim) const;
+};
+
+// Drops every set command that a later one to the same component overrides within batch, keeps the order otherwise.
+// Topology changes are always kept. Returns how many commands were dropped.
+std::size_t coalesce(std::vector<SimulationCommand>& batch);
+
+struct CommandStatistics
+{
+	std::size_t	  depth = 0; // Posted but not drained yet
+	std::size_t	  capacity	= 0;
+	std::uint64_t dropped	= 0; // Rejected because the queue was full
+	std::uint64_t applied	= 0;
+	std::uint64_t coalesced = 0; // Overridden by a later command in the same batch
+	std::uint64_t stale		= 0; // Addressed a component that was removed by then, or a piston target out of range
+};
+
+// Blends component matrices, tip data and segment motion, falls back to to when the arm changed shape in between
+void interpolate(const RenderData& from, const RenderData& to, float alpha, RenderData& out);
+
+// Runs a Simulation at a fixed rate on its own thread, independent of how often or how regularly frames are drawn.
+// Snapshots go through a lock free triple buffer and commands through a lock free queue, so rendering and the UI
+// never wait for the simulation and vice versa.
+// Without thread support (WASM without pthreads) the same fixed step loop is driven from get_render_data instead.
+class SimulationThread
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr double		 DEFAULT_TICK_RATE		= 240.0;
+	static constexpr double		 MAX_FRAME_TIME			= 0.25; // Caps catching up after a stall, avoids the spiral of death
+	static constexpr std::size_t DEFAULT_QUEUE_CAPACITY = 1024;
+
+	explicit SimulationThread(Simulation simulation = {}, double tick_rate = DEFAULT_TICK_RATE,
+							  std::size_t queue_capacity = DEFAULT_QUEUE_CAPACITY);
+	~SimulationThread();
+	SimulationThread(const SimulationThread&)			 = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+
+	void start();
+	void stop();
+	void set_tick_rate(double ticks_per_second);
+
+	// The only safe way to touch the simulation once started. Never blocks, returns false if the queue was full.
+	// Everything posted is drained in one batch before the next step. Set commands only, from any thread, but never
+	// while set_simulation runs
+	bool							post(SimulationCommand command);
+	[[nodiscard]] CommandStatistics get_command_statistics() const;
+
+	// Topology changes, from one thread only. Handles are allocated here exactly like the simulation will once the
+	// command runs, so they can be used right away. A null handle or false means the queue was full.
+	ComponentHandle add_piston(float max_length);
+	ComponentHandle add_hinge();
+	ComponentHandle add_swivel();
+	ComponentHandle add_link(float length);
+	bool			remove_component(ComponentHandle handle);
+	// Swaps in a whole arm as it is, state and handles included, e.g. a restored snapshot. Same thread as add_*,
+	// briefly stops the simulation thread. Commands still queued for the old arm are applied to it and then dropped.
+	// Other threads that post have to be done with the old arm before and take their handles from the new one after,
+	// an old handle would name whatever component of the new arm holds it. Overlapping post calls are asserted on
+	void set_simulation(Simulation simulation);
+
+	// Render thread side, interpolates between the last two steps so motion stays smooth at any frame rate
+	void get_render_data(RenderData& out, Clock::time_point now = Clock::now());
+	// Fill RenderData::segment_motion from the next step on, off by default. Any thread
+	void set_compute_segment_motion(bool enabled);
+
+private:
+	void run(std::stop_token stop_token);
+	void advance_to(Clock::time_point now);
+	void			apply_commands();
+	ComponentHandle post_add(SimulationCommand::Type type, float value = 0.0f);
+
+	Simulation						 m_simulation;
+	std::atomic<double>				 m_step_seconds;
+	std::atomic<bool>				 m_compute_segment_motion{false};
+	double							 m_accumulator = 0.0;
+	Clock::time_point				 m_last_advance;
+	RenderData						 m_previous; // Writer side copies of the last two steps
+	RenderData						 m_current;
+	TripleBuffer<SimulationSnapshot> m_snapshots;
+
+	CommandQueue<SimulationCommand> m_commands;
+	std::vector<SimulationCommand>	m_batch; // Only touched by the simulation side
+	std::atomic<std::uint64_t>		m_applied{0};
+	std::atomic<std::uint64_t>		m_coalesced{0};
+	std::atomic<std::uint64_t>		m_stale{0};
+	std::atomic<std::uint32_t>		m_posting{0}; // post calls in flight, only for the asserts in set_simulation
+	SlotMap							m_producer_handles; // Mirrors the handles of m_simulation as commands get posted
+
+	std::jthread m_thread;
+};
+
+#endif // ROBOTARM_SIMULATIONTHREAD_HPP
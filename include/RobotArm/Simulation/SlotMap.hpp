@@ -0,0 +1,68 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_SLOTMAP_HPP
+#define ROBOTARM_SLOTMAP_HPP
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Names one component for as long as it exists, unlike an index which shifts whenever something before it is removed
+struct ComponentHandle
+{
+	static constexpr std::uint32_t NULL_SLOT = ~std::uint32_t{0};
+
+	std::uint32_t slot		 = NULL_SLOT;
+	std::uint32_t generation = 0;
+
+	[[nodiscard]] bool is_null() const { return slot == NULL_SLOT; }
+	bool			   operator==(const ComponentHandle&) const = default;
+};
+
+// Generational handles for the elements of a dense array that keeps its order, the components in chain order.
+// Every handle names a slot that remembers where its element sits right now. Removing bumps the generation of the slot
+// so old handles stop resolving, and the slot goes on a free list for the next push_back.
+// Slots never move, only the positions stored in them do.
+class SlotMap
+{
+public:
+	struct Slot
+	{
+		std::uint32_t generation = 0;
+		std::uint32_t index		 = 0; // Position in the dense array, or the next free slot while unused
+	};
+
+private:
+	std::vector<Slot>		   m_slots;
+	std::vector<std::uint32_t> m_slot_of; // Dense position to slot
+	std::uint32_t			   m_free = ComponentHandle::NULL_SLOT;
+
+public:
+	// Handle of a new element appended to the dense array
+	ComponentHandle push_back();
+	// Handle of a new element inserted at index, everything from there on moves up by one
+	ComponentHandle insert_at(std::size_t index);
+	// What the next push_back will return
+	[[nodiscard]] ComponentHandle next_handle() const;
+	// Forgets the element at index, everything after it moves down by one
+	void erase_at(std::size_t index);
+	// Forgets every element, their handles go stale like after erase_at
+	void clear();
+
+	// Position of the element, nullopt for stale and null handles
+	[[nodiscard]] std::optional<std::size_t> find(ComponentHandle handle) const;
+	[[nodiscard]] bool						 contains(ComponentHandle handle) const { return find(handle).has_value(); }
+	[[nodiscard]] ComponentHandle			 handle_at(std::size_t index) const;
+	[[nodiscard]] std::size_t				 size() const { return m_slot_of.size(); }
+
+	// Raw state for snapshots, assign takes it back without checking it, slot_of is the slot of every element in order
+	[[nodiscard]] std::span<const Slot> get_slots() const { return m_slots; }
+	[[nodiscard]] std::span<const std::uint32_t> get_element_slots() const { return m_slot_of; }
+	[[nodiscard]] std::uint32_t			get_free_slot() const { return m_free; }
+	void assign(std::span<const Slot> slots, std::span<const std::uint32_t> slot_of, std::uint32_t free_slot);
+};
+
+#endif // ROBOTARM_SLOTMAP_HPP
@@ -0,0 +1,68 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_SOASIMULATION_HPP
+#define ROBOTARM_SOASIMULATION_HPP
+#include <cstdint>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <vector>
+
+// Same interface as Simulation but every component type keeps its state in its own contiguous arrays.
+// tick() becomes one tight loop per type instead of a std::visit per component, which is what
+// dominates headless runs of arms with hundreds of segments.
+class SoASimulation
+{
+	// Chain order lives in its own compact index, slot points into the arrays of the given type
+	struct ChainEntry
+	{
+		ComponentType type;
+		std::uint32_t slot;
+	};
+
+	struct PistonArrays
+	{
+		std::vector<float> current_length;
+		std::vector<float> target_length;
+		std::vector<float> max_length;
+	};
+
+	struct HingeArrays
+	{
+		std::vector<float> current_angle;
+		std::vector<float> target_angle;
+	};
+
+	struct SwivelArrays
+	{
+		std::vector<float> rotational_speed;
+		std::vector<float> angle;
+	};
+
+	std::vector<ChainEntry> m_chain;
+	PistonArrays			m_pistons;
+	HingeArrays				m_hinges;
+	SwivelArrays			m_swivels;
+	std::vector<float>		m_link_lengths;
+
+	[[nodiscard]] std::uint32_t slot_of(std::size_t idx, ComponentType type) const;
+
+public:
+	void tick(float dt);
+	[[nodiscard]] RenderData				 get_render_data() const;
+	void									 get_render_data(RenderData& out, RenderDataOptions options = {}) const;
+	[[nodiscard]] std::vector<ComponentType> get_component_types() const;
+
+	// Must be bounded between max_length and MIN_LENGTH
+	void set_piston_target_length(std::size_t idx, float f);
+	void set_hinge_target_angle(std::size_t idx, float f);
+	void set_swivel_rotation_speed(std::size_t idx, float f);
+	void remove_component(std::size_t idx);
+
+	void add_piston(float max_length);
+	void add_hinge();
+	void add_swivel();
+	void add_link(float length);
+};
+
+#endif // ROBOTARM_SOASIMULATION_HPP
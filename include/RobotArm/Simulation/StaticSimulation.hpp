@@ -0,0 +1,237 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_STATICSIMULATION_HPP
+#define ROBOTARM_STATICSIMULATION_HPP
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <class T>
+concept ArmComponent = std::same_as<T, Piston> || std::same_as<T, Hinge> || std::same_as<T, Swivel>
+					|| std::same_as<T, Link>;
+
+template <ArmComponent T>
+constexpr ComponentType component_type_v = std::same_as<T, Piston> ? ComponentType::Piston
+										 : std::same_as<T, Hinge>  ? ComponentType::Hinge
+										 : std::same_as<T, Swivel> ? ComponentType::Swivel
+																   : ComponentType::Link;
+
+// Queries shared by Simulation and every StaticSimulation, what the benchmarks and generic code can rely on.
+// Scene and SimulationThread still take a Simulation, they also add and remove components
+template <class S>
+concept SimulationQueries = requires(S sim, const S& const_sim, RenderData& out, std::size_t idx, float f) {
+	sim.tick(f);
+	{ const_sim.get_render_data() } -> std::same_as<RenderData>;
+	const_sim.get_render_data(out, RenderDataOptions{});
+	{ const_sim.get_component_types() } -> std::same_as<std::vector<ComponentType>>;
+	{ const_sim.get_chain() } -> std::convertible_to<std::span<const RigidTransform>>;
+	{ const_sim.get_joint_count() } -> std::convertible_to<std::size_t>;
+	sim.set_piston_target_length(idx, f);
+	sim.set_hinge_target_angle(idx, f);
+	sim.set_swivel_rotation_speed(idx, f);
+	sim.set_swivel_angle(idx, f);
+};
+
+// Arm with a topology fixed at compile time, e.g. StaticSimulation<Link, Hinge, Piston, Swivel, Link>.
+// Components live in a tuple and every loop over the chain is a fold expression, so there is no variant dispatch
+// and no heap. Components can't be added or removed, everything else behaves exactly like Simulation.
+template <ArmComponent... Components>
+	requires(sizeof...(Components) > 0)
+class StaticSimulation
+{
+public:
+	static constexpr std::size_t COMPONENT_COUNT = sizeof...(Components);
+	static constexpr std::size_t JOINT_COUNT	 = (std::size_t{0} + ... + !std::same_as<Components, Link>);
+	static constexpr std::array<ComponentType, COMPONENT_COUNT> COMPONENT_TYPES{component_type_v<Components>...};
+
+private:
+	using Indices = std::index_sequence_for<Components...>;
+
+	std::tuple<Components...> m_components;
+	// Same lazily filled cache as Simulation, everything before m_first_dirty is still valid
+	mutable std::array<RigidTransform, COMPONENT_COUNT> m_joints{};
+	mutable std::size_t									 m_first_dirty = 0;
+
+	void mark_dirty(std::size_t idx) { m_first_dirty = std::min(m_first_dirty, idx); }
+
+	template <std::size_t... I>
+	void tick_all(float dt, std::index_sequence<I...>)
+	{
+		auto tick_one = [&](auto& component, std::size_t idx)
+		{
+			if (component.tick(dt))
+				mark_dirty(idx);
+		};
+		(tick_one(std::get<I>(m_components), I), ...);
+	}
+
+	template <std::size_t... I>
+	void update_chain(std::index_sequence<I...>) const
+	{
+		// Every step is unrolled, the ones before the first dirty component are skipped at runtime
+		RigidTransform joint	  = m_first_dirty == 0 ? RigidTransform{} : m_joints[m_first_dirty - 1];
+		auto		   update_one = [&](const auto& component, std::size_t idx)
+		{
+			if (idx < m_first_dirty)
+				return;
+			joint		  = component.get_joint_transform(joint);
+			m_joints[idx] = joint;
+		};
+		(update_one(std::get<I>(m_components), I), ...);
+	}
+
+	void update_chain() const
+	{
+		if (m_first_dirty >= COMPONENT_COUNT)
+			return; // Nothing moved since the last evaluation
+		update_chain(Indices{});
+		m_first_dirty = COMPONENT_COUNT;
+	}
+
+	template <std::size_t... I>
+	void emit(RenderData& out, RenderDataOptions options, std::index_sequence<I...>) const
+	{
+		TipVelocityAccumulator velocity;
+		RigidTransform		   parent;
+		auto				   emit_one = [&](const auto& component, ComponentType type, const RigidTransform& joint)
+		{
+			out.components.emplace_back(type, component.emit_model_matrix(parent, joint));
+			parent = joint;
+			if (options.compute_tip_velocity)
+				component.add_tip_velocity(velocity, joint);
+		};
+		(emit_one(std::get<I>(m_components), COMPONENT_TYPES[I], m_joints[I]), ...);
+		out.tip_pos = parent.translation;
+		out.tip_vel = options.compute_tip_velocity ? velocity.velocity_at(out.tip_pos) : glm::vec3{0.0f};
+	}
+
+	// Runs f on component idx if it is a T, the runtime index is matched against every position of type T
+	template <class T, class F, std::size_t... I>
+	void with_component(std::size_t idx, F&& f, std::index_sequence<I...>)
+	{
+		if (idx >= COMPONENT_COUNT)
+			throw std::out_of_range("Component index out of range");
+		auto try_one = [&](auto& component, std::size_t position)
+		{
+			if constexpr (std::same_as<std::remove_cvref_t<decltype(component)>, T>)
+			{
+				if (position == idx)
+				{
+					f(component);
+					return true;
+				}
+			}
+			return false;
+		};
+		bool found = (try_one(std::get<I>(m_components), I) || ...);
+		if (!found)
+			throw std::invalid_argument("Component at index has a different type");
+	}
+
+	template <class T, class F>
+	void with_component(std::size_t idx, F&& f)
+	{
+		with_component<T>(idx, std::forward<F>(f), Indices{});
+	}
+
+public:
+	StaticSimulation() = default;
+	explicit StaticSimulation(Components... components)
+		: m_components(std::move(components)...)
+	{
+	}
+
+	void tick(float dt) { tick_all(dt, Indices{}); }
+
+	[[nodiscard]] std::span<const RigidTransform> get_chain() const
+	{
+		update_chain();
+		return m_joints;
+	}
+
+	[[nodiscard]] RenderData get_render_data() const
+	{
+		RenderData out;
+		get_render_data(out);
+		return out;
+	}
+	void get_render_data(RenderData& out, RenderDataOptions options = {}) const
+	{
+		out.components.clear();
+		out.components.reserve(COMPONENT_COUNT);
+		update_chain();
+		emit(out, options, Indices{});
+	}
+	[[nodiscard]] std::vector<ComponentType> get_component_types() const
+	{
+		return {COMPONENT_TYPES.begin(), COMPONENT_TYPES.end()};
+	}
+
+	// Throws std::invalid_argument unless MIN_LENGTH <= f <= max_length
+	void set_piston_target_length(std::size_t idx, float f)
+	{
+		with_component<Piston>(idx,
+							   [=](Piston& piston)
+							   {
+								   if (!(f >= Piston::MIN_LENGTH && f <= piston.max_length))
+									   throw std::invalid_argument("Piston target length out of range");
+								   piston.target_length = f;
+							   });
+	}
+	void set_hinge_target_angle(std::size_t idx, float f)
+	{
+		with_component<Hinge>(idx, [=](Hinge& hinge) { hinge.target_angle = f; });
+	}
+	void set_swivel_rotation_speed(std::size_t idx, float f)
+	{
+		with_component<Swivel>(idx, [=](Swivel& swivel) { swivel.rotational_speed = f; });
+	}
+	void set_swivel_angle(std::size_t idx, float f)
+	{
+		with_component<Swivel>(idx, [=](Swivel& swivel) { swivel.angle = f; });
+		mark_dirty(idx);
+	}
+
+	[[nodiscard]] const std::tuple<Components...>& get_components() const { return m_components; }
+
+	[[nodiscard]] static constexpr std::size_t get_joint_count() { return JOINT_COUNT; }
+	void get_jacobian(std::span<JacobianColumn> jacobian) const
+	{
+		update_chain();
+		glm::vec3	tip	   = m_joints.back().translation;
+		std::size_t column = 0;
+		auto		add	   = [&](const auto& component, const RigidTransform& joint)
+		{
+			if constexpr (requires { component.get_jacobian_column(joint, tip); })
+				jacobian[column++] = component.get_jacobian_column(joint, tip);
+		};
+		[&]<std::size_t... I>(std::index_sequence<I...>)
+		{ (add(std::get<I>(m_components), m_joints[I]), ...); }(Indices{});
+		assert(column == jacobian.size());
+	}
+	void get_joint_velocities(std::span<float> velocities) const
+	{
+		std::size_t joint = 0;
+		auto		add	  = [&](const auto& component)
+		{
+			if constexpr (requires { component.velocity(); })
+				velocities[joint++] = component.velocity();
+		};
+		std::apply([&](const auto&... components) { (add(components), ...); }, m_components);
+		assert(joint == velocities.size());
+	}
+};
+
+static_assert(SimulationQueries<Simulation>);
+static_assert(SimulationQueries<StaticSimulation<Link, Hinge, Piston, Swivel, Link>>);
+
+#endif // ROBOTARM_STATICSIMULATION_HPP
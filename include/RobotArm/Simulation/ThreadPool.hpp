@@ -0,0 +1,72 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_THREADPOOL_HPP
+#define ROBOTARM_THREADPOOL_HPP
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work stealing pool for data parallel loops.
+// parallel_for splits the range into chunks that are dealt round robin onto per thread deques, every thread pops
+// from the back of its own deque and steals from the front of the others once it runs dry.
+class ThreadPool
+{
+public:
+	using RangeTask = std::function<void(std::size_t begin, std::size_t end)>;
+
+	// thread_count includes the calling thread, so 1 runs everything inline
+	explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency());
+	~ThreadPool();
+	ThreadPool(const ThreadPool&)			 = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Runs body over [0, count) in chunks of at most grain elements and blocks until all of them ran.
+	// If body throws, the chunks not started yet are skipped and the first exception is rethrown here once every
+	// thread is out of body
+	// Called again from inside body the loop runs inline on that thread, waiting on the pool from inside itself would
+	// never return
+	void parallel_for(std::size_t count, std::size_t grain, const RangeTask& body);
+	[[nodiscard]] std::size_t thread_count() const;
+	// Whether the calling thread is running the body of a parallel_for of any pool
+	[[nodiscard]] static bool is_running_task();
+
+private:
+	struct Range
+	{
+		std::size_t begin;
+		std::size_t end;
+	};
+	struct WorkQueue
+	{
+		std::mutex		  mutex;
+		std::deque<Range> ranges;
+	};
+
+	bool try_pop(std::size_t queue, Range& out);
+	void run_until_done(std::size_t queue);
+	void worker_loop(std::size_t queue);
+
+	std::vector<std::unique_ptr<WorkQueue>> m_queues; // Last queue belongs to the caller of parallel_for
+	std::vector<std::jthread>				m_threads;
+	std::mutex								m_submit_mutex; // One parallel_for at a time
+	std::mutex								m_wake_mutex;
+	std::condition_variable					m_wake;
+	std::uint64_t							m_generation = 0;
+	bool									m_stopping	 = false;
+	const RangeTask*						m_body		 = nullptr;
+	std::atomic<std::size_t>				m_pending{0};
+	std::atomic<bool>						m_failed{false};
+	std::mutex								m_error_mutex;
+	std::exception_ptr						m_error; // First exception body threw in the current parallel_for
+};
+
+#endif // ROBOTARM_THREADPOOL_HPP
@@ -0,0 +1,115 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_TRAJECTORY_HPP
+#define ROBOTARM_TRAJECTORY_HPP
+#include <cstdint>
+#include <filesystem>
+#include <RobotArm/Simulation/MappedFile.hpp>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <vector>
+
+// Binary log of everything the arm did, one frame per tick: every joint position plus tip position and velocity.
+//
+// Values are quantized to fixed steps and stored as the zigzag varint residual of a linear prediction from the two
+// previous frames, so joints resting or moving at constant speed cost nothing. A bit mask per frame says which
+// residuals follow, runs of fully predicted frames collapse into a single count. Every keyframe_interval frames the
+// absolute values are written instead and indexed, which is where seeking starts decoding from.
+//
+// Layout: header, arm description, frame stream, keyframe index. Everything is little endian and read straight
+// from the mapping, opening a log only reads the header.
+
+struct TrajectorySettings
+{
+	float		  dt				  = 0.001f; // Simulated time between two record() calls
+	std::uint32_t keyframe_interval	  = 1000;	// Frames between two seek points, bounds the work of a seek
+	float		  position_resolution = 1e-5f;	// Quantization of joint positions and tip position
+	float		  velocity_resolution = 1e-4f;	// Quantization of the tip velocity
+};
+
+struct TrajectoryKeyframe
+{
+	std::uint64_t frame;
+	std::uint64_t offset; // Byte offset of the frame in the file
+};
+
+class TrajectoryRecorder
+{
+	MappedFile						m_file;
+	TrajectorySettings				m_settings;
+	std::size_t						m_component_count;
+	std::size_t						m_joint_count;
+	std::size_t						m_write_offset;
+	std::uint64_t					m_frame_count = 0;
+	std::uint64_t					m_zero_run	  = 0; // Fully predicted frames not written yet
+	bool							m_finished	  = false;
+	std::vector<TrajectoryKeyframe> m_index;
+	// Per value history of quantized values, the prediction is 2 * previous - before_previous
+	std::vector<std::int64_t> m_previous;
+	std::vector<std::int64_t> m_before_previous;
+	std::vector<std::int64_t> m_residuals;
+	std::vector<float>		  m_values;
+	std::vector<float>		  m_inverse_resolution;
+
+	void reserve(std::size_t bytes);
+	void flush_zero_run();
+
+public:
+	// The arm description is taken from sim, which must keep its topology for the whole recording
+	TrajectoryRecorder(const std::filesystem::path& path, const Simulation& sim, TrajectorySettings settings = {});
+	~TrajectoryRecorder();
+	TrajectoryRecorder(const TrajectoryRecorder&)			 = delete;
+	TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+	// Call once per tick, doesn't allocate once the file has grown large enough
+	void record(const Simulation& sim);
+	// Writes the index and header and trims the file, a log can't be read before this ran
+	void finish();
+
+	[[nodiscard]] std::uint64_t frame_count() const { return m_frame_count; }
+	[[nodiscard]] std::size_t	bytes_written() const { return m_write_offset; }
+};
+
+class TrajectoryPlayer
+{
+	MappedFile			 m_file;
+	TrajectorySettings	 m_settings;
+	std::uint64_t		 m_frame_count	  = 0;
+	std::uint64_t		 m_keyframe_count = 0;
+	std::size_t			 m_index_offset	  = 0;
+	std::size_t			 m_joint_count	  = 0;
+	Simulation			 m_arm;
+	// Decoder state, m_frame is the frame currently held in m_previous
+	std::uint64_t			  m_frame		= 0;
+	std::size_t				  m_read_offset = 0;
+	std::uint64_t			  m_zero_run	= 0;
+	bool					  m_valid		= false;
+	std::vector<std::int64_t> m_previous;
+	std::vector<std::int64_t> m_before_previous;
+	std::vector<float>		  m_values;
+
+	[[nodiscard]] TrajectoryKeyframe keyframe(std::uint64_t i) const;
+	void							 decode_keyframe(const TrajectoryKeyframe& keyframe);
+	void							 decode_next();
+
+public:
+	explicit TrajectoryPlayer(const std::filesystem::path& path);
+
+	[[nodiscard]] std::uint64_t				frame_count() const { return m_frame_count; }
+	[[nodiscard]] const TrajectorySettings& settings() const { return m_settings; }
+	[[nodiscard]] double					duration() const;
+
+	// Binary search over the keyframe index, then decodes forward. Playing forward continues from the current frame
+	void seek_frame(std::uint64_t frame);
+	void seek(double time);
+
+	// Arm placed at the current frame, Swivels are at their recorded angle but don't spin
+	[[nodiscard]] const Simulation& get_simulation() const { return m_arm; }
+	[[nodiscard]] glm::vec3			tip_position() const;
+	[[nodiscard]] glm::vec3			tip_velocity() const;
+	// Seeks to time and fills out like Simulation::get_render_data, with the recorded tip data
+	void get_render_data(RenderData& out, double time);
+};
+
+#endif // ROBOTARM_TRAJECTORY_HPP
@@ -0,0 +1,41 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#ifndef ROBOTARM_TRIPLEBUFFER_HPP
+#define ROBOTARM_TRIPLEBUFFER_HPP
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock free single producer single consumer hand over of the latest value.
+// The writer fills its back buffer and swaps it with the shared middle one, the reader swaps the middle one with its
+// front buffer whenever something new was published. Neither side ever waits, the reader just skips stale values.
+template <class T>
+class TripleBuffer
+{
+	static constexpr std::uint8_t INDEX_MASK = 0b011;
+	static constexpr std::uint8_t FRESH		 = 0b100;
+
+	std::array<T, 3>		  m_buffers{};
+	std::atomic<std::uint8_t> m_middle{1}; // Index of the shared buffer plus FRESH if the reader hasn't seen it
+	std::uint8_t			  m_back  = 0; // Only touched by the writer
+	std::uint8_t			  m_front = 2; // Only touched by the reader
+
+public:
+	// Writer side
+	T& write_buffer() { return m_buffers[m_back]; }
+	void publish() { m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK; }
+
+	// Reader side, returns whether read_buffer changed
+	bool update()
+	{
+		if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+			return false;
+		m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+	const T& read_buffer() const { return m_buffers[m_front]; }
+};
+
+#endif // ROBOTARM_TRIPLEBUFFER_HPP
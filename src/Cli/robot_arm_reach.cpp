@@ -0,0 +1,151 @@
+//
+// Created by chris on 10/18/26.
+//
+// Samples the joint space of an arm on every core and writes the reachable tip positions as a sparse voxel map,
+// see ReachabilityMap.hpp. The map is used straight from the file afterwards, so this only runs once per arm.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <print>
+#include <RobotArm/Simulation/ArmScript.hpp>
+#include <RobotArm/Simulation/ReachabilityMap.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+struct Options
+{
+	std::filesystem::path arm_path;
+	std::filesystem::path output_path;
+	ReachabilitySettings  settings;
+};
+
+void print_usage()
+{
+	std::println(stderr, "usage: robot_arm_reach <arm file> <out.rmap> [--samples count] [--voxel-size meters]\n"
+						 "                       [--random] [--seed number] [--threads count]");
+}
+
+float parse_float(std::string_view flag, const char* value)
+{
+	char* end	 = nullptr;
+	float result = std::strtof(value, &end);
+	if (end == value || *end != '\0' || !(result > 0.0f))
+		throw std::invalid_argument(std::string(flag) + " expects a positive number");
+	return result;
+}
+
+std::uint64_t parse_count(std::string_view flag, const char* value)
+{
+	char* end	 = nullptr;
+	auto  result = std::strtoull(value, &end, 10);
+	if (end == value || *end != '\0' || result == 0)
+		throw std::invalid_argument(std::string(flag) + " expects a positive integer");
+	return result;
+}
+
+Options parse_options(int argc, char* argv[])
+{
+	Options options;
+	int		positional = 0;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view arg = argv[i];
+		if (arg == "--random")
+			options.settings.sampling = ReachabilitySampling::Random;
+		else if (arg.starts_with("--"))
+		{
+			if (i + 1 >= argc)
+				throw std::invalid_argument(std::string(arg) + " expects a value");
+			const char* value = argv[++i];
+			if (arg == "--samples")
+				options.settings.samples = parse_count(arg, value);
+			else if (arg == "--voxel-size")
+				options.settings.voxel_size = parse_float(arg, value);
+			else if (arg == "--seed")
+				options.settings.seed = parse_count(arg, value);
+			else if (arg == "--threads")
+				options.settings.thread_count = parse_count(arg, value);
+			else
+				throw std::invalid_argument("unknown option " + std::string(arg));
+		}
+		else if (positional == 0)
+		{
+			options.arm_path = arg;
+			++positional;
+		}
+		else if (positional == 1)
+		{
+			options.output_path = arg;
+			++positional;
+		}
+		else
+			throw std::invalid_argument("unexpected argument " + std::string(arg));
+	}
+	if (positional != 2)
+		throw std::invalid_argument("an arm file and an output file are required");
+	return options;
+}
+
+Simulation load_arm(const std::filesystem::path& path)
+{
+	std::ifstream in(path);
+	if (!in)
+		throw std::runtime_error("could not open " + path.string());
+	try
+	{
+		return parse_arm_description(in);
+	}
+	catch (const std::runtime_error& error)
+	{
+		throw std::runtime_error(path.string() + ": " + error.what());
+	}
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	try
+	{
+		options = parse_options(argc, argv);
+	}
+	catch (const std::invalid_argument& error)
+	{
+		std::println(stderr, "robot_arm_reach: {}", error.what());
+		print_usage();
+		return 2;
+	}
+
+	try
+	{
+		auto sim   = load_arm(options.arm_path);
+		auto start = std::chrono::steady_clock::now();
+		auto map   = ReachabilityMap::generate(sim, options.settings);
+		auto wall  = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		map.save(options.output_path);
+
+		float best = 0.0f;
+		for (const auto& voxel : map.voxels())
+			best = std::max(best, voxel.max_manipulability);
+		double voxel_volume = std::pow(static_cast<double>(map.voxel_size()), 3.0);
+		std::println("samples:             {}", map.sample_count());
+		std::println("occupied voxels:     {}", map.voxels().size());
+		std::println("reachable volume:    {:.3f} m^3", static_cast<double>(map.voxels().size()) * voxel_volume);
+		std::println("best manipulability: {:.4f}", best);
+		std::println("wall seconds:        {:.3f}", wall);
+		std::println("samples per second:  {:.0f}", static_cast<double>(map.sample_count()) / wall);
+		return 0;
+	}
+	catch (const std::exception& error)
+	{
+		std::println(stderr, "robot_arm_reach: {}", error.what());
+		return 1;
+	}
+}
@@ -0,0 +1,295 @@
+//
+// Created by chris on 10/18/26.
+//
+// Headless runner: loads an arm and a command script, runs it as fast as possible and reports the tip trajectory
+// and timing. Meant for regression and throughput jobs on machines without a display.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <RobotArm/Simulation/ArmScript.hpp>
+#include <RobotArm/Simulation/InverseKinematics.hpp>
+#include <RobotArm/Simulation/SelfCollision.hpp>
+#include <RobotArm/Simulation/Trajectory.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+	std::filesystem::path				 arm_path;
+	std::filesystem::path				 script_path;
+	std::optional<std::filesystem::path> trajectory_path;
+	std::optional<std::filesystem::path> record_path; // Binary log of every tick, see Trajectory.hpp
+	float								 dt				 = 1.0f / 240.0f;
+	std::optional<float>				 duration;			   // Defaults to one second past the last command
+	float								 sample_interval = 0.01f; // Seconds of simulated time between trajectory rows
+	bool								 self_collision	 = false; // Check for self collision after every tick
+};
+
+struct RunStatistics
+{
+	std::size_t ticks			  = 0;
+	std::size_t ik_solves		  = 0;
+	std::size_t ik_failures		  = 0;
+	double		simulated_seconds = 0.0;
+	double		wall_seconds	  = 0.0;
+	double		ik_seconds		  = 0.0;
+	std::size_t collision_ticks	  = 0; // Ticks ending with the arm passing through itself
+	double		collision_seconds = 0.0;
+};
+
+void print_usage()
+{
+	std::println(stderr,
+				 "usage: robot_arm_sim <arm file> <script file> [--dt seconds] [--duration seconds]\n"
+				 "                     [--trajectory out.csv] [--sample-interval seconds] [--record out.rtraj]\n"
+				 "                     [--self-collision]");
+}
+
+float parse_float(std::string_view flag, const char* value)
+{
+	char* end	 = nullptr;
+	float result = std::strtof(value, &end);
+	if (end == value || *end != '\0' || !(result > 0.0f))
+		throw std::invalid_argument(std::string(flag) + " expects a positive number");
+	return result;
+}
+
+Options parse_options(int argc, char* argv[])
+{
+	Options options;
+	int		positional = 0;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view arg = argv[i];
+		if (arg == "--self-collision")
+			options.self_collision = true;
+		else if (arg.starts_with("--"))
+		{
+			if (i + 1 >= argc)
+				throw std::invalid_argument(std::string(arg) + " expects a value");
+			const char* value = argv[++i];
+			if (arg == "--dt")
+				options.dt = parse_float(arg, value);
+			else if (arg == "--duration")
+				options.duration = parse_float(arg, value);
+			else if (arg == "--trajectory")
+				options.trajectory_path = value;
+			else if (arg == "--record")
+				options.record_path = value;
+			else if (arg == "--sample-interval")
+				options.sample_interval = parse_float(arg, value);
+			else
+				throw std::invalid_argument("unknown option " + std::string(arg));
+		}
+		else if (positional == 0)
+		{
+			options.arm_path = arg;
+			++positional;
+		}
+		else if (positional == 1)
+		{
+			options.script_path = arg;
+			++positional;
+		}
+		else
+			throw std::invalid_argument("unexpected argument " + std::string(arg));
+	}
+	if (positional != 2)
+		throw std::invalid_argument("an arm file and a script file are required");
+	return options;
+}
+
+// Prefixes parse errors with the file they came from
+template <class Parser>
+auto parse_file(const std::filesystem::path& path, Parser parse)
+{
+	std::ifstream in(path);
+	if (!in)
+		throw std::runtime_error("could not open " + path.string());
+	try
+	{
+		return parse(in);
+	}
+	catch (const std::runtime_error& error)
+	{
+		throw std::runtime_error(path.string() + ": " + error.what());
+	}
+}
+
+void apply(const ScriptCommand& command, Simulation& sim, IkSolver& solver, RunStatistics& statistics)
+{
+	switch (command.type)
+	{
+		case ScriptCommandType::PistonTarget: sim.set_piston_target_length(command.index, command.value); break;
+		case ScriptCommandType::HingeTarget: sim.set_hinge_target_angle(command.index, command.value); break;
+		case ScriptCommandType::SwivelSpeed: sim.set_swivel_rotation_speed(command.index, command.value); break;
+		case ScriptCommandType::SwivelAngle: sim.set_swivel_angle(command.index, command.value); break;
+		case ScriptCommandType::Reach:
+		{
+			auto start	= Clock::now();
+			auto result = solver.solve(sim, command.target);
+			statistics.ik_seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			++statistics.ik_solves;
+			if (!result.converged)
+			{
+				++statistics.ik_failures;
+				std::println(stderr, "t={:.4f}: reach ({}, {}, {}) did not converge, {:.4f} away", command.time,
+							 command.target.x, command.target.y, command.target.z, result.error);
+			}
+			break;
+		}
+	}
+}
+
+void write_sample(std::ofstream& out, double time, const RenderData& data)
+{
+	out << std::format("{:.6f},{:.6f},{:.6f},{:.6f},{:.6f},{:.6f},{:.6f}\n", time, data.tip_pos.x, data.tip_pos.y,
+					   data.tip_pos.z, data.tip_vel.x, data.tip_vel.y, data.tip_vel.z);
+}
+
+RunStatistics run(const Options& options, Simulation& sim, const std::vector<ScriptCommand>& commands)
+{
+	float duration = options.duration.value_or(commands.empty() ? 1.0f : commands.back().time + 1.0f);
+	auto  steps	   = static_cast<std::size_t>(std::ceil(duration / options.dt));
+
+	std::ofstream trajectory;
+	if (options.trajectory_path)
+	{
+		trajectory.open(*options.trajectory_path);
+		if (!trajectory)
+			throw std::runtime_error("could not write " + options.trajectory_path->string());
+		trajectory << "time,tip_x,tip_y,tip_z,vel_x,vel_y,vel_z\n";
+	}
+
+	std::optional<TrajectoryRecorder> recorder;
+	if (options.record_path)
+		recorder.emplace(*options.record_path, sim, TrajectorySettings{.dt = options.dt});
+
+	RunStatistics		  statistics;
+	IkSolver			  solver;
+	SelfCollisionDetector collision;
+	bool				  was_colliding = false;
+	RenderData	  render_data;
+	std::size_t	  next_command = 0;
+	double		  next_sample  = 0.0;
+
+	auto start = Clock::now();
+	for (std::size_t step = 0; step <= steps; ++step)
+	{
+		double time = static_cast<double>(step) * options.dt;
+		for (; next_command < commands.size() && commands[next_command].time <= time; ++next_command)
+		{
+			try
+			{
+				apply(commands[next_command], sim, solver, statistics);
+			}
+			catch (const std::exception& error)
+			{
+				// Indices pointing at the wrong kind of component and piston targets out of range
+				throw std::runtime_error(
+					std::format("command at t={} failed: {}", commands[next_command].time, error.what()));
+			}
+		}
+
+		if (trajectory.is_open() && (time >= next_sample || step == steps))
+		{
+			sim.get_render_data(render_data);
+			write_sample(trajectory, time, render_data);
+			next_sample += options.sample_interval;
+		}
+		if (recorder)
+			recorder->record(sim);
+		if (step == steps)
+			break;
+		sim.tick(options.dt);
+		++statistics.ticks;
+		if (options.self_collision)
+		{
+			auto check	  = Clock::now();
+			auto contacts = collision.detect(sim);
+			statistics.collision_seconds += std::chrono::duration<double>(Clock::now() - check).count();
+			statistics.collision_ticks += !contacts.empty();
+			if (!contacts.empty() && !was_colliding)
+			{
+				const auto& deepest = *std::ranges::max_element(contacts, {}, &SelfContact::depth);
+				std::println(stderr, "t={:.4f}: components {} and {} collide, {} contacts, {:.4f} deep",
+							 time + options.dt, deepest.first, deepest.second, contacts.size(), deepest.depth);
+			}
+			was_colliding = !contacts.empty();
+		}
+	}
+	statistics.wall_seconds		 = std::chrono::duration<double>(Clock::now() - start).count();
+	if (recorder)
+		recorder->finish();
+	statistics.simulated_seconds = static_cast<double>(statistics.ticks) * options.dt;
+	return statistics;
+}
+
+void print_statistics(const RunStatistics& statistics, const Simulation& sim)
+{
+	auto tip = sim.get_render_data().tip_pos;
+	std::println("ticks:             {}", statistics.ticks);
+	std::println("simulated seconds: {:.3f}", statistics.simulated_seconds);
+	std::println("wall seconds:      {:.6f}", statistics.wall_seconds);
+	std::println("ticks per second:  {:.0f}", static_cast<double>(statistics.ticks) / statistics.wall_seconds);
+	std::println("real time factor:  {:.1f}x", statistics.simulated_seconds / statistics.wall_seconds);
+	std::println("ik solves:         {} ({} failed, {:.3f} ms total)", statistics.ik_solves, statistics.ik_failures,
+				 statistics.ik_seconds * 1000.0);
+	std::println("final tip:         {:.6f} {:.6f} {:.6f}", tip.x, tip.y, tip.z);
+	const auto& ticks		   = sim.get_tick_statistics();
+	double		active_per_tick = static_cast<double>(ticks.active_components)
+							 / static_cast<double>(std::max<std::uint64_t>(ticks.ticks, 1));
+	std::println("active components: {:.1f} of {} per tick", active_per_tick, sim.get_components().size());
+}
+
+void print_collision_statistics(const RunStatistics& statistics)
+{
+	std::println("colliding ticks:   {}", statistics.collision_ticks);
+	std::println("collision checks:  {:.3f} ms total, {:.2f} us per tick", statistics.collision_seconds * 1000.0,
+				 statistics.collision_seconds * 1e6 / static_cast<double>(std::max<std::size_t>(statistics.ticks, 1)));
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	try
+	{
+		options = parse_options(argc, argv);
+	}
+	catch (const std::invalid_argument& error)
+	{
+		std::println(stderr, "robot_arm_sim: {}", error.what());
+		print_usage();
+		return 2;
+	}
+
+	try
+	{
+		auto sim	  = parse_file(options.arm_path, parse_arm_description);
+		auto commands = parse_file(options.script_path, parse_command_script);
+
+		auto statistics = run(options, sim, commands);
+		print_statistics(statistics, sim);
+		if (options.self_collision)
+			print_collision_statistics(statistics);
+		return statistics.ik_failures == 0 && statistics.collision_ticks == 0 ? 0 : 1;
+	}
+	catch (const std::exception& error)
+	{
+		std::println(stderr, "robot_arm_sim: {}", error.what());
+		return 1;
+	}
+}
@@ -36,6 +36,7 @@ void GLWindow::initializeGL()
 	// m_frame_timer.start();
 
 	emit initialized();
+	m_scene.get_simulation().start();
 }
 
 void GLWindow::resizeGL(int w, int h)
@@ -53,7 +54,7 @@ void GLWindow::paintGL()
 		qInfo() << (1.0f / (duration / 1000.0f)) << "FPS\n";
 	}
 	m_last_time = time;
-	m_scene.get_simulation().tick(duration / 1000.f);
+	// The simulation steps on its own thread, the frame only picks up the latest state
 	m_scene.submit_to(m_render_queue);
 	m_renderer->render(m_render_queue, m_scene.get_camera());
 	m_render_queue.clear();
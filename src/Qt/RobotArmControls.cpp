@@ -7,9 +7,9 @@
 // ============================================================================
 // PistonWidget - Extends/retracts between MIN_LENGTH and max_length
 // ============================================================================
-PistonWidget::PistonWidget(std::size_t index, float maxLength, QWidget* parent)
+PistonWidget::PistonWidget(ComponentHandle handle, float maxLength, float targetLength, QWidget* parent)
     : QWidget(parent)
-    , m_index(index)
+    , m_handle(handle)
     , m_maxLength(maxLength)
 {
     auto* layout = new QVBoxLayout(this);
@@ -17,12 +17,12 @@ PistonWidget::PistonWidget(std::size_t index, float maxLength, QWidget* parent)
 
     // Header with title and remove button
     auto* header = new QHBoxLayout();
-    m_titleLabel = new QLabel(QString("Piston %1").arg(index));
-    m_titleLabel->setStyleSheet("font-weight: bold; color: #7ae664;");
+    auto* titleLabel = new QLabel(QString("Piston %1").arg(handle.slot));
+    titleLabel->setStyleSheet("font-weight: bold; color: #7ae664;");
     auto* removeBtn = new QPushButton("×");
     removeBtn->setFixedSize(20, 20);
     removeBtn->setStyleSheet("color: red; font-weight: bold;");
-    header->addWidget(m_titleLabel);
+    header->addWidget(titleLabel);
     header->addStretch();
     header->addWidget(removeBtn);
     layout->addLayout(header);
@@ -41,8 +41,8 @@ PistonWidget::PistonWidget(std::size_t index, float maxLength, QWidget* parent)
     lengthLayout->addWidget(new QLabel("Target:"));
     m_lengthSlider = new QSlider(Qt::Horizontal);
     m_lengthSlider->setRange(100, static_cast<int>(maxLength * 100)); // 1.0 to maxLength in 0.01 steps
-    m_lengthSlider->setValue(100); // Start at MIN_LENGTH
-    m_lengthLabel = new QLabel("1.00");
+    m_lengthSlider->setValue(static_cast<int>(targetLength * 100)); // MIN_LENGTH for new pistons
+    m_lengthLabel = new QLabel(QString::number(targetLength, 'f', 2));
     m_lengthLabel->setFixedWidth(40);
     lengthLayout->addWidget(m_lengthSlider);
     lengthLayout->addWidget(m_lengthLabel);
@@ -52,40 +52,34 @@ PistonWidget::PistonWidget(std::size_t index, float maxLength, QWidget* parent)
     connect(m_lengthSlider, &QSlider::valueChanged, this, [this](int value) {
         float length = value / 100.0f;
         m_lengthLabel->setText(QString::number(length, 'f', 2));
-        emit targetLengthChanged(m_index, length);
+        emit targetLengthChanged(m_handle, length);
     });
 
     connect(removeBtn, &QPushButton::clicked, this, [this]() {
-        emit removeRequested(m_index);
+        emit removeRequested(m_handle);
     });
 
     setStyleSheet("PistonWidget { border: 1px solid #7ae664; border-radius: 4px; }");
 }
 
-void PistonWidget::setIndex(std::size_t index)
-{
-    m_index = index;
-    m_titleLabel->setText(QString("Piston %1").arg(index));
-}
-
 // ============================================================================
 // HingeWidget - Rotates on Z-axis
 // ============================================================================
-HingeWidget::HingeWidget(std::size_t index, float initialAngle, QWidget* parent)
+HingeWidget::HingeWidget(ComponentHandle handle, float initialAngle, QWidget* parent)
     : QWidget(parent)
-    , m_index(index)
+    , m_handle(handle)
 {
     auto* layout = new QVBoxLayout(this);
     layout->setContentsMargins(5, 5, 5, 5);
 
     // Header with title and remove button
     auto* header = new QHBoxLayout();
-    m_titleLabel = new QLabel(QString("Hinge %1").arg(index));
-    m_titleLabel->setStyleSheet("font-weight: bold; color: #cc241d;");
+    auto* titleLabel = new QLabel(QString("Hinge %1").arg(handle.slot));
+    titleLabel->setStyleSheet("font-weight: bold; color: #cc241d;");
     auto* removeBtn = new QPushButton("×");
     removeBtn->setFixedSize(20, 20);
     removeBtn->setStyleSheet("color: red; font-weight: bold;");
-    header->addWidget(m_titleLabel);
+    header->addWidget(titleLabel);
     header->addStretch();
     header->addWidget(removeBtn);
     layout->addLayout(header);
@@ -106,40 +100,34 @@ HingeWidget::HingeWidget(std::size_t index, float initialAngle, QWidget* parent)
     connect(m_angleSlider, &QSlider::valueChanged, this, [this](int value) {
         float angle = value / 100.0f;
         m_angleLabel->setText(QString::number(angle, 'f', 2));
-        emit targetAngleChanged(m_index, angle);
+        emit targetAngleChanged(m_handle, angle);
     });
 
     connect(removeBtn, &QPushButton::clicked, this, [this]() {
-        emit removeRequested(m_index);
+        emit removeRequested(m_handle);
     });
 
     setStyleSheet("HingeWidget { border: 1px solid #cc241d; border-radius: 4px; }");
 }
 
-void HingeWidget::setIndex(std::size_t index)
-{
-    m_index = index;
-    m_titleLabel->setText(QString("Hinge %1").arg(index));
-}
-
 // ============================================================================
 // SwivelWidget - Rotates on Y-axis
 // ============================================================================
-SwivelWidget::SwivelWidget(std::size_t index, float initialSpeed, QWidget* parent)
+SwivelWidget::SwivelWidget(ComponentHandle handle, float initialSpeed, QWidget* parent)
     : QWidget(parent)
-    , m_index(index)
+    , m_handle(handle)
 {
     auto* layout = new QVBoxLayout(this);
     layout->setContentsMargins(5, 5, 5, 5);
 
     // Header with title and remove button
     auto* header = new QHBoxLayout();
-    m_titleLabel = new QLabel(QString("Swivel %1").arg(index));
-    m_titleLabel->setStyleSheet("font-weight: bold; color: #d79921;");
+    auto* titleLabel = new QLabel(QString("Swivel %1").arg(handle.slot));
+    titleLabel->setStyleSheet("font-weight: bold; color: #d79921;");
     auto* removeBtn = new QPushButton("×");
     removeBtn->setFixedSize(20, 20);
     removeBtn->setStyleSheet("color: red; font-weight: bold;");
-    header->addWidget(m_titleLabel);
+    header->addWidget(titleLabel);
     header->addStretch();
     header->addWidget(removeBtn);
     layout->addLayout(header);
@@ -156,40 +144,34 @@ SwivelWidget::SwivelWidget(std::size_t index, float initialSpeed, QWidget* paren
 
     // Connections
     connect(m_speedSpinBox, &QDoubleSpinBox::valueChanged, this, [this](double value) {
-        emit rotationalSpeedChanged(m_index, static_cast<float>(value));
+        emit rotationalSpeedChanged(m_handle, static_cast<float>(value));
     });
 
     connect(removeBtn, &QPushButton::clicked, this, [this]() {
-        emit removeRequested(m_index);
+        emit removeRequested(m_handle);
     });
 
     setStyleSheet("SwivelWidget { border: 1px solid #d79921; border-radius: 4px; }");
 }
 
-void SwivelWidget::setIndex(std::size_t index)
-{
-    m_index = index;
-    m_titleLabel->setText(QString("Swivel %1").arg(index));
-}
-
 // ============================================================================
 // LinkWidget - Fixed length, no controls
 // ============================================================================
-LinkWidget::LinkWidget(std::size_t index, float length, QWidget* parent)
+LinkWidget::LinkWidget(ComponentHandle handle, float length, QWidget* parent)
     : QWidget(parent)
-    , m_index(index)
+    , m_handle(handle)
 {
     auto* layout = new QVBoxLayout(this);
     layout->setContentsMargins(5, 5, 5, 5);
 
     // Header with title and remove button
     auto* header = new QHBoxLayout();
-    m_titleLabel = new QLabel(QString("Link %1").arg(index));
-    m_titleLabel->setStyleSheet("font-weight: bold; color: #7a7a7a;");
+    auto* titleLabel = new QLabel(QString("Link %1").arg(handle.slot));
+    titleLabel->setStyleSheet("font-weight: bold; color: #7a7a7a;");
     auto* removeBtn = new QPushButton("×");
     removeBtn->setFixedSize(20, 20);
     removeBtn->setStyleSheet("color: red; font-weight: bold;");
-    header->addWidget(m_titleLabel);
+    header->addWidget(titleLabel);
     header->addStretch();
     header->addWidget(removeBtn);
     layout->addLayout(header);
@@ -205,18 +187,12 @@ LinkWidget::LinkWidget(std::size_t index, float length, QWidget* parent)
 
     // Connections
     connect(removeBtn, &QPushButton::clicked, this, [this]() {
-        emit removeRequested(m_index);
+        emit removeRequested(m_handle);
     });
 
     setStyleSheet("LinkWidget { border: 1px solid #7a7a7a; border-radius: 4px; }");
 }
 
-void LinkWidget::setIndex(std::size_t index)
-{
-    m_index = index;
-    m_titleLabel->setText(QString("Link %1").arg(index));
-}
-
 // ============================================================================
 // RobotArmControls - Main control panel
 // ============================================================================
@@ -332,110 +308,86 @@ void RobotArmControls::onAddComponentClicked()
 {
     int selectedType = m_componentTypeGroup->checkedId();
 
+    // The widget is added once the simulation handed out a handle for the component
     switch (selectedType) {
-        case 0: { // Piston
-            float maxLength = m_pistonMaxLengthSpinBox->value();
-            addPistonWidget(maxLength);
-            emit pistonAdded(maxLength);
+        case 0: // Piston
+            emit pistonAdded(m_pistonMaxLengthSpinBox->value());
             break;
-        }
         case 1: // Hinge
-            addHingeWidget(0.0f);
             emit hingeAdded();
             break;
         case 2: // Swivel
-            addSwivelWidget(0.0f);
             emit swivelAdded();
             break;
-        case 3: { // Link
-            float length = m_linkLengthSpinBox->value();
-            addLinkWidget(length);
-            emit linkAdded(length);
+        case 3: // Link
+            emit linkAdded(m_linkLengthSpinBox->value());
             break;
-        }
     }
 }
 
-void RobotArmControls::addPistonWidget(float maxLength)
+void RobotArmControls::addPistonWidget(ComponentHandle handle, float maxLength, float targetLength)
 {
-    auto* widget = new PistonWidget(m_componentWidgets.size(), maxLength);
+    auto* widget = new PistonWidget(handle, maxLength, targetLength);
 
     connect(widget, &PistonWidget::targetLengthChanged, this, &RobotArmControls::pistonTargetLengthChanged);
-    connect(widget, &PistonWidget::removeRequested, this, &RobotArmControls::removeComponentWidget);
+    connect(widget, &PistonWidget::removeRequested, this, &RobotArmControls::componentRemoveRequested);
 
-    m_componentWidgets.push_back(widget);
-    m_componentsLayout->insertWidget(m_componentsLayout->count() - 1, widget);
+    insertComponentWidget(handle, widget);
 }
 
-void RobotArmControls::addHingeWidget(float initialAngle)
+void RobotArmControls::addHingeWidget(ComponentHandle handle, float initialAngle)
 {
-    auto* widget = new HingeWidget(m_componentWidgets.size(), initialAngle);
+    auto* widget = new HingeWidget(handle, initialAngle);
 
     connect(widget, &HingeWidget::targetAngleChanged, this, &RobotArmControls::hingeTargetAngleChanged);
-    connect(widget, &HingeWidget::removeRequested, this, &RobotArmControls::removeComponentWidget);
+    connect(widget, &HingeWidget::removeRequested, this, &RobotArmControls::componentRemoveRequested);
 
-    m_componentWidgets.push_back(widget);
-    m_componentsLayout->insertWidget(m_componentsLayout->count() - 1, widget);
+    insertComponentWidget(handle, widget);
 }
 
-void RobotArmControls::addSwivelWidget(float speed)
+void RobotArmControls::addSwivelWidget(ComponentHandle handle, float speed)
 {
-    auto* widget = new SwivelWidget(m_componentWidgets.size(), speed);
+    auto* widget = new SwivelWidget(handle, speed);
 
     connect(widget, &SwivelWidget::rotationalSpeedChanged, this, &RobotArmControls::swivelRotationalSpeedChanged);
-    connect(widget, &SwivelWidget::removeRequested, this, &RobotArmControls::removeComponentWidget);
+    connect(widget, &SwivelWidget::removeRequested, this, &RobotArmControls::componentRemoveRequested);
 
-    m_componentWidgets.push_back(widget);
-    m_componentsLayout->insertWidget(m_componentsLayout->count() - 1, widget);
+    insertComponentWidget(handle, widget);
 }
 
-void RobotArmControls::addLinkWidget(float length)
+void RobotArmControls::addLinkWidget(ComponentHandle handle, float length)
 {
-    auto* widget = new LinkWidget(m_componentWidgets.size(), length);
+    auto* widget = new LinkWidget(handle, length);
+
+    connect(widget, &LinkWidget::removeRequested, this, &RobotArmControls::componentRemoveRequested);
 
-    connect(widget, &LinkWidget::removeRequested, this, &RobotArmControls::removeComponentWidget);
+    insertComponentWidget(handle, widget);
+}
 
-    m_componentWidgets.push_back(widget);
+void RobotArmControls::insertComponentWidget(ComponentHandle handle, QWidget* widget)
+{
+    if (handle.slot >= m_componentWidgets.size()) {
+        m_componentWidgets.resize(handle.slot + 1, nullptr);
+    }
+    m_componentWidgets[handle.slot] = widget;
     m_componentsLayout->insertWidget(m_componentsLayout->count() - 1, widget);
 }
 
-void RobotArmControls::removeComponentWidget(std::size_t index)
+void RobotArmControls::removeComponentWidget(ComponentHandle handle)
 {
-    if (index >= m_componentWidgets.size()) return;
+    if (handle.slot >= m_componentWidgets.size() || !m_componentWidgets[handle.slot]) return;
 
-    auto* widget = m_componentWidgets[index];
+    // No other widget changes, handles of the remaining components stay valid
+    auto* widget = m_componentWidgets[handle.slot];
     m_componentsLayout->removeWidget(widget);
     widget->deleteLater();
-
-    m_componentWidgets.erase(m_componentWidgets.begin() + index);
-
-    rebuildIndices();
-    emit componentRemoved(index);
-}
-
-void RobotArmControls::rebuildIndices()
-{
-    // Update indices in all widgets after removal
-    for (std::size_t i = 0; i < m_componentWidgets.size(); ++i) {
-        if (auto* widget = qobject_cast<PistonWidget*>(m_componentWidgets[i])) {
-            widget->setIndex(i);
-        }
-        else if (auto* widget = qobject_cast<HingeWidget*>(m_componentWidgets[i])) {
-            widget->setIndex(i);
-        }
-        else if (auto* widget = qobject_cast<SwivelWidget*>(m_componentWidgets[i])) {
-            widget->setIndex(i);
-        }
-        else if (auto* widget = qobject_cast<LinkWidget*>(m_componentWidgets[i])) {
-            widget->setIndex(i);
-        }
-    }
+    m_componentWidgets[handle.slot] = nullptr;
 }
 
 void RobotArmControls::clear()
 {
     for (auto* widget : m_componentWidgets) {
-        widget->deleteLater();
+        if (widget) widget->deleteLater();
     }
     m_componentWidgets.clear();
 }
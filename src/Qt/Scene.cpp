@@ -3,6 +3,7 @@
 //
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <cmath>
 #include <print>
 #include <RobotArm/Qt/Scene.hpp>
 #include <utility>
@@ -32,33 +33,14 @@ glm::vec3 color_for(ComponentType type)
 }
 
 
-void Scene::submit_to(RenderQueue& queue) const
+// Arrow from origin along vector, as long as the vector. Too short to see draws nothing
+void submit_arrow(RenderQueue& queue, glm::vec3 origin, glm::vec3 vector, glm::vec3 color)
 {
-	queue.submit(
-		{
-			MeshId::Sphere,
-			{
-				glm::scale(glm::mat4{1}, glm::vec3(0.85f, 0.85f, 0.85f)),
-				glm::vec3(122 / 255.f,122 / 255.f,122 / 255.f)
-			}
-		});
-	auto render_data = m_simulation.get_render_data();
-	for (const auto& [type, model]  : render_data.components)
-	{
-		queue.submit({
-			mesh_for(type),
-			InstanceData {
-				model,
-				color_for(type)
-			},
-		});
-	}
-	glm::vec3 vel = render_data.tip_vel;
-	float magnitude = glm::length(vel);
+	float magnitude = glm::length(vector);
 
 	if (magnitude > 0.001f)
 	{
-		glm::vec3 dir = vel / magnitude;
+		glm::vec3 dir = vector / magnitude;
 		glm::vec3 up{0, 1, 0};
 
 		glm::mat4 rotation{1.0f};
@@ -78,21 +60,66 @@ void Scene::submit_to(RenderQueue& queue) const
 		}
 		// else: pointing straight up, no rotation needed
 
-		glm::mat4 model = glm::translate(glm::mat4{1.0f}, render_data.tip_pos);
+		glm::mat4 model = glm::translate(glm::mat4{1.0f}, origin);
 		model = model * rotation;
 		model = glm::scale(model, glm::vec3{0.05f, magnitude, 0.05f});
 
 		queue.submit({
 			MeshId::Arrow,
-			InstanceData{model, glm::vec3{0.2f, 0.8f, 0.8f}}
+			InstanceData{model, color}
+		});
+	}
+}
+
+void Scene::submit_to(RenderQueue& queue)
+{
+	queue.submit(
+		{
+			MeshId::Sphere,
+			{
+				glm::scale(glm::mat4{1}, glm::vec3(0.85f, 0.85f, 0.85f)),
+				glm::vec3(122 / 255.f,122 / 255.f,122 / 255.f)
+			}
+		});
+	if (m_replay && m_replay->duration() > 0)
+	{
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_replay_start).count();
+		m_replay->get_render_data(m_render_data, std::fmod(elapsed, m_replay->duration()));
+	}
+	else
+		m_simulation.get_render_data(m_render_data);
+	const auto& render_data = m_render_data;
+	for (const auto& [type, model]  : render_data.components)
+	{
+		queue.submit({
+			mesh_for(type),
+			InstanceData {
+				model,
+				color_for(type)
+			},
 		});
 	}
+	submit_arrow(queue, render_data.tip_pos, render_data.tip_vel, glm::vec3{0.2f, 0.8f, 0.8f});
+	// Segment motion is only filled while shown, all arrows share one mesh so they go out as a single instanced draw
+	for (const auto& motion : render_data.segment_motion)
+	{
+		submit_arrow(queue, motion.position, motion.linear_velocity, glm::vec3{0.9f, 0.6f, 0.9f});
+	}
 }
 Camera& Scene::get_camera()
 {
 	return m_camera;
 }
-Simulation& Scene::get_simulation()
+SimulationThread& Scene::get_simulation()
 {
 	return m_simulation;
-}
\ No newline at end of file
+}
+void Scene::replay(const std::filesystem::path& path)
+{
+	m_replay.emplace(path);
+	m_replay_start = std::chrono::steady_clock::now();
+}
+void Scene::show_segment_velocities(bool show)
+{
+	m_simulation.set_compute_segment_motion(show);
+}
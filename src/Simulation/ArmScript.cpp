@@ -0,0 +1,262 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <format>
+#include <RobotArm/Simulation/ArmScript.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+// Calls on_line with every non empty line after stripping comments
+template <class F>
+void for_each_statement(std::istream& in, F&& on_line)
+{
+	std::string line;
+	std::size_t line_number = 0;
+	while (std::getline(in, line))
+	{
+		++line_number;
+		if (auto comment = line.find('#'); comment != std::string::npos)
+			line.erase(comment);
+		std::istringstream statement(line);
+		std::string		   keyword;
+		if (!(statement >> keyword))
+			continue;
+		on_line(statement, keyword, line_number);
+	}
+}
+
+template <class T>
+T read(std::istringstream& statement, std::size_t line_number, std::string_view what)
+{
+	T value;
+	if (!(statement >> value))
+		throw std::runtime_error(std::format("line {}: expected {}", line_number, what));
+	return value;
+}
+
+void expect_end(std::istringstream& statement, std::size_t line_number)
+{
+	std::string rest;
+	if (statement >> rest)
+		throw std::runtime_error(std::format("line {}: unexpected '{}'", line_number, rest));
+}
+} // namespace
+
+Simulation parse_arm_description(std::istream& in)
+{
+	Simulation				   sim;
+	std::vector<std::uint32_t> path_to_previous; // Where a parent may be without breaking depth first order
+	for_each_statement(
+		in,
+		[&](std::istringstream& statement, const std::string& keyword, std::size_t line_number)
+		{
+			if (keyword == "gravity")
+			{
+				glm::vec3 gravity;
+				for (int axis = 0; axis < 3; ++axis)
+					gravity[axis] = read<float>(statement, line_number, "a gravity coordinate");
+				expect_end(statement, line_number);
+				sim.set_gravity(gravity);
+				return;
+			}
+
+			Component component = Link{0.0f};
+			if (keyword == "link")
+				component = Link{read<float>(statement, line_number, "link length")};
+			else if (keyword == "piston")
+			{
+				float max_length = read<float>(statement, line_number, "piston max length");
+				component		 = Piston{Piston::MIN_LENGTH, Piston::MIN_LENGTH, max_length};
+			}
+			else if (keyword == "hinge")
+				component = Hinge{0.0f, 0.0f};
+			else if (keyword == "swivel")
+				component = Swivel{0.0f, 0.0f};
+			else
+				throw std::runtime_error(std::format("line {}: unknown component '{}'", line_number, keyword));
+
+			auto		   index  = static_cast<std::uint32_t>(sim.get_components().size());
+			std::uint32_t  parent = index == 0 ? Simulation::NO_PARENT : index - 1;
+			MassProperties mass;
+			bool		   has_mass = false;
+			auto*		   piston	= std::get_if<Piston>(&component);
+			auto*		   hinge	= std::get_if<Hinge>(&component);
+			auto*		   swivel	= std::get_if<Swivel>(&component);
+			std::string	   key;
+			while (statement >> key)
+			{
+				if (key == "parent")
+				{
+					auto value = read<std::string>(statement, line_number, "a parent index or base");
+					if (value == "base")
+						parent = Simulation::NO_PARENT;
+					else
+					{
+						std::istringstream number(value);
+						if (!(number >> parent) || parent >= index)
+							throw std::runtime_error(
+								std::format("line {}: parent has to be an earlier component", line_number));
+					}
+				}
+				else if (key == "length" && piston)
+					piston->current_length = read<float>(statement, line_number, "piston length");
+				else if (key == "target" && piston)
+					piston->target_length = read<float>(statement, line_number, "piston target length");
+				else if (key == "target" && hinge)
+					hinge->target_angle = read<float>(statement, line_number, "hinge target angle");
+				else if (key == "angle" && hinge)
+					hinge->current_angle = read<float>(statement, line_number, "hinge angle");
+				else if (key == "angle" && swivel)
+					swivel->angle = read<float>(statement, line_number, "swivel angle");
+				else if (key == "speed" && swivel)
+					swivel->rotational_speed = read<float>(statement, line_number, "swivel speed");
+				else if (key == "mass")
+					mass.mass = read<float>(statement, line_number, "mass");
+				else if (key == "com")
+				{
+					for (int axis = 0; axis < 3; ++axis)
+						mass.center_of_mass[axis] = read<float>(statement, line_number, "a center of mass coordinate");
+				}
+				else if (key == "inertia")
+				{
+					for (int row = 0; row < 3; ++row)
+					{
+						for (int column = 0; column < 3; ++column)
+							mass.inertia[column][row] = read<float>(statement, line_number, "an inertia entry");
+					}
+				}
+				else
+					throw std::runtime_error(std::format("line {}: unexpected '{}'", line_number, key));
+				has_mass |= key == "mass" || key == "com" || key == "inertia";
+			}
+			if (piston
+				&& !(Piston::MIN_LENGTH <= piston->current_length && piston->current_length <= piston->max_length
+					 && Piston::MIN_LENGTH <= piston->target_length && piston->target_length <= piston->max_length))
+				throw std::runtime_error(std::format("line {}: piston lengths out of range", line_number));
+
+			while (!path_to_previous.empty() && path_to_previous.back() != parent)
+				path_to_previous.pop_back();
+			if (path_to_previous.empty() && parent != Simulation::NO_PARENT)
+				throw std::runtime_error(
+					std::format("line {}: parent {} breaks the depth first order", line_number, parent));
+			path_to_previous.push_back(index);
+
+			sim.attach(component, parent == Simulation::NO_PARENT ? ComponentHandle{} : sim.get_handle(parent));
+			if (has_mass)
+				sim.set_mass_properties(index, mass);
+		});
+	return sim;
+}
+
+void write_arm_description(std::ostream& out, const Simulation& sim)
+{
+	// {} prints the shortest text that parses back to the same float
+	auto components = sim.get_components();
+	auto parents	= sim.get_parents();
+	auto masses		= sim.get_mass_properties();
+	if (sim.get_gravity() != glm::vec3{0.0f, -9.81f, 0.0f})
+		out << std::format("gravity {} {} {}\n", sim.get_gravity().x, sim.get_gravity().y, sim.get_gravity().z);
+	for (std::size_t i = 0; i < components.size(); ++i)
+	{
+		const auto& component = components[i];
+		if (const auto* link = std::get_if<Link>(&component))
+			out << std::format("link {}", link->length);
+		else if (const auto* piston = std::get_if<Piston>(&component))
+		{
+			out << std::format("piston {}", piston->max_length);
+			if (piston->current_length != Piston::MIN_LENGTH)
+				out << std::format(" length {}", piston->current_length);
+			if (piston->target_length != Piston::MIN_LENGTH)
+				out << std::format(" target {}", piston->target_length);
+		}
+		else if (const auto* hinge = std::get_if<Hinge>(&component))
+		{
+			out << "hinge";
+			if (hinge->current_angle != 0.0f)
+				out << std::format(" angle {}", hinge->current_angle);
+			if (hinge->target_angle != 0.0f)
+				out << std::format(" target {}", hinge->target_angle);
+		}
+		else if (const auto* swivel = std::get_if<Swivel>(&component))
+		{
+			out << "swivel";
+			if (swivel->angle != 0.0f)
+				out << std::format(" angle {}", swivel->angle);
+			if (swivel->rotational_speed != 0.0f)
+				out << std::format(" speed {}", swivel->rotational_speed);
+		}
+
+		if (parents[i] + std::size_t{1} != i)
+		{
+			if (parents[i] == Simulation::NO_PARENT)
+				out << (i == 0 ? "" : " parent base");
+			else
+				out << std::format(" parent {}", parents[i]);
+		}
+		const auto& mass = masses[i];
+		if (mass.mass != 0.0f)
+			out << std::format(" mass {}", mass.mass);
+		if (mass.center_of_mass != glm::vec3{0.0f})
+			out << std::format(" com {} {} {}", mass.center_of_mass.x, mass.center_of_mass.y, mass.center_of_mass.z);
+		if (mass.inertia != glm::mat3{0.0f})
+		{
+			out << " inertia";
+			for (int row = 0; row < 3; ++row)
+			{
+				for (int column = 0; column < 3; ++column)
+					out << std::format(" {}", mass.inertia[column][row]);
+			}
+		}
+		out << '\n';
+	}
+}
+
+std::vector<ScriptCommand> parse_command_script(std::istream& in)
+{
+	std::vector<ScriptCommand> commands;
+	for_each_statement(in,
+					   [&](std::istringstream& statement, const std::string& time_text, std::size_t line_number)
+					   {
+						   ScriptCommand command{};
+						   try
+						   {
+							   command.time = std::stof(time_text);
+						   }
+						   catch (const std::logic_error&)
+						   {
+							   throw std::runtime_error(std::format("line {}: expected a time", line_number));
+						   }
+						   if (!commands.empty() && command.time < commands.back().time)
+							   throw std::runtime_error(std::format("line {}: commands must be sorted by time", line_number));
+
+						   auto keyword = read<std::string>(statement, line_number, "a command");
+						   if (keyword == "reach")
+						   {
+							   command.type = ScriptCommandType::Reach;
+							   for (int axis = 0; axis < 3; ++axis)
+								   command.target[axis] = read<float>(statement, line_number, "a target coordinate");
+						   }
+						   else
+						   {
+							   if (keyword == "piston")
+								   command.type = ScriptCommandType::PistonTarget;
+							   else if (keyword == "hinge")
+								   command.type = ScriptCommandType::HingeTarget;
+							   else if (keyword == "swivel_speed")
+								   command.type = ScriptCommandType::SwivelSpeed;
+							   else if (keyword == "swivel_angle")
+								   command.type = ScriptCommandType::SwivelAngle;
+							   else
+								   throw std::runtime_error(
+									   std::format("line {}: unknown command '{}'", line_number, keyword));
+							   command.index = read<std::size_t>(statement, line_number, "a component index");
+							   command.value = read<float>(statement, line_number, "a value");
+						   }
+						   expect_end(statement, line_number);
+						   commands.push_back(command);
+					   });
+	return commands;
+}
@@ -0,0 +1,228 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <bit>
+#include <cstring>
+#include <RobotArm/Simulation/ArmSnapshot.hpp>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(std::endian::native == std::endian::little, "Snapshots are written in native byte order");
+
+namespace
+{
+constexpr char			MAGIC[8] = {'R', 'A', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr std::uint32_t VERSION	 = 1;
+
+struct FileHeader
+{
+	char		  magic[8];
+	std::uint32_t version;
+	std::uint32_t component_count;
+	std::uint32_t slot_count;
+	std::uint32_t free_slot;
+	float		  gravity[3];
+	std::uint32_t reserved;
+};
+static_assert(sizeof(FileHeader) == 40);
+
+struct ComponentRecord
+{
+	std::uint32_t type; // Index into the Component variant
+	// Piston current, target and max length, Hinge current and target angle, Swivel angle and speed, Link length
+	float state[3];
+};
+static_assert(sizeof(ComponentRecord) == 16);
+static_assert(sizeof(SlotMap::Slot) == 8);
+// Mass properties are copied as they are, which pins down their layout
+static_assert(std::is_trivially_copyable_v<MassProperties> && sizeof(MassProperties) == 13 * sizeof(float));
+
+// Columns of component_count entries in this order, then the slot table. Everything stays 4 byte aligned
+struct Layout
+{
+	std::size_t records;
+	std::size_t parents;
+	std::size_t slot_of;
+	std::size_t mass_properties;
+	std::size_t slots;
+	std::size_t size;
+
+	Layout(std::size_t component_count, std::size_t slot_count)
+	{
+		records			= sizeof(FileHeader);
+		parents			= records + component_count * sizeof(ComponentRecord);
+		slot_of			= parents + component_count * sizeof(std::uint32_t);
+		mass_properties = slot_of + component_count * sizeof(std::uint32_t);
+		slots			= mass_properties + component_count * sizeof(MassProperties);
+		size			= slots + slot_count * sizeof(SlotMap::Slot);
+	}
+};
+
+template <class T>
+T read_struct(std::span<const std::byte> bytes, std::size_t offset)
+{
+	T value;
+	std::memcpy(&value, bytes.data() + offset, sizeof(T));
+	return value;
+}
+
+ComponentRecord to_record(const Component& component)
+{
+	ComponentRecord record{};
+	record.type = static_cast<std::uint32_t>(component.index());
+	if (const auto* piston = std::get_if<Piston>(&component))
+	{
+		record.state[0] = piston->current_length;
+		record.state[1] = piston->target_length;
+		record.state[2] = piston->max_length;
+	}
+	else if (const auto* hinge = std::get_if<Hinge>(&component))
+	{
+		record.state[0] = hinge->current_angle;
+		record.state[1] = hinge->target_angle;
+	}
+	else if (const auto* swivel = std::get_if<Swivel>(&component))
+	{
+		record.state[0] = swivel->angle;
+		record.state[1] = swivel->rotational_speed;
+	}
+	else
+		record.state[0] = std::get<Link>(component).length;
+	return record;
+}
+
+Component to_component(const ComponentRecord& record)
+{
+	switch (record.type)
+	{
+		case 0: return Piston{record.state[0], record.state[1], record.state[2]};
+		case 1: return Hinge{record.state[0], record.state[1]};
+		case 2: return Swivel{record.state[1], record.state[0]};
+		default: return Link{record.state[0]};
+	}
+}
+
+} // namespace
+
+void ArmSnapshot::capture(const Simulation& sim)
+{
+	auto   components = sim.get_components();
+	auto   slots	  = sim.m_handles.get_slots();
+	Layout layout(components.size(), slots.size());
+	m_file = {};
+	m_owned.resize(layout.size);
+	std::byte* out = m_owned.data();
+
+	FileHeader header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version		   = VERSION;
+	header.component_count = static_cast<std::uint32_t>(components.size());
+	header.slot_count	   = static_cast<std::uint32_t>(slots.size());
+	header.free_slot	   = sim.m_handles.get_free_slot();
+	std::memcpy(header.gravity, &sim.m_gravity, sizeof(header.gravity));
+	std::memcpy(out, &header, sizeof(header));
+
+	for (std::size_t i = 0; i < components.size(); ++i)
+	{
+		auto record = to_record(components[i]);
+		std::memcpy(out + layout.records + i * sizeof(ComponentRecord), &record, sizeof(record));
+	}
+	auto copy = [&](std::size_t offset, auto values)
+	{
+		if (!values.empty())
+			std::memcpy(out + offset, values.data(), values.size_bytes());
+	};
+	copy(layout.parents, sim.get_parents());
+	copy(layout.slot_of, sim.m_handles.get_element_slots());
+	copy(layout.mass_properties, sim.get_mass_properties());
+	copy(layout.slots, slots);
+	m_bytes = m_owned;
+}
+void ArmSnapshot::restore(Simulation& sim) const
+{
+	if (m_bytes.empty())
+		throw std::logic_error("Restoring an empty snapshot");
+	auto		header = read_struct<FileHeader>(m_bytes, 0);
+	std::size_t count  = header.component_count;
+	Layout		layout(count, header.slot_count);
+	// Every column is 4 byte aligned since the buffer or mapping is and every offset is a multiple of 4
+	auto column = [&]<class T>(std::size_t offset, std::size_t size)
+	{ return std::span<const T>{reinterpret_cast<const T*>(m_bytes.data() + offset), size}; };
+
+	sim.m_components.resize(count);
+	for (std::size_t i = 0; i < count; ++i)
+		sim.m_components[i] = to_component(read_struct<ComponentRecord>(m_bytes, layout.records + i * sizeof(ComponentRecord)));
+	auto parents = column.operator()<std::uint32_t>(layout.parents, count);
+	sim.m_parent.assign(parents.begin(), parents.end());
+	auto mass_properties = column.operator()<MassProperties>(layout.mass_properties, count);
+	sim.m_mass_properties.assign(mass_properties.begin(), mass_properties.end());
+	sim.m_handles.assign(column.operator()<SlotMap::Slot>(layout.slots, header.slot_count),
+						 column.operator()<std::uint32_t>(layout.slot_of, count), header.free_slot);
+	std::memcpy(&sim.m_gravity, header.gravity, sizeof(header.gravity));
+	sim.m_first_dirty = 0;
+	sim.rebuild_topology();
+}
+Simulation ArmSnapshot::to_simulation() const
+{
+	Simulation sim;
+	restore(sim);
+	return sim;
+}
+
+ArmSnapshot ArmSnapshot::load(const std::filesystem::path& path)
+{
+	ArmSnapshot snapshot;
+	snapshot.m_file = MappedFile::open_read(path);
+	auto bytes		= snapshot.m_file.bytes();
+	auto invalid	= [&](const char* why) { return std::runtime_error(path.string() + " " + why); };
+	if (bytes.size() < sizeof(FileHeader))
+		throw invalid("is not an arm snapshot");
+	auto header = read_struct<FileHeader>(bytes, 0);
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+		throw invalid("is not an arm snapshot");
+	std::size_t count = header.component_count;
+	Layout layout(count, header.slot_count);
+	if (bytes.size() != layout.size)
+		throw invalid("is truncated");
+
+	// Parents have to come first and keep every subtree contiguous, so each one is on the path to the component before
+	std::vector<std::uint32_t> path_to_previous;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		auto record = read_struct<ComponentRecord>(bytes, layout.records + i * sizeof(ComponentRecord));
+		auto parent = read_struct<std::uint32_t>(bytes, layout.parents + i * sizeof(std::uint32_t));
+		if (record.type >= std::variant_size_v<ComponentBase>)
+			throw invalid("has an unknown component type");
+		if (record.type == 0 && !(record.state[2] >= Piston::MIN_LENGTH))
+			throw invalid("has a piston shorter than the minimum");
+		while (!path_to_previous.empty() && path_to_previous.back() != parent)
+			path_to_previous.pop_back();
+		if (path_to_previous.empty() && parent != Simulation::NO_PARENT)
+			throw invalid("is not stored depth first");
+		path_to_previous.push_back(static_cast<std::uint32_t>(i));
+
+		auto slot = read_struct<std::uint32_t>(bytes, layout.slot_of + i * sizeof(std::uint32_t));
+		if (slot >= header.slot_count
+			|| read_struct<SlotMap::Slot>(bytes, layout.slots + slot * sizeof(SlotMap::Slot)).index != i)
+			throw invalid("has an inconsistent handle table");
+	}
+	std::uint32_t free_slot = header.free_slot;
+	for (std::size_t steps = 0; free_slot != ComponentHandle::NULL_SLOT; ++steps)
+	{
+		if (free_slot >= header.slot_count || steps >= header.slot_count)
+			throw invalid("has an inconsistent handle table");
+		free_slot = read_struct<SlotMap::Slot>(bytes, layout.slots + free_slot * sizeof(SlotMap::Slot)).index;
+	}
+	snapshot.m_bytes = bytes;
+	return snapshot;
+}
+void ArmSnapshot::save(const std::filesystem::path& path) const
+{
+	auto file = MappedFile::create(path, m_bytes.size());
+	if (!m_bytes.empty())
+		std::memcpy(file.bytes().data(), m_bytes.data(), m_bytes.size());
+}
+std::size_t ArmSnapshot::component_count() const
+{
+	return m_bytes.empty() ? 0 : read_struct<FileHeader>(m_bytes, 0).component_count;
+}
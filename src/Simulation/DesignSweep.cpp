@@ -0,0 +1,408 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <RobotArm/Simulation/DesignSweep.hpp>
+#include <RobotArm/Simulation/InverseKinematics.hpp>
+#include <RobotArm/Simulation/MappedFile.hpp>
+#include <RobotArm/Simulation/ThreadPool.hpp>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little, "Sweep results are written in native byte order");
+
+namespace
+{
+constexpr char			MAGIC[8] = {'R', 'A', 'S', 'W', 'E', 'E', 'P', '\0'};
+constexpr std::uint32_t VERSION	 = 1;
+// Candidates per parallel_for chunk, enough to amortize taking a simulation from the pool
+constexpr std::size_t GRAIN = 16;
+
+struct FileHeader
+{
+	char		  magic[8];
+	std::uint32_t version;
+	std::uint32_t slot_count;
+	std::uint32_t metric_count;
+	std::uint32_t finished; // Set once every block is written
+	std::uint64_t candidate_count;
+};
+static_assert(sizeof(FileHeader) == 32);
+
+struct MetricName
+{
+	char name[DesignMetric::MAX_NAME_LENGTH + 1]; // Zero terminated
+};
+static_assert(sizeof(MetricName) % 8 == 0);
+
+std::size_t align8(std::size_t offset)
+{
+	return (offset + 7) & ~std::size_t{7};
+}
+
+// Uniform candidate index from the sample index alone, the modulo bias is irrelevant next to 2^64
+std::uint64_t sample_candidate(std::uint64_t seed, std::uint64_t sample, std::uint64_t candidate_count)
+{
+	std::uint64_t x = seed * 0x9e3779b97f4a7c15ull + sample * 0xbf58476d1ce4e5b9ull;
+	// splitmix64 finalizer
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+	x = x ^ (x >> 31);
+	return x % candidate_count;
+}
+
+std::vector<ComponentOption> evenly_spaced(ComponentType type, float first, float last, std::size_t count)
+{
+	std::vector<ComponentOption> options;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		float t = count > 1 ? static_cast<float>(i) / static_cast<float>(count - 1) : 0.0f;
+		options.push_back({type, first + (last - first) * t});
+	}
+	return options;
+}
+
+// What evaluating one candidate needs, the built arm and a copy of it for every metric to work on
+struct Workspace
+{
+	Simulation				   built;
+	Simulation				   scratch;
+	std::vector<std::uint32_t> choices;
+};
+
+// Workspaces outlive the candidates built into them, so their vectors only grow until the largest arm fits
+class SimulationPool
+{
+	std::mutex								m_mutex;
+	std::vector<std::unique_ptr<Workspace>> m_free;
+
+public:
+	std::unique_ptr<Workspace> acquire()
+	{
+		std::scoped_lock lock(m_mutex);
+		if (m_free.empty())
+			return std::make_unique<Workspace>();
+		auto workspace = std::move(m_free.back());
+		m_free.pop_back();
+		return workspace;
+	}
+	void release(std::unique_ptr<Workspace> workspace)
+	{
+		std::scoped_lock lock(m_mutex);
+		m_free.push_back(std::move(workspace));
+	}
+};
+
+// Appends blocks to a growing mapping, the header goes in last so a sweep that died halfway is recognizable
+class SweepWriter
+{
+	MappedFile	m_file;
+	std::size_t m_offset = 0;
+
+public:
+	SweepWriter(const std::filesystem::path& path, std::span<const DesignMetric> metrics)
+		: m_file(MappedFile::create(path, sizeof(FileHeader) + metrics.size() * sizeof(MetricName)))
+	{
+		m_offset = sizeof(FileHeader);
+		for (const auto& metric : metrics)
+		{
+			MetricName name{};
+			std::memcpy(name.name, metric.name.data(), metric.name.size());
+			write(std::span<const MetricName>{&name, 1});
+		}
+	}
+	template <class T>
+	void write(std::span<const T> values)
+	{
+		std::size_t end = align8(m_offset + values.size_bytes());
+		if (end > m_file.size())
+			m_file.resize(std::max(m_file.size() * 2, end));
+		if (!values.empty())
+			std::memcpy(m_file.bytes().data() + m_offset, values.data(), values.size_bytes());
+		std::memset(m_file.bytes().data() + m_offset + values.size_bytes(), 0, end - m_offset - values.size_bytes());
+		m_offset = end;
+	}
+	void finish(std::uint32_t slot_count, std::uint32_t metric_count, std::uint64_t candidate_count)
+	{
+		FileHeader header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version		   = VERSION;
+		header.slot_count	   = slot_count;
+		header.metric_count	   = metric_count;
+		header.finished		   = 1;
+		header.candidate_count = candidate_count;
+		std::memcpy(m_file.bytes().data(), &header, sizeof(header));
+		m_file.resize(m_offset);
+	}
+};
+
+void apply(const ScriptCommand& command, Simulation& sim)
+{
+	switch (command.type)
+	{
+		case ScriptCommandType::PistonTarget: sim.set_piston_target_length(command.index, command.value); break;
+		case ScriptCommandType::HingeTarget: sim.set_hinge_target_angle(command.index, command.value); break;
+		case ScriptCommandType::SwivelSpeed: sim.set_swivel_rotation_speed(command.index, command.value); break;
+		case ScriptCommandType::SwivelAngle: sim.set_swivel_angle(command.index, command.value); break;
+		case ScriptCommandType::Reach:
+		{
+			thread_local IkSolver solver;
+			solver.solve(sim, command.target);
+			break;
+		}
+	}
+}
+} // namespace
+
+std::uint64_t DesignSpace::candidate_count() const
+{
+	std::uint64_t count = 1;
+	for (const auto& options : slots)
+	{
+		if (options.empty())
+			return 0;
+		if (count > std::numeric_limits<std::uint64_t>::max() / options.size())
+			return std::numeric_limits<std::uint64_t>::max();
+		count *= options.size();
+	}
+	return count;
+}
+void DesignSpace::decode(std::uint64_t candidate, std::span<std::uint32_t> choices) const
+{
+	assert(choices.size() == slots.size());
+	for (std::size_t slot = 0; slot < slots.size(); ++slot)
+	{
+		choices[slot] = static_cast<std::uint32_t>(candidate % slots[slot].size());
+		candidate /= slots[slot].size();
+	}
+}
+void DesignSpace::build(std::span<const std::uint32_t> choices, Simulation& sim) const
+{
+	assert(choices.size() == slots.size());
+	sim.clear();
+	for (std::size_t slot = 0; slot < slots.size(); ++slot)
+	{
+		const auto& option = slots[slot][choices[slot]];
+		switch (option.type)
+		{
+			case ComponentType::Link: sim.add_link(option.size); break;
+			case ComponentType::Piston: sim.add_piston(option.size); break;
+			case ComponentType::Hinge: sim.add_hinge(); break;
+			case ComponentType::Swivel: sim.add_swivel(); break;
+		}
+	}
+}
+
+std::vector<ComponentOption> link_options(float first, float last, std::size_t count)
+{
+	return evenly_spaced(ComponentType::Link, first, last, count);
+}
+std::vector<ComponentOption> piston_options(float first, float last, std::size_t count)
+{
+	return evenly_spaced(ComponentType::Piston, first, last, count);
+}
+
+DesignMetric reach_metric()
+{
+	return {"reach",
+			[](Simulation& sim)
+			{
+				thread_local std::vector<float> positions;
+				thread_local RenderData			render_data;
+				positions.clear();
+				for (const auto& component : sim.get_components())
+				{
+					if (const auto* piston = std::get_if<Piston>(&component))
+						positions.push_back(piston->max_length);
+					else if (!std::holds_alternative<Link>(component))
+						positions.push_back(0.0f);
+				}
+				sim.set_joint_positions(positions);
+				sim.get_render_data(render_data, {.compute_tip_velocity = false, .compute_clearance = false});
+				return glm::length(render_data.tip_pos);
+			}};
+}
+DesignMetric coverage_metric(ReachabilitySettings settings)
+{
+	settings.thread_count = 1; // Already on a pool thread
+	return {"coverage",
+			[settings](Simulation& sim)
+			{
+				auto map = ReachabilityMap::generate(sim, settings);
+				return static_cast<float>(map.voxels().size()) * settings.voxel_size * settings.voxel_size
+					 * settings.voxel_size;
+			}};
+}
+DesignMetric cycle_time_metric(std::vector<ScriptCommand> script, float dt, float time_limit)
+{
+	if (!(dt > 0.0f))
+		throw std::invalid_argument("dt must be positive");
+	return {"cycle_time",
+			[script = std::move(script), dt, time_limit](Simulation& sim)
+			{
+				auto		steps		 = static_cast<std::size_t>(std::ceil(time_limit / dt));
+				std::size_t next_command = 0;
+				for (std::size_t step = 0; step <= steps; ++step)
+				{
+					float time = static_cast<float>(step) * dt;
+					for (; next_command < script.size() && script[next_command].time <= time; ++next_command)
+					{
+						try
+						{
+							apply(script[next_command], sim);
+						}
+						catch (const std::exception& error)
+						{
+							throw std::invalid_argument(
+								std::format("command at t={} failed: {}", script[next_command].time, error.what()));
+						}
+					}
+					if (next_command == script.size() && sim.is_at_rest())
+						return time;
+					sim.tick(dt);
+				}
+				return std::numeric_limits<float>::infinity();
+			}};
+}
+
+DesignSweepStatistics run_design_sweep(const DesignSpace& space, std::span<const DesignMetric> metrics,
+									   const std::filesystem::path& output, DesignSweepSettings settings)
+{
+	for (const auto& metric : metrics)
+	{
+		if (metric.name.size() > DesignMetric::MAX_NAME_LENGTH)
+			throw std::invalid_argument("metric name " + metric.name + " is too long");
+	}
+	if (settings.batch_size == 0)
+		throw std::invalid_argument("batch_size must be positive");
+	std::uint64_t candidate_count = space.candidate_count();
+	std::uint64_t total			  = settings.samples == 0 ? candidate_count : settings.samples;
+	if (candidate_count == 0)
+		total = 0;
+
+	auto		   start = std::chrono::steady_clock::now();
+	SweepWriter	   writer(output, metrics);
+	ThreadPool	   pool(settings.thread_count);
+	SimulationPool simulations;
+	std::size_t	   slot_count = space.slots.size();
+	std::atomic<std::uint64_t> failures{0};
+	// Column major like the file, one batch at a time
+	std::vector<std::uint64_t> candidates;
+	std::vector<std::uint32_t> choices;
+	std::vector<float>		   values;
+
+	for (std::uint64_t batch_begin = 0; batch_begin < total; batch_begin += settings.batch_size)
+	{
+		auto rows = static_cast<std::size_t>(std::min<std::uint64_t>(settings.batch_size, total - batch_begin));
+		candidates.resize(rows);
+		choices.resize(rows * slot_count);
+		values.resize(rows * metrics.size());
+		pool.parallel_for(
+			rows, GRAIN,
+			[&](std::size_t begin, std::size_t end)
+			{
+				auto  workspace = simulations.acquire();
+				auto& choice	= workspace->choices;
+				choice.resize(slot_count);
+				for (std::size_t row = begin; row < end; ++row)
+				{
+					std::uint64_t sample	= batch_begin + row;
+					std::uint64_t candidate = settings.samples == 0
+												? sample
+												: sample_candidate(settings.seed, sample, candidate_count);
+					candidates[row] = candidate;
+					space.decode(candidate, choice);
+					for (std::size_t slot = 0; slot < slot_count; ++slot)
+						choices[slot * rows + row] = choice[slot];
+					space.build(choice, workspace->built);
+					for (std::size_t metric = 0; metric < metrics.size(); ++metric)
+					{
+						float value = std::numeric_limits<float>::quiet_NaN();
+						try
+						{
+							workspace->scratch = workspace->built; // Copy assignment keeps the capacity
+							value			   = metrics[metric].evaluate(workspace->scratch);
+						}
+						catch (const std::exception&)
+						{
+							failures.fetch_add(1, std::memory_order_relaxed);
+						}
+						values[metric * rows + row] = value;
+					}
+				}
+				simulations.release(std::move(workspace));
+			});
+
+		std::uint64_t block_rows = rows;
+		writer.write(std::span<const std::uint64_t>{&block_rows, 1});
+		writer.write(std::span<const std::uint64_t>{candidates});
+		for (std::size_t slot = 0; slot < slot_count; ++slot)
+			writer.write(std::span<const std::uint32_t>{choices}.subspan(slot * rows, rows));
+		for (std::size_t metric = 0; metric < metrics.size(); ++metric)
+			writer.write(std::span<const float>{values}.subspan(metric * rows, rows));
+	}
+	writer.finish(static_cast<std::uint32_t>(slot_count), static_cast<std::uint32_t>(metrics.size()), total);
+
+	DesignSweepStatistics statistics;
+	statistics.candidates = total;
+	statistics.failures	  = failures.load();
+	statistics.seconds	  = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return statistics;
+}
+
+DesignSweepResults DesignSweepResults::load(const std::filesystem::path& path)
+{
+	auto	   file	 = MappedFile::open_read(path);
+	auto	   bytes = file.bytes();
+	FileHeader header;
+	if (bytes.size() < sizeof(header))
+		throw std::runtime_error(path.string() + " is not a design sweep");
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+		throw std::runtime_error(path.string() + " is not a design sweep");
+	if (!header.finished)
+		throw std::runtime_error(path.string() + " was not finished");
+
+	std::size_t offset = sizeof(header);
+	auto		read   = [&]<class T>(std::vector<T>& out, std::size_t count)
+	{
+		std::size_t size = count * sizeof(T);
+		if (bytes.size() < offset || bytes.size() - offset < size)
+			throw std::runtime_error(path.string() + " is truncated");
+		auto old = out.size();
+		out.resize(old + count);
+		if (size > 0)
+			std::memcpy(out.data() + old, bytes.data() + offset, size);
+		offset = align8(offset + size);
+	};
+
+	DesignSweepResults results;
+	std::vector<MetricName> names;
+	read(names, header.metric_count);
+	for (const auto& name : names)
+		results.metric_names.emplace_back(std::begin(name.name), std::ranges::find(name.name, '\0'));
+	results.choices.resize(header.slot_count);
+	results.metrics.resize(header.metric_count);
+	while (results.candidates.size() < header.candidate_count)
+	{
+		std::vector<std::uint64_t> rows;
+		read(rows, 1);
+		if (rows[0] == 0)
+			throw std::runtime_error(path.string() + " has an empty block");
+		read(results.candidates, rows[0]);
+		for (auto& column : results.choices)
+			read(column, rows[0]);
+		for (auto& column : results.metrics)
+			read(column, rows[0]);
+	}
+	return results;
+}
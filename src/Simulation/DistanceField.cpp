@@ -0,0 +1,439 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <RobotArm/Simulation/DistanceField.hpp>
+#include <RobotArm/Simulation/ThreadPool.hpp>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(std::endian::native == std::endian::little, "Distance fields are written in native byte order");
+
+namespace
+{
+constexpr char			MAGIC[8] = {'R', 'A', 'S', 'D', 'F', '\0', '\0', '\0'};
+constexpr std::uint32_t VERSION	 = 1;
+// 1 GiB of floats, anything bigger is almost certainly a voxel size in the wrong unit
+constexpr std::uint64_t MAX_GRID_POINTS = std::uint64_t{1} << 28;
+// Caps the cost of a very long segment, past that the samples are spread further than a voxel
+constexpr int			MAX_SEGMENT_SAMPLES = 64;
+constexpr std::size_t	ROWS_PER_TASK		= 8;
+constexpr float			INFINITE_DISTANCE	= std::numeric_limits<float>::infinity();
+
+struct FileHeader
+{
+	char		  magic[8];
+	std::uint32_t version;
+	float		  voxel_size;
+	float		  origin[3];
+	std::int32_t  size[3];
+	std::uint64_t key;
+};
+static_assert(sizeof(FileHeader) == 48);
+static_assert(sizeof(FileHeader) % alignof(float) == 0);
+
+struct Bounds
+{
+	glm::vec3 min{INFINITE_DISTANCE};
+	glm::vec3 max{-INFINITE_DISTANCE};
+
+	void add(glm::vec3 point)
+	{
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+	// Box around a shape with the given local half extents, rotated by pose
+	void add(const RigidTransform& pose, glm::vec3 half_extents)
+	{
+		glm::vec3 extent = glm::abs(pose.rotation[0]) * half_extents.x + glm::abs(pose.rotation[1]) * half_extents.y
+						 + glm::abs(pose.rotation[2]) * half_extents.z;
+		add(pose.translation - extent);
+		add(pose.translation + extent);
+	}
+};
+
+glm::vec3 to_local(const RigidTransform& pose, glm::vec3 point)
+{
+	// Rotations are orthonormal, the transpose is the inverse
+	return glm::transpose(pose.rotation) * (point - pose.translation);
+}
+
+float box_distance(const BoxObstacle& box, glm::vec3 point)
+{
+	glm::vec3 q = glm::abs(to_local(box.pose, point)) - box.half_extents;
+	return glm::length(glm::max(q, glm::vec3{0.0f})) + std::min(std::max(q.x, std::max(q.y, q.z)), 0.0f);
+}
+
+float cylinder_distance(const CylinderObstacle& cylinder, glm::vec3 point)
+{
+	glm::vec3 local	 = to_local(cylinder.pose, point);
+	float	  radial = std::hypot(local.x, local.z) - cylinder.radius;
+	float	  axial	 = std::abs(local.y) - cylinder.half_height;
+	return std::min(std::max(radial, axial), 0.0f) + std::hypot(std::max(radial, 0.0f), std::max(axial, 0.0f));
+}
+
+// Closest point on triangle abc to p, Ericson, Real-Time Collision Detection 5.1.5
+glm::vec3 closest_on_triangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c)
+{
+	glm::vec3 ab = b - a;
+	glm::vec3 ac = c - a;
+	glm::vec3 ap = p - a;
+	float	  d1 = glm::dot(ab, ap);
+	float	  d2 = glm::dot(ac, ap);
+	if (d1 <= 0.0f && d2 <= 0.0f)
+		return a;
+	glm::vec3 bp = p - b;
+	float	  d3 = glm::dot(ab, bp);
+	float	  d4 = glm::dot(ac, bp);
+	if (d3 >= 0.0f && d4 <= d3)
+		return b;
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+		return a + ab * (d1 / (d1 - d3));
+	glm::vec3 cp = p - c;
+	float	  d5 = glm::dot(ab, cp);
+	float	  d6 = glm::dot(ac, cp);
+	if (d6 >= 0.0f && d5 <= d6)
+		return c;
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+		return a + ac * (d2 / (d2 - d6));
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+	float denominator = 1.0f / (va + vb + vc);
+	return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+// Solid angle of triangle abc seen from the origin, Van Oosterom and Strackee
+float solid_angle(glm::vec3 a, glm::vec3 b, glm::vec3 c)
+{
+	float la = glm::length(a);
+	float lb = glm::length(b);
+	float lc = glm::length(c);
+	float numerator	  = glm::dot(a, glm::cross(b, c));
+	float denominator = la * lb * lc + glm::dot(a, b) * lc + glm::dot(b, c) * la + glm::dot(c, a) * lb;
+	return 2.0f * std::atan2(numerator, denominator);
+}
+
+// Unsigned distance to the closest triangle, the sign comes from the winding number so the mesh doesn't need
+// consistent normals, only to be closed
+float mesh_distance(const MeshObstacle& mesh, glm::vec3 point)
+{
+	glm::vec3 local		   = to_local(mesh.pose, point);
+	float	  closest	   = INFINITE_DISTANCE;
+	float	  solid_angles = 0.0f;
+	for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+	{
+		glm::vec3 a = mesh.vertices[mesh.indices[i]];
+		glm::vec3 b = mesh.vertices[mesh.indices[i + 1]];
+		glm::vec3 c = mesh.vertices[mesh.indices[i + 2]];
+		closest		= std::min(closest, glm::length(local - closest_on_triangle(local, a, b, c)));
+		solid_angles += solid_angle(a - local, b - local, c - local);
+	}
+	float winding = solid_angles / (4.0f * std::numbers::pi_v<float>);
+	return std::abs(winding) > 0.5f ? -closest : closest;
+}
+
+Bounds bounds_of(std::span<const Obstacle> obstacles)
+{
+	Bounds bounds;
+	for (const auto& obstacle : obstacles)
+	{
+		if (const auto* box = std::get_if<BoxObstacle>(&obstacle))
+			bounds.add(box->pose, box->half_extents);
+		else if (const auto* cylinder = std::get_if<CylinderObstacle>(&obstacle))
+			bounds.add(cylinder->pose, {cylinder->radius, cylinder->half_height, cylinder->radius});
+		else
+		{
+			const auto& mesh = std::get<MeshObstacle>(obstacle);
+			for (auto index : mesh.indices)
+				bounds.add(mesh.pose.transform_point(mesh.vertices.at(index)));
+		}
+	}
+	return bounds;
+}
+
+// FNV-1a over everything that changes the baked values
+class KeyHasher
+{
+	std::uint64_t m_hash = 0xcbf29ce484222325ull;
+
+public:
+	template <class T>
+		requires std::is_trivially_copyable_v<T>
+	void add(const T& value)
+	{
+		const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+		for (std::size_t i = 0; i < sizeof(T); ++i)
+		{
+			m_hash ^= bytes[i];
+			m_hash *= 0x100000001b3ull;
+		}
+	}
+	template <class T>
+	void add(const std::vector<T>& values)
+	{
+		add(values.size());
+		for (const auto& value : values)
+			add(value);
+	}
+	[[nodiscard]] std::uint64_t hash() const { return m_hash; }
+};
+
+std::uint64_t key_of(std::span<const Obstacle> obstacles, const DistanceFieldSettings& settings)
+{
+	KeyHasher hasher;
+	hasher.add(VERSION);
+	hasher.add(settings.voxel_size);
+	hasher.add(settings.padding);
+	hasher.add(obstacles.size());
+	for (const auto& obstacle : obstacles)
+	{
+		hasher.add(obstacle.index());
+		std::visit(
+			[&](const auto& held)
+			{
+				using T = std::decay_t<decltype(held)>;
+				hasher.add(held.pose);
+				if constexpr (std::same_as<T, BoxObstacle>)
+					hasher.add(held.half_extents);
+				else if constexpr (std::same_as<T, CylinderObstacle>)
+				{
+					hasher.add(held.radius);
+					hasher.add(held.half_height);
+				}
+				else
+				{
+					hasher.add(held.vertices);
+					hasher.add(held.indices);
+				}
+			},
+			obstacle);
+	}
+	return hasher.hash();
+}
+} // namespace
+
+float signed_distance(const Obstacle& obstacle, glm::vec3 point)
+{
+	if (const auto* box = std::get_if<BoxObstacle>(&obstacle))
+		return box_distance(*box, point);
+	if (const auto* cylinder = std::get_if<CylinderObstacle>(&obstacle))
+		return cylinder_distance(*cylinder, point);
+	return mesh_distance(std::get<MeshObstacle>(obstacle), point);
+}
+
+DistanceField DistanceField::bake(std::span<const Obstacle> obstacles, DistanceFieldSettings settings)
+{
+	if (!(settings.voxel_size > 0.0f) || !(settings.padding >= 0.0f))
+		throw std::invalid_argument("Distance fields need a positive voxel size and padding");
+
+	DistanceField field;
+	field.m_voxel_size = settings.voxel_size;
+	field.m_key		   = key_of(obstacles, settings);
+
+	Bounds bounds = bounds_of(obstacles);
+	if (!(bounds.min.x <= bounds.max.x))
+		return field; // Only empty meshes
+	glm::vec3 extent = bounds.max - bounds.min + glm::vec3{2.0f * settings.padding};
+	field.m_origin	 = bounds.min - glm::vec3{settings.padding};
+	std::uint64_t points = 1;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		// At least two points so every query has a cell to interpolate in
+		auto cells = static_cast<std::uint64_t>(std::ceil(extent[axis] / settings.voxel_size));
+		auto size  = std::max(cells + 1, std::uint64_t{2});
+		if (size > MAX_GRID_POINTS)
+			throw std::invalid_argument("Distance field grid is too large, use a bigger voxel size");
+		field.m_size[axis] = static_cast<int>(size);
+		points *= size;
+		if (points > MAX_GRID_POINTS)
+			throw std::invalid_argument("Distance field grid is too large, use a bigger voxel size");
+	}
+	field.m_owned.resize(points);
+
+	auto	   size_x = static_cast<std::size_t>(field.m_size.x);
+	auto	   size_y = static_cast<std::size_t>(field.m_size.y);
+	auto	   rows	  = size_y * static_cast<std::size_t>(field.m_size.z);
+	ThreadPool pool(settings.thread_count);
+	pool.parallel_for(rows, ROWS_PER_TASK,
+					  [&](std::size_t begin, std::size_t end)
+					  {
+						  for (std::size_t row = begin; row < end; ++row)
+						  {
+							  glm::vec3 point = field.m_origin
+											  + glm::vec3{0.0f, static_cast<float>(row % size_y),
+														  static_cast<float>(row / size_y)}
+													* settings.voxel_size;
+							  float* out = field.m_owned.data() + row * size_x;
+							  for (std::size_t x = 0; x < size_x; ++x)
+							  {
+								  point.x	  = field.m_origin.x + static_cast<float>(x) * settings.voxel_size;
+								  float value = INFINITE_DISTANCE;
+								  for (const auto& obstacle : obstacles)
+									  value = std::min(value, signed_distance(obstacle, point));
+								  out[x] = value;
+							  }
+						  }
+					  });
+	field.m_values = field.m_owned;
+	return field;
+}
+DistanceField DistanceField::load(const std::filesystem::path& path)
+{
+	DistanceField field;
+	field.m_file = MappedFile::open_read(path);
+	auto	   bytes = field.m_file.bytes();
+	FileHeader header;
+	if (bytes.size() < sizeof(header))
+		throw std::runtime_error(path.string() + " is not a distance field");
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+		throw std::runtime_error(path.string() + " is not a distance field");
+	std::uint64_t points = 1;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		// Either all axes are empty or none is, an empty field is one baked without obstacles
+		if (header.size[axis] < 0 || static_cast<std::uint64_t>(header.size[axis]) > MAX_GRID_POINTS)
+			throw std::runtime_error(path.string() + " is not a distance field");
+		points *= static_cast<std::uint64_t>(header.size[axis]);
+	}
+	if (points > (bytes.size() - sizeof(header)) / sizeof(float))
+		throw std::runtime_error(path.string() + " is truncated");
+
+	field.m_voxel_size = header.voxel_size;
+	field.m_origin	   = {header.origin[0], header.origin[1], header.origin[2]};
+	field.m_size	   = {header.size[0], header.size[1], header.size[2]};
+	field.m_key		   = header.key;
+	// The mapping is page aligned and the header keeps the values aligned after it
+	field.m_values = {reinterpret_cast<const float*>(bytes.data() + sizeof(header)), static_cast<std::size_t>(points)};
+	return field;
+}
+void DistanceField::save(const std::filesystem::path& path) const
+{
+	FileHeader header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version	  = VERSION;
+	header.voxel_size = m_voxel_size;
+	header.key		  = m_key;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		header.origin[axis] = m_origin[axis];
+		header.size[axis]	= m_values.empty() ? 0 : m_size[axis];
+	}
+
+	auto file  = MappedFile::create(path, sizeof(header) + m_values.size_bytes());
+	auto bytes = file.bytes();
+	std::memcpy(bytes.data(), &header, sizeof(header));
+	if (!m_values.empty())
+		std::memcpy(bytes.data() + sizeof(header), m_values.data(), m_values.size_bytes());
+}
+DistanceField DistanceField::load_or_bake(const std::filesystem::path& path, std::span<const Obstacle> obstacles,
+										  DistanceFieldSettings settings)
+{
+	if (std::filesystem::exists(path))
+	{
+		try
+		{
+			auto cached = load(path);
+			if (cached.m_key == key_of(obstacles, settings))
+				return cached;
+		}
+		catch (const std::exception&)
+		{
+			// Unreadable or from an older version, baking again replaces it
+		}
+	}
+	auto field = bake(obstacles, settings);
+	field.save(path);
+	return field;
+}
+
+DistanceSample DistanceField::sample(glm::vec3 point) const
+{
+	if (m_values.empty())
+		return {INFINITE_DISTANCE, glm::vec3{0.0f}};
+
+	// Grid coordinates, clamped onto the grid. Whatever was cut off is added back as a straight line distance
+	glm::vec3  grid = (point - m_origin) / m_voxel_size;
+	glm::vec3  clamped;
+	glm::ivec3 cell;
+	glm::vec3  fraction;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float last		= static_cast<float>(m_size[axis] - 1);
+		clamped[axis]	= std::clamp(grid[axis], 0.0f, last);
+		cell[axis]		= std::min(static_cast<int>(clamped[axis]), m_size[axis] - 2);
+		fraction[axis]	= clamped[axis] - static_cast<float>(cell[axis]);
+	}
+
+	auto		 stride_y = static_cast<std::size_t>(m_size.x);
+	auto		 stride_z = stride_y * static_cast<std::size_t>(m_size.y);
+	const float* c		  = m_values.data() + static_cast<std::size_t>(cell.x)
+				   + static_cast<std::size_t>(cell.y) * stride_y + static_cast<std::size_t>(cell.z) * stride_z;
+	float c000 = c[0];
+	float c100 = c[1];
+	float c010 = c[stride_y];
+	float c110 = c[stride_y + 1];
+	float c001 = c[stride_z];
+	float c101 = c[stride_z + 1];
+	float c011 = c[stride_z + stride_y];
+	float c111 = c[stride_z + stride_y + 1];
+
+	float fx = fraction.x;
+	float fy = fraction.y;
+	float fz = fraction.z;
+	// Interpolate along x first, the y and z derivatives reuse those edges
+	float c00 = c000 + (c100 - c000) * fx;
+	float c10 = c010 + (c110 - c010) * fx;
+	float c01 = c001 + (c101 - c001) * fx;
+	float c11 = c011 + (c111 - c011) * fx;
+	float c0  = c00 + (c10 - c00) * fy;
+	float c1  = c01 + (c11 - c01) * fy;
+
+	DistanceSample out;
+	out.distance = c0 + (c1 - c0) * fz;
+	float dx_0	 = (c100 - c000) + ((c110 - c010) - (c100 - c000)) * fy;
+	float dx_1	 = (c101 - c001) + ((c111 - c011) - (c101 - c001)) * fy;
+	out.gradient = glm::vec3{dx_0 + (dx_1 - dx_0) * fz, (c10 - c00) + ((c11 - c01) - (c10 - c00)) * fz, c1 - c0}
+				 / m_voxel_size;
+
+	glm::vec3 outside = (grid - clamped) * m_voxel_size;
+	if (outside != glm::vec3{0.0f})
+	{
+		float away = glm::length(outside);
+		out.distance += away;
+		out.gradient = outside / away;
+	}
+	return out;
+}
+Clearance DistanceField::clearance(glm::vec3 a, glm::vec3 b, float radius) const
+{
+	if (m_values.empty())
+		return {INFINITE_DISTANCE, glm::vec3{0.0f}};
+
+	float	  length  = glm::length(b - a);
+	glm::vec3 along	  = length > 0.0f ? (b - a) / length : glm::vec3{0.0f};
+	float	  spacing = std::max(m_voxel_size, length / static_cast<float>(MAX_SEGMENT_SAMPLES - 1));
+	// The distance changes at most as fast as the point moves, so nothing within current - closest of a sample can be
+	// closer than the closest one so far. Far from obstacles that skips straight to the end of the segment
+	DistanceSample closest = sample(a);
+	float		   current = closest.distance;
+	for (float s = 0.0f; s < length;)
+	{
+		s			= std::min(length, s + std::max(spacing, current - closest.distance));
+		auto next	= sample(a + along * s);
+		current		= next.distance;
+		if (current < closest.distance)
+			closest = next;
+	}
+	float	  gradient_length = glm::length(closest.gradient);
+	glm::vec3 direction = gradient_length > 0.0f ? closest.gradient * (-1.0f / gradient_length) : glm::vec3{0.0f};
+	return {closest.distance - radius, direction};
+}
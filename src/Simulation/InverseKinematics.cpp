@@ -0,0 +1,152 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <RobotArm/Simulation/InverseKinematics.hpp>
+
+namespace
+{
+float& position_of(Component& component)
+{
+	if (auto* piston = std::get_if<Piston>(&component))
+		return piston->current_length;
+	if (auto* hinge = std::get_if<Hinge>(&component))
+		return hinge->current_angle;
+	return std::get<Swivel>(component).angle;
+}
+} // namespace
+
+IkSolver::IkSolver(IkSettings settings)
+	: m_settings(settings)
+{
+}
+void IkSolver::load(const Simulation& sim)
+{
+	auto components = sim.get_components();
+	auto parents	= sim.get_parents();
+	auto columns	= sim.get_joint_columns();
+	m_path.clear();
+	if (!components.empty())
+	{
+		for (auto idx = static_cast<std::uint32_t>(components.size() - 1); idx != Simulation::NO_PARENT; idx = parents[idx])
+			m_path.push_back(idx);
+		std::ranges::reverse(m_path);
+	}
+	m_components.clear();
+	m_free_joints.clear();
+	m_free_columns.clear();
+	m_lower.clear();
+	m_upper.clear();
+	for (std::size_t p = 0; p < m_path.size(); ++p)
+	{
+		const auto& component = m_components.emplace_back(components[m_path[p]]);
+		if (const auto* piston = std::get_if<Piston>(&component))
+		{
+			m_lower.push_back(Piston::MIN_LENGTH);
+			m_upper.push_back(piston->max_length);
+		}
+		else if (std::holds_alternative<Hinge>(component))
+		{
+			m_lower.push_back(-m_settings.hinge_limit);
+			m_upper.push_back(m_settings.hinge_limit);
+		}
+		else if (const auto* swivel = std::get_if<Swivel>(&component); swivel && swivel->rotational_speed == 0)
+		{
+			m_lower.push_back(-std::numeric_limits<float>::infinity());
+			m_upper.push_back(std::numeric_limits<float>::infinity());
+		}
+		else
+			continue;
+		m_free_joints.push_back(p);
+		m_free_columns.push_back(columns[m_path[p]]);
+	}
+	m_free_transforms.resize(m_free_joints.size());
+	m_jacobian.resize(m_free_joints.size());
+}
+glm::vec3 IkSolver::forward_kinematics()
+{
+	// The columns need the tip, so remember the free joint frames on the way out and fill the columns afterwards
+	RigidTransform joint;
+	std::size_t	   next_free = 0;
+	for (std::size_t p = 0; p < m_components.size(); ++p)
+	{
+		joint = m_components[p].get_joint_transform(joint);
+		if (next_free < m_free_joints.size() && m_free_joints[next_free] == p)
+			m_free_transforms[next_free++] = joint;
+	}
+	glm::vec3 tip = joint.translation;
+
+	for (std::size_t j = 0; j < m_free_joints.size(); ++j)
+	{
+		m_jacobian[j] = std::visit(
+			[&](const auto& held) -> JacobianColumn
+			{
+				if constexpr (requires { held.get_jacobian_column(m_free_transforms[j], tip); })
+					return held.get_jacobian_column(m_free_transforms[j], tip);
+				else
+					return {};
+			},
+			m_components[m_free_joints[j]]);
+	}
+	return tip;
+}
+IkResult IkSolver::iterate(const Simulation& sim, glm::vec3 target)
+{
+	load(sim);
+	IkResult result;
+	for (result.iterations = 0; result.iterations < m_settings.max_iterations; ++result.iterations)
+	{
+		glm::vec3 error = target - forward_kinematics();
+		result.error	= glm::length(error);
+		if (result.error < m_settings.tolerance)
+		{
+			result.converged = true;
+			break;
+		}
+		if (result.error > m_settings.max_step)
+			error *= m_settings.max_step / result.error;
+
+		// dq = J^T (J J^T + lambda^2 I)^-1 e, only the 3x3 system has to be inverted
+		glm::mat3 system{m_settings.damping * m_settings.damping};
+		for (const auto& column : m_jacobian)
+		{
+			system[0] += column.linear * column.linear.x;
+			system[1] += column.linear * column.linear.y;
+			system[2] += column.linear * column.linear.z;
+		}
+		glm::vec3 y = glm::inverse(system) * error;
+		for (std::size_t j = 0; j < m_free_joints.size(); ++j)
+		{
+			float& position = position_of(m_components[m_free_joints[j]]);
+			position		= std::clamp(position + glm::dot(m_jacobian[j].linear, y), m_lower[j], m_upper[j]);
+		}
+	}
+	return result;
+}
+IkResult IkSolver::solve(const Simulation& sim, glm::vec3 target, std::span<float> solution)
+{
+	auto result = iterate(sim, target);
+	// Joints that didn't take part keep their current position
+	sim.get_joint_positions(solution);
+	for (std::size_t j = 0; j < m_free_joints.size(); ++j)
+		solution[m_free_columns[j]] = position_of(m_components[m_free_joints[j]]);
+	return result;
+}
+IkResult IkSolver::solve(Simulation& sim, glm::vec3 target)
+{
+	auto result = iterate(std::as_const(sim), target);
+	for (auto p : m_free_joints)
+	{
+		std::size_t idx		 = m_path[p];
+		float		position = position_of(m_components[p]);
+		if (std::holds_alternative<Piston>(m_components[p]))
+			sim.set_piston_target_length(idx, position);
+		else if (std::holds_alternative<Hinge>(m_components[p]))
+			sim.set_hinge_target_angle(idx, position);
+		else
+			sim.set_swivel_angle(idx, position); // Only Swivels at rest are free
+	}
+	return result;
+}
@@ -0,0 +1,152 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <RobotArm/Simulation/Jacobian.hpp>
+#include <utility>
+
+namespace
+{
+// J_v J_v^T, symmetric 3x3
+glm::mat3 linear_gram(std::span<const JacobianColumn> jacobian)
+{
+	glm::mat3 gram{0.0f};
+	for (const auto& column : jacobian)
+	{
+		gram[0] += column.linear * column.linear.x;
+		gram[1] += column.linear * column.linear.y;
+		gram[2] += column.linear * column.linear.z;
+	}
+	return gram;
+}
+
+// Cyclic Jacobi eigen decomposition of a symmetric 3x3 matrix, eigenvectors end up in the columns of vectors
+void symmetric_eigen(glm::mat3 a, glm::vec3& values, glm::mat3& vectors)
+{
+	vectors = glm::mat3{1.0f};
+	for (int sweep = 0; sweep < 16; ++sweep)
+	{
+		float off_diagonal = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+		if (off_diagonal < 1e-12f)
+			break;
+		for (int p = 0; p < 2; ++p)
+		{
+			for (int q = p + 1; q < 3; ++q)
+			{
+				if (std::abs(a[p][q]) < 1e-12f)
+					continue;
+				float theta = (a[q][q] - a[p][p]) / (2.0f * a[p][q]);
+				float t		= std::copysign(1.0f, theta) / (std::abs(theta) + std::sqrt(theta * theta + 1.0f));
+				float c		= 1.0f / std::sqrt(t * t + 1.0f);
+				float s		= t * c;
+				// a = R^T a R with R the rotation in the (p, q) plane
+				for (int k = 0; k < 3; ++k)
+				{
+					float akp = a[k][p];
+					float akq = a[k][q];
+					a[k][p]	  = c * akp - s * akq;
+					a[k][q]	  = s * akp + c * akq;
+				}
+				for (int k = 0; k < 3; ++k)
+				{
+					float apk = a[p][k];
+					float aqk = a[q][k];
+					a[p][k]	  = c * apk - s * aqk;
+					a[q][k]	  = s * apk + c * aqk;
+				}
+				for (int k = 0; k < 3; ++k)
+				{
+					float vkp	  = vectors[p][k];
+					float vkq	  = vectors[q][k];
+					vectors[p][k] = c * vkp - s * vkq;
+					vectors[q][k] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+	values = {a[0][0], a[1][1], a[2][2]};
+}
+} // namespace
+
+Twist map_joint_velocities(std::span<const JacobianColumn> jacobian, std::span<const float> joint_velocities)
+{
+	assert(jacobian.size() == joint_velocities.size());
+	Twist twist{glm::vec3{0.0f}, glm::vec3{0.0f}};
+	for (std::size_t i = 0; i < jacobian.size(); ++i)
+	{
+		twist.linear += jacobian[i].linear * joint_velocities[i];
+		twist.angular += jacobian[i].angular * joint_velocities[i];
+	}
+	return twist;
+}
+float manipulability(std::span<const JacobianColumn> jacobian)
+{
+	if (jacobian.size() < 6)
+		return 0.0f; // J J^T is rank deficient
+	// Accumulate J J^T in double, the determinant of a 6x6 loses too much in float
+	std::array<std::array<double, 6>, 6> gram{};
+	for (const auto& column : jacobian)
+	{
+		std::array<double, 6> c{column.linear.x,  column.linear.y,	column.linear.z,
+								column.angular.x, column.angular.y, column.angular.z};
+		for (std::size_t row = 0; row < 6; ++row)
+		{
+			for (std::size_t col = 0; col < 6; ++col)
+			{
+				gram[row][col] += c[row] * c[col];
+			}
+		}
+	}
+	// Gaussian elimination with partial pivoting
+	double determinant = 1.0;
+	for (std::size_t pivot = 0; pivot < 6; ++pivot)
+	{
+		std::size_t best = pivot;
+		for (std::size_t row = pivot + 1; row < 6; ++row)
+		{
+			if (std::abs(gram[row][pivot]) > std::abs(gram[best][pivot]))
+				best = row;
+		}
+		if (gram[best][pivot] == 0.0)
+			return 0.0f;
+		if (best != pivot)
+		{
+			std::swap(gram[best], gram[pivot]);
+			determinant = -determinant;
+		}
+		determinant *= gram[pivot][pivot];
+		for (std::size_t row = pivot + 1; row < 6; ++row)
+		{
+			double factor = gram[row][pivot] / gram[pivot][pivot];
+			for (std::size_t col = pivot; col < 6; ++col)
+			{
+				gram[row][col] -= factor * gram[pivot][col];
+			}
+		}
+	}
+	return static_cast<float>(std::sqrt(std::max(determinant, 0.0)));
+}
+float translational_manipulability(std::span<const JacobianColumn> jacobian)
+{
+	return std::sqrt(std::max(glm::determinant(linear_gram(jacobian)), 0.0f));
+}
+VelocityEllipsoid velocity_ellipsoid(std::span<const JacobianColumn> jacobian)
+{
+	glm::vec3 values;
+	glm::mat3 vectors;
+	symmetric_eigen(linear_gram(jacobian), values, vectors);
+
+	// Sort largest first
+	std::array<int, 3> order{0, 1, 2};
+	std::ranges::sort(order, [&](int lhs, int rhs) { return values[lhs] > values[rhs]; });
+	VelocityEllipsoid ellipsoid;
+	for (int i = 0; i < 3; ++i)
+	{
+		ellipsoid.radii[i] = std::sqrt(std::max(values[order[i]], 0.0f));
+		ellipsoid.axes[i]  = vectors[order[i]];
+	}
+	return ellipsoid;
+}
@@ -0,0 +1,236 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <cmath>
+#include <RobotArm/Simulation/JointTrajectory.hpp>
+#include <stdexcept>
+
+namespace
+{
+constexpr int VELOCITY_SAMPLES = 64; // Per segment, when checking the speed limits
+
+struct JointLimits
+{
+	float speed;
+	float lower;
+	float upper;
+};
+
+std::vector<JointLimits> joint_limits(const Simulation& sim, const PlannerSettings& settings)
+{
+	std::vector<JointLimits> limits;
+	for (const auto& component : sim.get_components())
+	{
+		std::visit(
+			[&](const auto& held)
+			{
+				using T = std::decay_t<decltype(held)>;
+				if constexpr (std::same_as<T, Piston>)
+					limits.push_back({Piston::PISTON_SPEED, Piston::MIN_LENGTH, held.max_length});
+				else if constexpr (std::same_as<T, Hinge>)
+					limits.push_back({Hinge::ROTATION_SPEED, -INFINITY, INFINITY});
+				else if constexpr (std::same_as<T, Swivel>)
+					limits.push_back({settings.swivel_speed_limit, -INFINITY, INFINITY});
+			},
+			component);
+	}
+	return limits;
+}
+
+// Hermite segment from p0 to p1 with end velocities v0, v1 and zero end accelerations, in local time [0, duration]
+void hermite_coefficients(SplineOrder order, float p0, float p1, float v0, float v1, float duration, float* c,
+						  std::size_t stride)
+{
+	float delta = p1 - p0;
+	float t		= duration;
+	c[0]		= p0;
+	c[stride]	= v0;
+	if (order == SplineOrder::Cubic)
+	{
+		c[2 * stride] = (3.0f * delta - (2.0f * v0 + v1) * t) / (t * t);
+		c[3 * stride] = (-2.0f * delta + (v0 + v1) * t) / (t * t * t);
+		return;
+	}
+	c[2 * stride] = 0.0f;
+	c[3 * stride] = (20.0f * delta - (8.0f * v1 + 12.0f * v0) * t) / (2.0f * t * t * t);
+	c[4 * stride] = (-30.0f * delta + (14.0f * v1 + 16.0f * v0) * t) / (2.0f * t * t * t * t);
+	c[5 * stride] = (12.0f * delta - 6.0f * (v1 + v0) * t) / (2.0f * t * t * t * t * t);
+}
+} // namespace
+
+std::size_t JointTrajectory::find_segment(float time, std::size_t hint) const
+{
+	std::size_t count = segment_count();
+	if (count == 0)
+		return 0;
+	if (hint >= count || time < m_times[hint])
+	{
+		auto next = std::upper_bound(m_times.begin(), m_times.end() - 1, time);
+		return next == m_times.begin() ? 0 : static_cast<std::size_t>(next - m_times.begin()) - 1;
+	}
+	while (hint + 1 < count && time >= m_times[hint + 1])
+		++hint;
+	return hint;
+}
+void JointTrajectory::evaluate(std::size_t segment, float time, std::span<float> positions) const
+{
+	float		 u = std::clamp(time - m_times[segment], 0.0f, m_times[segment + 1] - m_times[segment]);
+	const float* c = m_coefficients.data() + segment * m_coefficient_count * m_stride;
+	// Horner over whole rows, every inner loop is a plain multiply add over stride floats
+	const float* highest = c + (m_coefficient_count - 1) * m_stride;
+	for (std::size_t j = 0; j < m_stride; ++j)
+		positions[j] = highest[j];
+	for (std::size_t k = m_coefficient_count - 1; k-- > 0;)
+	{
+		const float* row = c + k * m_stride;
+		for (std::size_t j = 0; j < m_stride; ++j)
+			positions[j] = positions[j] * u + row[j];
+	}
+}
+void JointTrajectory::evaluate_velocity(std::size_t segment, float time, std::span<float> velocities) const
+{
+	float		 u		 = std::clamp(time - m_times[segment], 0.0f, m_times[segment + 1] - m_times[segment]);
+	const float* c		 = m_coefficients.data() + segment * m_coefficient_count * m_stride;
+	const float* highest = c + (m_coefficient_count - 1) * m_stride;
+	auto		 order	 = static_cast<float>(m_coefficient_count - 1);
+	for (std::size_t j = 0; j < m_stride; ++j)
+		velocities[j] = order * highest[j];
+	for (std::size_t k = m_coefficient_count - 1; k-- > 1;)
+	{
+		const float* row = c + k * m_stride;
+		for (std::size_t j = 0; j < m_stride; ++j)
+			velocities[j] = velocities[j] * u + static_cast<float>(k) * row[j];
+	}
+}
+void JointTrajectory::evaluate(float time, std::span<float> positions) const
+{
+	evaluate(find_segment(time), time, positions);
+}
+
+JointTrajectory plan_trajectory(const Simulation& sim, std::span<const float> waypoints, PlannerSettings settings)
+{
+	std::size_t joints = sim.get_joint_count();
+	if (joints == 0 || waypoints.empty() || waypoints.size() % joints != 0)
+		throw std::invalid_argument("waypoints must hold get_joint_count() positions per waypoint");
+	auto limits = joint_limits(sim, settings);
+
+	// Row 0 is where the arm is now
+	std::size_t		   points = waypoints.size() / joints + 1;
+	std::vector<float> positions(points * joints);
+	sim.get_joint_positions(std::span(positions).first(joints));
+	std::ranges::copy(waypoints, positions.begin() + static_cast<std::ptrdiff_t>(joints));
+	for (std::size_t i = joints; i < positions.size(); ++i)
+	{
+		const auto& limit = limits[i % joints];
+		if (positions[i] < limit.lower || positions[i] > limit.upper)
+			throw std::invalid_argument("waypoint is outside of the joint range");
+	}
+
+	// Rest to rest peak speed of a segment is this factor times delta / duration
+	float			   peak_factor = settings.order == SplineOrder::Cubic ? 1.5f : 1.875f;
+	std::size_t		   segments	   = points - 1;
+	std::vector<float> durations(segments);
+	for (std::size_t s = 0; s < segments; ++s)
+	{
+		float duration = settings.min_segment_duration;
+		for (std::size_t j = 0; j < joints; ++j)
+		{
+			float delta = std::abs(positions[(s + 1) * joints + j] - positions[s * joints + j]);
+			duration	= std::max(duration, peak_factor * delta / limits[j].speed);
+		}
+		durations[s] = duration;
+	}
+
+	// Harmonic mean of the neighbouring slopes, zero at turning points so no segment overshoots its waypoints
+	std::vector<float> velocities(points * joints, 0.0f);
+	for (std::size_t i = 1; i + 1 < points; ++i)
+	{
+		for (std::size_t j = 0; j < joints; ++j)
+		{
+			float before = (positions[i * joints + j] - positions[(i - 1) * joints + j]) / durations[i - 1];
+			float after	 = (positions[(i + 1) * joints + j] - positions[i * joints + j]) / durations[i];
+			if (before * after > 0.0f)
+				velocities[i * joints + j] = 2.0f * before * after / (before + after);
+		}
+	}
+
+	JointTrajectory trajectory;
+	trajectory.m_joint_count	   = joints;
+	trajectory.m_stride			   = (joints + JointTrajectory::LANES - 1) / JointTrajectory::LANES * JointTrajectory::LANES;
+	trajectory.m_coefficient_count = settings.order == SplineOrder::Cubic ? 4 : 6;
+	trajectory.m_final_positions.assign(positions.end() - static_cast<std::ptrdiff_t>(joints), positions.end());
+	std::size_t segment_size	   = trajectory.m_coefficient_count * trajectory.m_stride;
+
+	auto build = [&]
+	{
+		trajectory.m_coefficients.assign(segments * segment_size, 0.0f);
+		trajectory.m_times.assign(1, 0.0f);
+		for (std::size_t s = 0; s < segments; ++s)
+		{
+			trajectory.m_times.push_back(trajectory.m_times.back() + durations[s]);
+			for (std::size_t j = 0; j < joints; ++j)
+			{
+				hermite_coefficients(settings.order, positions[s * joints + j], positions[(s + 1) * joints + j],
+									 velocities[s * joints + j], velocities[(s + 1) * joints + j], durations[s],
+									 trajectory.m_coefficients.data() + s * segment_size + j, trajectory.m_stride);
+			}
+		}
+	};
+	build();
+
+	// Interior waypoint velocities can push a segment past the limits, stretching time uniformly scales every
+	// velocity down by the same factor without changing the path
+	float			   worst = 0.0f;
+	std::vector<float> sample(trajectory.m_stride);
+	for (std::size_t s = 0; s < segments; ++s)
+	{
+		for (int k = 0; k <= VELOCITY_SAMPLES; ++k)
+		{
+			float time = trajectory.m_times[s] + durations[s] * static_cast<float>(k) / VELOCITY_SAMPLES;
+			trajectory.evaluate_velocity(s, time, sample);
+			for (std::size_t j = 0; j < joints; ++j)
+				worst = std::max(worst, std::abs(sample[j]) / limits[j].speed);
+		}
+	}
+	if (worst > 1.0f)
+	{
+		for (auto& duration : durations)
+			duration *= worst;
+		for (auto& velocity : velocities)
+			velocity /= worst;
+		build();
+	}
+	return trajectory;
+}
+
+void TrajectoryExecutor::run(Simulation& sim, JointTrajectory trajectory)
+{
+	stop(sim);
+	m_positions.resize(std::max(m_positions.size(), trajectory.stride()));
+	m_entries.push_back({&sim, std::move(trajectory)});
+}
+void TrajectoryExecutor::stop(const Simulation& sim)
+{
+	std::erase_if(m_entries, [&](const Entry& entry) { return entry.sim == &sim; });
+}
+void TrajectoryExecutor::tick(float dt)
+{
+	for (auto& entry : m_entries)
+	{
+		entry.time = std::min(entry.time + dt, entry.trajectory.duration());
+		if (entry.time >= entry.trajectory.duration())
+		{
+			entry.sim->set_joint_positions(entry.trajectory.final_positions()); // Exactly, without rounding
+			continue;
+		}
+		entry.segment = entry.trajectory.find_segment(entry.time, entry.segment);
+		entry.trajectory.evaluate(entry.segment, entry.time, m_positions);
+		entry.sim->set_joint_positions(std::span<const float>(m_positions.data(), entry.trajectory.joint_count()));
+	}
+	std::erase_if(m_entries, [](const Entry& entry) { return entry.time >= entry.trajectory.duration(); });
+}
+bool TrajectoryExecutor::is_running(const Simulation& sim) const
+{
+	return std::ranges::any_of(m_entries, [&](const Entry& entry) { return entry.sim == &sim; });
+}
@@ -0,0 +1,299 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <RobotArm/Simulation/KinematicsBatch.hpp>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && !defined(__EMSCRIPTEN__)
+#define ROBOTARM_X86_DISPATCH 1
+#endif
+
+namespace
+{
+using Step = KinematicsBatch::Step;
+
+constexpr std::size_t FRAME_FLOATS = 12; // Rotation columns x, y, z then the translation
+constexpr std::size_t TRANSLATION  = 9;
+
+// Cody-Waite split of pi/2 and minimax polynomials on [-pi/4, pi/4], the single precision ones from Cephes.
+// Branch free so the lane loop vectorizes, past MAX_ANGLE the reduction loses too many bits and the angle is clamped
+constexpr float TWO_OVER_PI = 0.636619772f;
+constexpr float HALF_PI_A	= 1.5703125f;
+constexpr float HALF_PI_B	= 4.837512969970703125e-4f;
+constexpr float HALF_PI_C	= 7.54978995489188216e-8f;
+constexpr float MAX_ANGLE	= 8192.0f;
+
+constexpr std::uint32_t SIGN_BIT = 0x80000000u;
+
+template <std::size_t W>
+void sin_cos(const float* angle, float* sin, float* cos)
+{
+	for (std::size_t l = 0; l < W; ++l)
+	{
+		auto		  bits	   = std::bit_cast<std::uint32_t>(angle[l]);
+		// Clamped on the bits, which order like the floats for positive ones. A float min here ends up as a branch
+		float		  x		   = std::bit_cast<float>(std::min(bits & ~SIGN_BIT, std::bit_cast<std::uint32_t>(MAX_ANGLE)));
+		auto		  quadrant = static_cast<std::uint32_t>(static_cast<int>(x * TWO_OVER_PI + 0.5f));
+		float		  k		   = static_cast<float>(quadrant);
+		float		  z		   = ((x - k * HALF_PI_A) - k * HALF_PI_B) - k * HALF_PI_C;
+		float		  zz	   = z * z;
+		float		  sin_z	   = ((-1.9515295891e-4f * zz + 8.3321608736e-3f) * zz - 1.6666654611e-1f) * zz * z + z;
+		float		  cos_z = ((2.443315711809948e-5f * zz - 1.388731625493765e-3f) * zz + 4.166664568298827e-2f) * zz * zz
+					 - 0.5f * zz + 1.0f;
+		// Odd quadrants swap sin and cos, the sign comes from the quadrant and for sin from the angle, all as bit masks
+		// so there is nothing to branch on
+		std::uint32_t swap = 0u - (quadrant & 1u);
+		auto sin_bits = (std::bit_cast<std::uint32_t>(sin_z) & ~swap) | (std::bit_cast<std::uint32_t>(cos_z) & swap);
+		auto cos_bits = (std::bit_cast<std::uint32_t>(cos_z) & ~swap) | (std::bit_cast<std::uint32_t>(sin_z) & swap);
+		sin[l]		  = std::bit_cast<float>(sin_bits ^ ((quadrant & 2u) << 30) ^ (bits & SIGN_BIT));
+		cos[l]		  = std::bit_cast<float>(cos_bits ^ (((quadrant + 1u) & 2u) << 30));
+	}
+}
+
+// Joint transform of a whole group, each float of RigidTransform as one entry per lane
+template <std::size_t W>
+struct Frame
+{
+	float lanes[FRAME_FLOATS][W];
+};
+
+// Lane versions of RigidTransform::translated_y
+template <std::size_t W>
+void translate_y(Frame<W>& frame, const float* distance)
+{
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	{
+		for (std::size_t l = 0; l < W; ++l)
+			frame.lanes[TRANSLATION + axis][l] += frame.lanes[3 + axis][l] * distance[l];
+	}
+}
+template <std::size_t W>
+void translate_y(Frame<W>& frame, float distance)
+{
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	{
+		for (std::size_t l = 0; l < W; ++l)
+			frame.lanes[TRANSLATION + axis][l] += frame.lanes[3 + axis][l] * distance;
+	}
+}
+// and of RigidTransform::rotated_z (columns 0 and 1) and rotated_y (columns 2 and 0)
+template <std::size_t W>
+void rotate(Frame<W>& frame, const float* angle, std::size_t first, std::size_t second)
+{
+	float sin[W];
+	float cos[W];
+	sin_cos<W>(angle, sin, cos);
+	for (std::size_t axis = 0; axis < 3; ++axis)
+	{
+		float* a = frame.lanes[first * 3 + axis];
+		float* b = frame.lanes[second * 3 + axis];
+		for (std::size_t l = 0; l < W; ++l)
+		{
+			float rotated_a = a[l] * cos[l] + b[l] * sin[l];
+			float rotated_b = b[l] * cos[l] - a[l] * sin[l];
+			a[l]			= rotated_a;
+			b[l]			= rotated_b;
+		}
+	}
+}
+
+// Same component semantics as the get_joint_transform of every component in Simulation.cpp. The frame of the previous
+// component stays local, so a serial chain never reads back what it just wrote
+template <std::size_t W>
+void compute_lanes(std::span<const Step> steps, std::size_t joint_count, const float* positions, float* joints,
+				   std::size_t group_count)
+{
+	Frame<W> base{};
+	for (std::size_t axis = 0; axis < 3; ++axis)
+		std::fill_n(base.lanes[axis * 3 + axis], W, 1.0f);
+
+	for (std::size_t group = 0; group < group_count; ++group)
+	{
+		const float* q		= positions + group * joint_count * W;
+		float*		 frames = joints + group * steps.size() * FRAME_FLOATS * W;
+		Frame<W>	 frame	= base;
+		for (std::size_t i = 0; i < steps.size(); ++i)
+		{
+			const auto& step = steps[i];
+			if (step.parent + std::size_t{1} != i)
+			{
+				if (step.parent == Simulation::NO_PARENT)
+					frame = base;
+				else
+					std::memcpy(&frame, frames + step.parent * FRAME_FLOATS * W, sizeof(frame));
+			}
+			switch (step.type)
+			{
+				case ComponentType::Piston: translate_y(frame, q + step.joint * W); break;
+				case ComponentType::Hinge: rotate(frame, q + step.joint * W, 0, 1); break;
+				case ComponentType::Swivel:
+					translate_y(frame, Swivel::JOINT_HEIGHT);
+					rotate(frame, q + step.joint * W, 2, 0);
+					break;
+				case ComponentType::Link: translate_y(frame, step.length); break;
+			}
+			std::memcpy(frames + i * FRAME_FLOATS * W, &frame, sizeof(frame));
+		}
+	}
+}
+
+#ifdef ROBOTARM_X86_DISPATCH
+// Everything is inlined into these, so the whole kernel is compiled for the wider instruction set
+[[gnu::target("avx2,fma"), gnu::flatten]] void compute_avx2(std::span<const Step> steps, std::size_t joint_count,
+															 const float* positions, float* joints, std::size_t group_count)
+{
+	compute_lanes<8>(steps, joint_count, positions, joints, group_count);
+}
+#if defined(__clang__)
+[[gnu::target("avx512f"), gnu::flatten, clang::min_vector_width(512)]]
+#else
+[[gnu::target("avx512f,prefer-vector-width=512"), gnu::flatten]]
+#endif
+void compute_avx512(std::span<const Step> steps, std::size_t joint_count, const float* positions, float* joints,
+					std::size_t group_count)
+{
+	compute_lanes<16>(steps, joint_count, positions, joints, group_count);
+}
+#endif
+
+bool cpu_supports_avx2()
+{
+#ifdef ROBOTARM_X86_DISPATCH
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+	return false;
+#endif
+}
+bool cpu_supports_avx512()
+{
+#ifdef ROBOTARM_X86_DISPATCH
+	return __builtin_cpu_supports("avx512f");
+#else
+	return false;
+#endif
+}
+} // namespace
+
+std::size_t KinematicsBatch::native_lane_count()
+{
+	if (cpu_supports_avx512())
+		return 16;
+	return cpu_supports_avx2() ? 8 : 4;
+}
+
+KinematicsBatch::KinematicsBatch(const Simulation& topology, std::size_t lane_count)
+	: m_lane_count(lane_count)
+{
+	switch (lane_count)
+	{
+		case 4: m_kernel = compute_lanes<4>; break;
+		case 8: m_kernel = compute_lanes<8>; break;
+		case 16: m_kernel = compute_lanes<16>; break;
+		default: throw std::invalid_argument("KinematicsBatch needs 4, 8 or 16 lanes");
+	}
+#ifdef ROBOTARM_X86_DISPATCH
+	if (lane_count == 8 && cpu_supports_avx2())
+		m_kernel = compute_avx2;
+	if (lane_count == 16 && cpu_supports_avx512())
+		m_kernel = compute_avx512;
+#endif
+
+	auto components = topology.get_components();
+	auto parents	= topology.get_parents();
+	m_steps.reserve(components.size());
+	for (std::size_t i = 0; i < components.size(); ++i)
+	{
+		Step step{static_cast<ComponentType>(components[i].index()), parents[i], 0, 0.0f};
+		if (const auto* link = std::get_if<Link>(&components[i]))
+			step.length = link->length;
+		else
+			step.joint = static_cast<std::uint32_t>(m_joint_count++);
+		m_steps.push_back(step);
+	}
+}
+
+std::size_t KinematicsBatch::add_arm(const Simulation& sim)
+{
+	auto components = sim.get_components();
+	auto parents	= sim.get_parents();
+	bool same		= components.size() == m_steps.size();
+	for (std::size_t i = 0; same && i < components.size(); ++i)
+	{
+		const auto* link = std::get_if<Link>(&components[i]);
+		same = static_cast<ComponentType>(components[i].index()) == m_steps[i].type && parents[i] == m_steps[i].parent
+			&& (!link || link->length == m_steps[i].length);
+	}
+	if (!same)
+		throw std::invalid_argument("Arm has a different topology than the batch");
+
+	std::vector<float> positions(m_joint_count);
+	sim.get_joint_positions(positions);
+	return add_arm(positions);
+}
+std::size_t KinematicsBatch::add_arm(std::span<const float> positions)
+{
+	if (m_arm_count % m_lane_count == 0)
+	{
+		// Unused lanes of the last group stay at zero, which is a valid pose for every component
+		m_positions.resize(m_positions.size() + m_joint_count * m_lane_count, 0.0f);
+		m_joints.resize(m_joints.size() + m_steps.size() * FRAME_FLOATS * m_lane_count);
+	}
+	set_joint_positions(m_arm_count, positions);
+	return m_arm_count++;
+}
+void KinematicsBatch::set_joint_positions(std::size_t arm, std::span<const float> positions)
+{
+	assert(positions.size() == m_joint_count);
+	float* group = m_positions.data() + arm / m_lane_count * m_joint_count * m_lane_count;
+	for (std::size_t joint = 0; joint < m_joint_count; ++joint)
+		group[joint * m_lane_count + arm % m_lane_count] = positions[joint];
+}
+void KinematicsBatch::clear()
+{
+	m_positions.clear();
+	m_joints.clear();
+	m_arm_count = 0;
+}
+
+void KinematicsBatch::compute()
+{
+	m_kernel(m_steps, m_joint_count, m_positions.data(), m_joints.data(),
+			 (m_arm_count + m_lane_count - 1) / m_lane_count);
+}
+
+const float* KinematicsBatch::lanes(std::size_t arm, std::size_t idx) const
+{
+	assert(arm < m_arm_count && idx < m_steps.size());
+	return m_joints.data() + ((arm / m_lane_count) * m_steps.size() + idx) * FRAME_FLOATS * m_lane_count
+		 + arm % m_lane_count;
+}
+RigidTransform KinematicsBatch::get_joint(std::size_t arm, std::size_t idx) const
+{
+	const float*   frame = lanes(arm, idx);
+	RigidTransform joint;
+	for (int column = 0; column < 3; ++column)
+	{
+		for (int row = 0; row < 3; ++row)
+			joint.rotation[column][row] = frame[static_cast<std::size_t>(column * 3 + row) * m_lane_count];
+	}
+	for (int axis = 0; axis < 3; ++axis)
+		joint.translation[axis] = frame[(TRANSLATION + static_cast<std::size_t>(axis)) * m_lane_count];
+	return joint;
+}
+glm::vec3 KinematicsBatch::get_tip_position(std::size_t arm) const
+{
+	if (m_steps.empty())
+		return glm::vec3{0.0f};
+	const float* frame = lanes(arm, m_steps.size() - 1) + TRANSLATION * m_lane_count;
+	return {frame[0], frame[m_lane_count], frame[2 * m_lane_count]};
+}
+void KinematicsBatch::get_tip_positions(std::span<glm::vec3> positions) const
+{
+	assert(positions.size() == m_arm_count);
+	for (std::size_t arm = 0; arm < m_arm_count; ++arm)
+		positions[arm] = get_tip_position(arm);
+}
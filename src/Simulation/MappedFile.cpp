@@ -0,0 +1,94 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <cerrno>
+#include <fcntl.h>
+#include <RobotArm/Simulation/MappedFile.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace
+{
+[[noreturn]] void throw_errno(const std::string& what)
+{
+	throw std::system_error(errno, std::generic_category(), what);
+}
+} // namespace
+
+MappedFile::~MappedFile()
+{
+	unmap();
+	if (m_fd >= 0)
+		::close(m_fd);
+}
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: m_fd(std::exchange(other.m_fd, -1))
+	, m_data(std::exchange(other.m_data, nullptr))
+	, m_size(std::exchange(other.m_size, 0))
+	, m_writable(other.m_writable)
+{
+}
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		MappedFile old(std::move(*this));
+		m_fd	   = std::exchange(other.m_fd, -1);
+		m_data	   = std::exchange(other.m_data, nullptr);
+		m_size	   = std::exchange(other.m_size, 0);
+		m_writable = other.m_writable;
+	}
+	return *this;
+}
+void MappedFile::map()
+{
+	if (m_size == 0)
+		return; // mmap rejects empty mappings
+	int	  protection = m_writable ? PROT_READ | PROT_WRITE : PROT_READ;
+	void* data		 = ::mmap(nullptr, m_size, protection, MAP_SHARED, m_fd, 0);
+	if (data == MAP_FAILED)
+		throw_errno("mmap");
+	m_data = static_cast<std::byte*>(data);
+}
+void MappedFile::unmap()
+{
+	if (m_data)
+		::munmap(m_data, m_size);
+	m_data = nullptr;
+}
+MappedFile MappedFile::open_read(const std::filesystem::path& path)
+{
+	MappedFile file;
+	file.m_fd = ::open(path.c_str(), O_RDONLY);
+	if (file.m_fd < 0)
+		throw_errno("could not open " + path.string());
+	struct stat status{};
+	if (::fstat(file.m_fd, &status) != 0)
+		throw_errno("fstat " + path.string());
+	file.m_size = static_cast<std::size_t>(status.st_size);
+	file.map();
+	return file;
+}
+MappedFile MappedFile::create(const std::filesystem::path& path, std::size_t size)
+{
+	MappedFile file;
+	file.m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (file.m_fd < 0)
+		throw_errno("could not create " + path.string());
+	file.m_writable = true;
+	file.resize(size);
+	return file;
+}
+void MappedFile::resize(std::size_t size)
+{
+	if (!m_writable)
+		throw std::system_error(std::make_error_code(std::errc::permission_denied), "resize of a read only mapping");
+	unmap();
+	if (::ftruncate(m_fd, static_cast<off_t>(size)) != 0)
+		throw_errno("ftruncate");
+	m_size = size;
+	map();
+}
@@ -0,0 +1,287 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <RobotArm/Simulation/Jacobian.hpp>
+#include <RobotArm/Simulation/ReachabilityMap.hpp>
+#include <RobotArm/Simulation/ThreadPool.hpp>
+#include <stdexcept>
+#include <unordered_map>
+
+static_assert(std::endian::native == std::endian::little, "Reachability maps are written in native byte order");
+
+namespace
+{
+constexpr char			MAGIC[8] = {'R', 'A', 'R', 'E', 'A', 'C', 'H', '\0'};
+constexpr std::uint32_t VERSION	 = 1;
+// More partitions than threads so a slow one doesn't hold up the merge
+constexpr std::size_t PARTITIONS_PER_THREAD = 4;
+
+struct FileHeader
+{
+	char		  magic[8];
+	std::uint32_t version;
+	float		  voxel_size;
+	std::uint64_t sample_count;
+	std::uint64_t voxel_count;
+};
+static_assert(sizeof(FileHeader) == 32);
+static_assert(sizeof(FileHeader) % alignof(ReachabilityVoxel) == 0);
+
+struct JointRange
+{
+	float lower;
+	float upper;
+};
+
+struct VoxelAccumulator
+{
+	std::uint32_t hits				 = 0;
+	float		  min_manipulability = std::numeric_limits<float>::infinity();
+	float		  max_manipulability = 0.0f;
+	double		  manipulability_sum = 0.0;
+
+	void add(float manipulability)
+	{
+		++hits;
+		min_manipulability = std::min(min_manipulability, manipulability);
+		max_manipulability = std::max(max_manipulability, manipulability);
+		manipulability_sum += manipulability;
+	}
+	void merge(const VoxelAccumulator& other)
+	{
+		hits += other.hits;
+		min_manipulability = std::min(min_manipulability, other.min_manipulability);
+		max_manipulability = std::max(max_manipulability, other.max_manipulability);
+		manipulability_sum += other.manipulability_sum;
+	}
+};
+
+using VoxelGrid = std::unordered_map<std::uint64_t, VoxelAccumulator>;
+
+std::vector<JointRange> joint_ranges(const Simulation& sim, const ReachabilitySettings& settings)
+{
+	std::vector<JointRange> ranges;
+	for (const auto& component : sim.get_components())
+	{
+		if (const auto* piston = std::get_if<Piston>(&component))
+			ranges.push_back({Piston::MIN_LENGTH, piston->max_length});
+		else if (std::holds_alternative<Hinge>(component))
+			ranges.push_back({-settings.hinge_limit, settings.hinge_limit});
+		else if (std::holds_alternative<Swivel>(component))
+			ranges.push_back({-std::numbers::pi_v<float>, std::numbers::pi_v<float>});
+	}
+	return ranges;
+}
+
+// splitmix64 of the sample index alone, so partitions can be run in any order on any thread
+std::uint64_t hash(std::uint64_t seed, std::uint64_t sample, std::size_t joint)
+{
+	std::uint64_t x = seed * 0x9e3779b97f4a7c15ull + sample * 0xbf58476d1ce4e5b9ull + joint * 0x94d049bb133111ebull;
+	x				= (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+	x				= (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+	return x ^ (x >> 31);
+}
+
+// Uniform in [0, 1)
+double uniform(std::uint64_t seed, std::uint64_t sample, std::size_t joint)
+{
+	return static_cast<double>(hash(seed, sample, joint) >> 11) * 0x1.0p-53;
+}
+
+// Permutation of [0, count) picked by key. Every step is a bijection on the next power of two, values that land
+// past count are mapped again until they are back in range (cycle walking, fewer than two rounds on average)
+std::uint64_t permute(std::uint64_t index, std::uint64_t count, std::uint64_t key)
+{
+	std::uint64_t mask	= std::bit_ceil(count) - 1;
+	auto		  shift = std::max<int>(static_cast<int>(std::bit_width(mask)) / 2, 1);
+	do
+	{
+		index = ((index ^ key) * 0x9e3779b97f4a7c15ull) & mask;
+		index ^= index >> shift;
+		index = ((index + (key >> 32)) * 0xbf58476d1ce4e5b9ull) & mask;
+		index ^= index >> shift;
+	} while (index >= count);
+	return index;
+}
+
+// Spreads the lower 21 bits of value out to every third bit
+std::uint64_t spread_bits(std::uint64_t value)
+{
+	value &= 0x1fffff;
+	value = (value | value << 32) & 0x1f00000000ffffull;
+	value = (value | value << 16) & 0x1f0000ff0000ffull;
+	value = (value | value << 8) & 0x100f00f00f00f00full;
+	value = (value | value << 4) & 0x10c30c30c30c30c3ull;
+	value = (value | value << 2) & 0x1249249249249249ull;
+	return value;
+}
+std::uint64_t compact_bits(std::uint64_t value)
+{
+	value &= 0x1249249249249249ull;
+	value = (value ^ (value >> 2)) & 0x10c30c30c30c30c3ull;
+	value = (value ^ (value >> 4)) & 0x100f00f00f00f00full;
+	value = (value ^ (value >> 8)) & 0x1f0000ff0000ffull;
+	value = (value ^ (value >> 16)) & 0x1f00000000ffffull;
+	value = (value ^ (value >> 32)) & 0x1fffff;
+	return value;
+}
+
+// False if the position is outside the 2^21 voxels per axis the Morton code can address
+bool voxel_of(glm::vec3 position, float voxel_size, glm::ivec3& out)
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float voxel = std::floor(position[axis] / voxel_size);
+		if (!(std::abs(voxel) < static_cast<float>(ReachabilityMap::MORTON_OFFSET)))
+			return false;
+		out[axis] = static_cast<int>(voxel);
+	}
+	return true;
+}
+
+void sample_partition(const Simulation& sim, const ReachabilitySettings& settings, std::span<const JointRange> ranges,
+					  std::uint64_t begin, std::uint64_t end, VoxelGrid& grid)
+{
+	Simulation					arm		   = sim;
+	std::size_t					joints	   = ranges.size();
+	bool						stratified = settings.sampling == ReachabilitySampling::Stratified;
+	std::vector<float>			positions(joints);
+	std::vector<JacobianColumn> jacobian(joints);
+	// Every joint walks its strata in its own order, otherwise all joints would move in lockstep
+	std::vector<std::uint64_t> keys(joints);
+	for (std::size_t j = 0; j < joints; ++j)
+		keys[j] = hash(settings.seed, settings.samples, j);
+	for (std::uint64_t sample = begin; sample < end; ++sample)
+	{
+		for (std::size_t j = 0; j < joints; ++j)
+		{
+			double u = uniform(settings.seed, sample, j);
+			if (stratified)
+				u = (static_cast<double>(permute(sample, settings.samples, keys[j])) + u)
+				  / static_cast<double>(settings.samples);
+			positions[j] = ranges[j].lower + (ranges[j].upper - ranges[j].lower) * static_cast<float>(u);
+		}
+		arm.set_joint_positions(positions);
+		auto	  chain = arm.get_chain();
+		glm::vec3 tip	= chain.empty() ? glm::vec3{0.0f} : chain.back().translation;
+
+		glm::ivec3 voxel;
+		if (!voxel_of(tip, settings.voxel_size, voxel))
+			continue;
+		arm.get_jacobian(jacobian);
+		grid[ReachabilityMap::morton_encode(voxel)].add(translational_manipulability(jacobian));
+	}
+}
+} // namespace
+
+ReachabilityMap ReachabilityMap::generate(const Simulation& sim, ReachabilitySettings settings)
+{
+	if (!(settings.voxel_size > 0.0f))
+		throw std::invalid_argument("voxel_size must be positive");
+	auto		  ranges  = joint_ranges(sim, settings);
+	std::uint64_t samples = settings.samples;
+
+	ThreadPool			   pool(settings.thread_count);
+	std::size_t			   partition_count = std::max<std::size_t>(pool.thread_count() * PARTITIONS_PER_THREAD, 1);
+	std::vector<VoxelGrid> grids(partition_count);
+	pool.parallel_for(partition_count, 1,
+					  [&](std::size_t begin, std::size_t end)
+					  {
+						  for (std::size_t partition = begin; partition < end; ++partition)
+							  sample_partition(sim, settings, ranges, samples * partition / partition_count,
+											   samples * (partition + 1) / partition_count, grids[partition]);
+					  });
+
+	// Merge in partition order so the sums don't depend on which thread finished first
+	VoxelGrid merged = std::move(grids.front());
+	for (std::size_t partition = 1; partition < partition_count; ++partition)
+	{
+		for (const auto& [morton, accumulator] : grids[partition])
+			merged[morton].merge(accumulator);
+		VoxelGrid{}.swap(grids[partition]);
+	}
+
+	ReachabilityMap map;
+	map.m_voxel_size   = settings.voxel_size;
+	map.m_sample_count = samples;
+	map.m_owned.reserve(merged.size());
+	for (const auto& [morton, accumulator] : merged)
+	{
+		map.m_owned.push_back({morton, accumulator.hits, accumulator.min_manipulability,
+							   static_cast<float>(accumulator.manipulability_sum / accumulator.hits),
+							   accumulator.max_manipulability});
+	}
+	std::ranges::sort(map.m_owned, {}, &ReachabilityVoxel::morton);
+	map.m_voxels = map.m_owned;
+	return map;
+}
+ReachabilityMap ReachabilityMap::load(const std::filesystem::path& path)
+{
+	ReachabilityMap map;
+	map.m_file = MappedFile::open_read(path);
+	auto	   bytes = map.m_file.bytes();
+	FileHeader header;
+	if (bytes.size() < sizeof(header))
+		throw std::runtime_error(path.string() + " is not a reachability map");
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+		throw std::runtime_error(path.string() + " is not a reachability map");
+	if (header.voxel_count > (bytes.size() - sizeof(header)) / sizeof(ReachabilityVoxel))
+		throw std::runtime_error(path.string() + " is truncated");
+
+	map.m_voxel_size   = header.voxel_size;
+	map.m_sample_count = header.sample_count;
+	// The mapping is page aligned and the header keeps the voxels aligned after it
+	map.m_voxels = {reinterpret_cast<const ReachabilityVoxel*>(bytes.data() + sizeof(header)),
+					static_cast<std::size_t>(header.voxel_count)};
+	return map;
+}
+void ReachabilityMap::save(const std::filesystem::path& path) const
+{
+	FileHeader header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version		= VERSION;
+	header.voxel_size	= m_voxel_size;
+	header.sample_count = m_sample_count;
+	header.voxel_count	= m_voxels.size();
+
+	auto file  = MappedFile::create(path, sizeof(header) + m_voxels.size_bytes());
+	auto bytes = file.bytes();
+	std::memcpy(bytes.data(), &header, sizeof(header));
+	if (!m_voxels.empty())
+		std::memcpy(bytes.data() + sizeof(header), m_voxels.data(), m_voxels.size_bytes());
+}
+const ReachabilityVoxel* ReachabilityMap::find(glm::vec3 position) const
+{
+	glm::ivec3 voxel;
+	if (m_voxels.empty() || !voxel_of(position, m_voxel_size, voxel))
+		return nullptr;
+	auto morton = morton_encode(voxel);
+	auto it		= std::ranges::lower_bound(m_voxels, morton, {}, &ReachabilityVoxel::morton);
+	return it != m_voxels.end() && it->morton == morton ? &*it : nullptr;
+}
+glm::vec3 ReachabilityMap::voxel_center(std::uint64_t morton) const
+{
+	auto voxel = morton_decode(morton);
+	return glm::vec3{static_cast<float>(voxel.x) + 0.5f, static_cast<float>(voxel.y) + 0.5f,
+					 static_cast<float>(voxel.z) + 0.5f}
+		 * m_voxel_size;
+}
+std::uint64_t ReachabilityMap::morton_encode(glm::ivec3 voxel)
+{
+	return spread_bits(static_cast<std::uint64_t>(voxel.x + MORTON_OFFSET))
+		 | spread_bits(static_cast<std::uint64_t>(voxel.y + MORTON_OFFSET)) << 1
+		 | spread_bits(static_cast<std::uint64_t>(voxel.z + MORTON_OFFSET)) << 2;
+}
+glm::ivec3 ReachabilityMap::morton_decode(std::uint64_t morton)
+{
+	return {static_cast<int>(compact_bits(morton)) - MORTON_OFFSET,
+			static_cast<int>(compact_bits(morton >> 1)) - MORTON_OFFSET,
+			static_cast<int>(compact_bits(morton >> 2)) - MORTON_OFFSET};
+}
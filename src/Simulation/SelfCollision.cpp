@@ -0,0 +1,234 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <cmath>
+#include <RobotArm/Simulation/SelfCollision.hpp>
+
+namespace
+{
+// Sizes of the meshes Scene draws, see Renderer and Scene::submit_to
+constexpr float LINK_RADIUS	  = 0.15f; // Unit cube scaled to 0.3 wide
+constexpr float PISTON_RADIUS = 0.3f;  // Unit radius cylinder scaled by 0.3
+constexpr float SWIVEL_RADIUS = 0.35f;
+constexpr float SWIVEL_HALF	  = 0.15f; // Unit height cylinder scaled to 0.3 tall, centered on its parent
+constexpr float HINGE_RADIUS  = 0.33f;
+constexpr float EPSILON		  = 1e-8f;
+
+constexpr std::size_t NARROWPHASE_BLOCK = 64;
+
+bool overlaps(const glm::vec3& min_a, const glm::vec3& max_a, const glm::vec3& min_b, const glm::vec3& max_b)
+{
+	return min_a.x <= max_b.x && min_b.x <= max_a.x && min_a.y <= max_b.y && min_b.y <= max_a.y && min_a.z <= max_b.z
+		&& min_b.z <= max_a.z;
+}
+// Same as std::clamp(f, 0, 1) up to rounding. Written with abs so the compiler can't split the narrowphase loop into
+// branches for the clamped cases, which std::clamp and std::min/max both end up as
+float clamp01(float f)
+{
+	return 0.5f * (std::abs(f) - std::abs(f - 1.0f) + 1.0f);
+}
+float dot(float ax, float ay, float az, float bx, float by, float bz)
+{
+	return ax * bx + ay * by + az * bz;
+}
+} // namespace
+
+Capsule make_capsule(const Component& component, const RigidTransform& parent, const RigidTransform& joint,
+					 float arc_start)
+{
+	return std::visit(
+		[&](const auto& held) -> Capsule
+		{
+			using T = std::decay_t<decltype(held)>;
+			if constexpr (std::same_as<T, Link> || std::same_as<T, Piston>)
+			{
+				float length;
+				if constexpr (std::same_as<T, Link>)
+					length = held.length;
+				else
+					length = held.current_length;
+				return {parent.translation, joint.translation, std::same_as<T, Link> ? LINK_RADIUS : PISTON_RADIUS,
+						arc_start, arc_start + length};
+			}
+			else if constexpr (std::same_as<T, Swivel>)
+			{
+				glm::vec3 up = parent.rotation[1] * SWIVEL_HALF;
+				return {parent.translation - up, parent.translation + up, SWIVEL_RADIUS, arc_start - SWIVEL_HALF,
+						arc_start + SWIVEL_HALF};
+			}
+			else
+				return {joint.translation, joint.translation, HINGE_RADIUS, arc_start, arc_start};
+		},
+		component);
+}
+
+void SelfCollisionDetector::build_capsules(const Simulation& sim)
+{
+	auto components = sim.get_components();
+	auto chain		= sim.get_chain();
+	auto parents	= sim.get_parents();
+	m_capsules.resize(components.size());
+	m_parents.assign(parents.begin(), parents.end());
+	m_is_serial = sim.is_serial();
+
+	const RigidTransform base;
+	for (std::size_t i = 0; i < components.size(); ++i)
+	{
+		const auto& parent = parents[i] == Simulation::NO_PARENT ? base : chain[parents[i]];
+		// Arc length continues from where the parent ended, so it measures the path from the base
+		float arc	  = parents[i] == Simulation::NO_PARENT ? 0.0f : m_capsules[parents[i]].arc_end;
+		m_capsules[i] = make_capsule(components[i], parent, chain[i], arc);
+	}
+}
+float SelfCollisionDetector::path_length_between(std::uint32_t low, std::uint32_t high) const
+{
+	const auto& a = m_capsules[low];
+	const auto& b = m_capsules[high];
+	if (m_is_serial)
+		return b.arc_start - a.arc_end;
+	// Climb to the closest common ancestor, parents always have the smaller index
+	std::uint32_t x = low, y = high;
+	while (x != y && x != Simulation::NO_PARENT && y != Simulation::NO_PARENT)
+	{
+		if (x > y)
+			x = m_parents[x];
+		else
+			y = m_parents[y];
+	}
+	if (x == y && x == low)
+		return b.arc_start - a.arc_end; // low is on the path to high
+	// Different branches, or different roots which only meet at the base
+	float fork = x == y && x != Simulation::NO_PARENT ? m_capsules[x].arc_end : 0.0f;
+	return (a.arc_start - fork) + (b.arc_start - fork);
+}
+void SelfCollisionDetector::broadphase()
+{
+	std::size_t count = m_capsules.size();
+	if (m_bounds.size() != count)
+	{
+		m_bounds.resize(count);
+		for (std::uint32_t i = 0; i < count; ++i)
+			m_bounds[i].capsule = i;
+	}
+	glm::vec3 mean{0.0f}, mean_squared{0.0f};
+	for (auto& bounds : m_bounds)
+	{
+		const auto& capsule = m_capsules[bounds.capsule];
+		bounds.min			= glm::min(capsule.a, capsule.b) - glm::vec3(capsule.radius);
+		bounds.max			= glm::max(capsule.a, capsule.b) + glm::vec3(capsule.radius);
+		glm::vec3 center	= (capsule.a + capsule.b) * 0.5f;
+		mean += center;
+		mean_squared += center * center;
+	}
+	// Sweep along the axis with the most spread, a straight arm along one axis would overlap everywhere on the others
+	mean /= static_cast<float>(count);
+	glm::vec3 variance = mean_squared / static_cast<float>(count) - mean * mean;
+	int		  axis	   = variance.x > variance.y ? (variance.x > variance.z ? 0 : 2) : (variance.y > variance.z ? 1 : 2);
+
+	// Insertion sort, the order from the previous call is nearly sorted already
+	for (std::size_t i = 1; i < count; ++i)
+	{
+		Bounds moving = m_bounds[i];
+		auto   j	  = i;
+		for (; j > 0 && m_bounds[j - 1].min[axis] > moving.min[axis]; --j)
+			m_bounds[j] = m_bounds[j - 1];
+		m_bounds[j] = moving;
+	}
+
+	m_pairs.clear();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const auto& first = m_bounds[i];
+		for (std::size_t k = i + 1; k < count && m_bounds[k].min[axis] <= first.max[axis]; ++k)
+		{
+			const auto& second = m_bounds[k];
+			if (!overlaps(first.min, first.max, second.min, second.max))
+				continue;
+			auto		low	 = std::min(first.capsule, second.capsule);
+			auto		high = std::max(first.capsule, second.capsule);
+			const auto& a	 = m_capsules[low];
+			const auto& b	 = m_capsules[high];
+			if (path_length_between(low, high) < a.radius + b.radius)
+				continue; // Touching by construction
+			m_pairs.push_back({low, high});
+		}
+	}
+}
+void SelfCollisionDetector::narrowphase()
+{
+	m_contacts.clear();
+	for (std::size_t begin = 0; begin < m_pairs.size(); begin += NARROWPHASE_BLOCK)
+	{
+		std::size_t count = std::min(NARROWPHASE_BLOCK, m_pairs.size() - begin);
+		// Segment p + s * d against q + t * e, gathered into local arrays so the distance loop can't alias anything
+		float px[NARROWPHASE_BLOCK], py[NARROWPHASE_BLOCK], pz[NARROWPHASE_BLOCK];
+		float dx[NARROWPHASE_BLOCK], dy[NARROWPHASE_BLOCK], dz[NARROWPHASE_BLOCK];
+		float qx[NARROWPHASE_BLOCK], qy[NARROWPHASE_BLOCK], qz[NARROWPHASE_BLOCK];
+		float ex[NARROWPHASE_BLOCK], ey[NARROWPHASE_BLOCK], ez[NARROWPHASE_BLOCK];
+		float s[NARROWPHASE_BLOCK], t[NARROWPHASE_BLOCK], distance_squared[NARROWPHASE_BLOCK];
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const auto& first  = m_capsules[m_pairs[begin + i].first];
+			const auto& second = m_capsules[m_pairs[begin + i].second];
+			px[i] = first.a.x, py[i] = first.a.y, pz[i] = first.a.z;
+			dx[i] = first.b.x - first.a.x, dy[i] = first.b.y - first.a.y, dz[i] = first.b.z - first.a.z;
+			qx[i] = second.a.x, qy[i] = second.a.y, qz[i] = second.a.z;
+			ex[i] = second.b.x - second.a.x, ey[i] = second.b.y - second.a.y, ez[i] = second.b.z - second.a.z;
+		}
+
+		// Closest points of two segments (Ericson, Real-Time Collision Detection 5.1.9) without any branches, so the
+		// loop can run over several pairs per instruction
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			float rx = px[i] - qx[i], ry = py[i] - qy[i], rz = pz[i] - qz[i];
+			float a = dot(dx[i], dy[i], dz[i], dx[i], dy[i], dz[i]);
+			float e = dot(ex[i], ey[i], ez[i], ex[i], ey[i], ez[i]);
+			float b = dot(dx[i], dy[i], dz[i], ex[i], ey[i], ez[i]);
+			float c = dot(dx[i], dy[i], dz[i], rx, ry, rz);
+			float f = dot(ex[i], ey[i], ez[i], rx, ry, rz);
+
+			// A degenerate segment (a Hinge sphere) has zero length and zero dot products, so the numerators vanish
+			// along with the denominators and bounding those away from zero is enough. For parallel segments any
+			// start s works.
+			float denominator = a * e - b * b;
+			float closest_s	  = clamp01((b * f - c * e) / std::max(denominator, EPSILON));
+			float closest_t	  = clamp01((b * closest_s + f) / std::max(e, EPSILON));
+			closest_s		  = clamp01((b * closest_t - c) / std::max(a, EPSILON));
+
+			float x				= rx + dx[i] * closest_s - ex[i] * closest_t;
+			float y				= ry + dy[i] * closest_s - ey[i] * closest_t;
+			float z				= rz + dz[i] * closest_s - ez[i] * closest_t;
+			s[i]				= closest_s;
+			t[i]				= closest_t;
+			distance_squared[i] = x * x + y * y + z * z;
+		}
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			auto [first_idx, second_idx] = m_pairs[begin + i];
+			const auto& first			 = m_capsules[first_idx];
+			const auto& second			 = m_capsules[second_idx];
+			float		radius_sum		 = first.radius + second.radius;
+			if (distance_squared[i] >= radius_sum * radius_sum)
+				continue;
+			glm::vec3 on_first	= first.a + (first.b - first.a) * s[i];
+			glm::vec3 on_second = second.a + (second.b - second.a) * t[i];
+			m_contacts.push_back({first_idx, second_idx, radius_sum - std::sqrt(distance_squared[i]),
+								  (on_first + on_second) * 0.5f});
+		}
+	}
+}
+std::span<const SelfContact> SelfCollisionDetector::detect(const Simulation& sim)
+{
+	build_capsules(sim);
+	if (m_capsules.size() < 3)
+	{
+		m_contacts.clear();
+		m_pairs.clear();
+		return m_contacts;
+	}
+	broadphase();
+	narrowphase();
+	return m_contacts;
+}
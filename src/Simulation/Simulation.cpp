@@ -4,16 +4,44 @@
 #include <algorithm>
 #include <glm/ext/matrix_transform.hpp>
 #include <ranges>
+#include <RobotArm/Simulation/SelfCollision.hpp>
 #include <RobotArm/Simulation/Simulation.hpp>
+#include <RobotArm/Simulation/ThreadPool.hpp>
+#include <stdexcept>
+#include <thread>
 #include <utility>
 
 // TODO Rework this, Piston (change length), Swivel (change Y-Axis rot), Hinge (change X-Axis rot), Link (fixed length)
 
-void Piston::tick(float dt)
+void TipVelocityAccumulator::add_linear(glm::vec3 velocity)
 {
-	float delta = target_length - current_length;
+	m_linear += velocity;
+}
+void TipVelocityAccumulator::add_angular(glm::vec3 pivot, glm::vec3 omega)
+{
+	m_angular += omega;
+	m_moment += glm::cross(omega, pivot);
+}
+glm::vec3 TipVelocityAccumulator::velocity_at(glm::vec3 tip) const
+{
+	// We spin most really far out and at a 90° angle for example
+	return m_linear + glm::cross(m_angular, tip) - m_moment;
+}
+
+MassProperties MassProperties::rod(float mass, float length)
+{
+	float across = mass * length * length / 12.0f;
+	glm::mat3 inertia{glm::vec3{across, 0.0f, 0.0f}, glm::vec3{0.0f}, glm::vec3{0.0f, 0.0f, across}};
+	return {mass, {0.0f, -length / 2.0f, 0.0f}, inertia};
+}
+
+bool Piston::tick(float dt)
+{
+	float previous = current_length;
+	float delta	   = target_length - current_length;
 	current_length += std::clamp(delta, -PISTON_SPEED * dt, PISTON_SPEED * dt);
 	current_length = std::clamp(current_length, MIN_LENGTH, max_length);
+	return current_length != previous;
 }
 ModelMatrixChainOutput Piston::get_model_matrix(glm::mat4 joint_matrix) const
 {
@@ -25,20 +53,71 @@ ModelMatrixChainOutput Piston::get_model_matrix(glm::mat4 joint_matrix) const
 	joint_matrix = glm::translate(joint_matrix, glm::vec3(0, current_length, 0));
 	return {segment, joint_matrix};
 }
-void Hinge::tick(float dt)
+RigidTransform Piston::get_joint_transform(const RigidTransform& parent) const
+{
+	return parent.translated_y(current_length);
+}
+glm::mat4 Piston::emit_model_matrix(const RigidTransform& parent, const RigidTransform&) const
+{
+	return parent.translated_y(current_length / 2.0f).to_mat4({0.3f, current_length, 0.3f});
+}
+float Piston::velocity() const
+{
+	// tick() pins the length to the stroke, a target past either end is as far as it gets
+	float reachable = std::clamp(target_length, MIN_LENGTH, max_length);
+	if (current_length == reachable)
+		return 0.0f; // Not moving if we reached target
+	return (static_cast<float>(current_length < reachable) - 0.5f) * 2.0f * PISTON_SPEED;
+}
+void Piston::add_tip_velocity(TipVelocityAccumulator& accumulator, const RigidTransform& joint) const
+{
+	if (auto speed = velocity(); speed != 0)
+		accumulator.add_linear(joint.rotation[1] * speed);
+}
+JacobianColumn Piston::get_jacobian_column(const RigidTransform& joint, glm::vec3) const
+{
+	return {joint.rotation[1], glm::vec3{0.0f}};
+}
+bool Hinge::tick(float dt)
 {
 	float delta = target_angle - current_angle;
 	current_angle += std::clamp(delta, -ROTATION_SPEED * dt, ROTATION_SPEED * dt);
+	return delta != 0;
 }
 ModelMatrixChainOutput Hinge::get_model_matrix(glm::mat4 joint_matrix) const
 {
 	joint_matrix = glm::rotate(joint_matrix, current_angle, glm::vec3(0, 0, 1));
 	return {joint_matrix, joint_matrix};
 }
+RigidTransform Hinge::get_joint_transform(const RigidTransform& parent) const
+{
+	return parent.rotated_z(current_angle);
+}
+glm::mat4 Hinge::emit_model_matrix(const RigidTransform&, const RigidTransform& joint) const
+{
+	return joint.to_mat4();
+}
+float Hinge::velocity() const
+{
+	if (current_angle == target_angle)
+		return 0.0f; // Not moving if we reached target
+	return (target_angle > current_angle) ? ROTATION_SPEED : -ROTATION_SPEED;
+}
+void Hinge::add_tip_velocity(TipVelocityAccumulator& accumulator, const RigidTransform& joint) const
+{
+	if (auto speed = velocity(); speed != 0)
+		accumulator.add_angular(joint.translation, joint.rotation[2] * speed);
+}
+JacobianColumn Hinge::get_jacobian_column(const RigidTransform& joint, glm::vec3 tip) const
+{
+	return {glm::cross(joint.rotation[2], tip - joint.translation), joint.rotation[2]};
+}
 
-void Swivel::tick(float dt)
+bool Swivel::tick(float dt)
 {
-	angle = std::fmod(angle + rotational_speed * dt, 3.141592f * 2.0f); // No overflow by staying in [0, 2pi)
+	float previous = angle;
+	angle		   = std::fmod(angle + rotational_speed * dt, 3.141592f * 2.0f); // No overflow by staying in [0, 2pi)
+	return angle != previous;
 }
 ModelMatrixChainOutput Swivel::get_model_matrix(glm::mat4 joint_matrix) const
 {
@@ -51,6 +130,23 @@ ModelMatrixChainOutput Swivel::get_model_matrix(glm::mat4 joint_matrix) const
 
 	return {model_matrix, joint_matrix};
 }
+RigidTransform Swivel::get_joint_transform(const RigidTransform& parent) const
+{
+	return parent.translated_y(JOINT_HEIGHT).rotated_y(angle);
+}
+glm::mat4 Swivel::emit_model_matrix(const RigidTransform& parent, const RigidTransform&) const
+{
+	return parent.to_mat4({0.35f, 0.3f, 0.35f});
+}
+void Swivel::add_tip_velocity(TipVelocityAccumulator& accumulator, const RigidTransform& joint) const
+{
+	if (rotational_speed != 0)
+		accumulator.add_angular(joint.translation, joint.rotation[1] * rotational_speed);
+}
+JacobianColumn Swivel::get_jacobian_column(const RigidTransform& joint, glm::vec3 tip) const
+{
+	return {glm::cross(joint.rotation[1], tip - joint.translation), joint.rotation[1]};
+}
 ModelMatrixChainOutput Link::get_model_matrix(glm::mat4 joint_matrix) const
 {
 	// Translate since the scale stretches the segment in both directions
@@ -61,20 +157,304 @@ ModelMatrixChainOutput Link::get_model_matrix(glm::mat4 joint_matrix) const
 	joint_matrix = glm::translate(joint_matrix, glm::vec3(0, length, 0));
 	return {segment, joint_matrix};
 }
-void Component::tick(float dt)
+RigidTransform Link::get_joint_transform(const RigidTransform& parent) const
+{
+	return parent.translated_y(length);
+}
+glm::mat4 Link::emit_model_matrix(const RigidTransform& parent, const RigidTransform&) const
 {
-	std::visit([=](auto& held) { return held.tick(dt); }, *this);
+	return parent.translated_y(length / 2.0f).to_mat4({0.3f, length, 0.3f});
+}
+bool Component::tick(float dt)
+{
+	return std::visit([=](auto& held) { return held.tick(dt); }, *this);
 }
 ModelMatrixChainOutput Component::get_model_matrix(glm::mat4 joint_matrix) const
 {
 	return std::visit([=](const auto& held) { return held.get_model_matrix(joint_matrix); }, *this);
 }
+RigidTransform Component::get_joint_transform(const RigidTransform& parent) const
+{
+	return std::visit([&](const auto& held) { return held.get_joint_transform(parent); }, *this);
+}
+glm::mat4 Component::emit_model_matrix(const RigidTransform& parent, const RigidTransform& joint) const
+{
+	return std::visit([&](const auto& held) { return held.emit_model_matrix(parent, joint); }, *this);
+}
+void Component::add_tip_velocity(TipVelocityAccumulator& accumulator, const RigidTransform& joint) const
+{
+	std::visit([&](const auto& held) { held.add_tip_velocity(accumulator, joint); }, *this);
+}
+bool Component::is_moving() const
+{
+	return std::visit(
+		[](const auto& held)
+		{
+			if constexpr (requires { held.velocity(); })
+				return held.velocity() != 0.0f;
+			else
+				return false;
+		},
+		*this);
+}
+float Component::velocity() const
+{
+	return std::visit(
+		[](const auto& held)
+		{
+			if constexpr (requires { held.velocity(); })
+				return held.velocity();
+			else
+				return 0.0f;
+		},
+		*this);
+}
+JacobianColumn Component::get_joint_axis(const RigidTransform& joint) const
+{
+	return std::visit(
+		[&](const auto& held)
+		{
+			if constexpr (requires { held.get_jacobian_column(joint, joint.translation); })
+				return held.get_jacobian_column(joint, joint.translation);
+			else
+				return JacobianColumn{glm::vec3{0.0f}, glm::vec3{0.0f}};
+		},
+		*this);
+}
+
+namespace
+{
+// Motion of a joint frame from the motion of its parent frame. The joint origin is fixed in the parent body, only a
+// Piston slides it along axis, so everything but the joint's own rate is rigid body motion of the parent
+SegmentMotion propagate_motion(const SegmentMotion& parent, glm::vec3 position, const JacobianColumn& axis, float rate,
+							   float acceleration)
+{
+	glm::vec3 lever = position - parent.position;
+	glm::vec3 omega = parent.angular_velocity;
+	SegmentMotion out;
+	out.position			 = position;
+	out.angular_velocity	 = omega + axis.angular * rate;
+	out.linear_velocity		 = parent.linear_velocity + glm::cross(omega, lever) + axis.linear * rate;
+	out.angular_acceleration = parent.angular_acceleration + axis.angular * acceleration
+							 + glm::cross(omega, axis.angular * rate);
+	out.linear_acceleration = parent.linear_acceleration + glm::cross(parent.angular_acceleration, lever)
+							+ glm::cross(omega, glm::cross(omega, lever)) + axis.linear * acceleration
+							+ glm::cross(omega, axis.linear * rate) * 2.0f;
+	return out;
+}
+const SegmentMotion AT_REST{glm::vec3{0.0f}, glm::vec3{0.0f}, glm::vec3{0.0f}, glm::vec3{0.0f}, glm::vec3{0.0f}};
+} // namespace
+
+double TickStatistics::active_fraction() const
+{
+	return total_components == 0 ? 0.0 : static_cast<double>(active_components) / static_cast<double>(total_components);
+}
+
 void Simulation::tick(float dt)
 {
-	for (auto& component : m_components)
+	++m_tick_statistics.ticks;
+	m_tick_statistics.active_components += m_active.size();
+	m_tick_statistics.total_components += m_components.size();
+
+	// Compacts the active set in place, so it stays in chain order
+	std::size_t kept = 0;
+	for (auto idx : m_active)
+	{
+		auto& component = m_components[idx];
+		if (component.tick(dt))
+			mark_dirty(idx);
+		if (component.is_moving())
+			m_active[kept++] = idx;
+		else
+			m_is_active[idx] = false;
+	}
+	m_active.resize(kept);
+}
+void Simulation::activate(std::size_t idx)
+{
+	if (m_is_active[idx] || !m_components[idx].is_moving())
+		return;
+	m_is_active[idx] = true;
+	m_active.insert(std::ranges::lower_bound(m_active, idx), static_cast<std::uint32_t>(idx));
+}
+void Simulation::rebuild_active_set()
+{
+	m_active.clear();
+	m_is_active.assign(m_components.size(), false);
+	for (std::size_t i = 0; i < m_components.size(); ++i)
+	{
+		// In order, so appending keeps m_active sorted without searching
+		if (m_components[i].is_moving())
+		{
+			m_is_active[i] = true;
+			m_active.push_back(static_cast<std::uint32_t>(i));
+		}
+	}
+}
+ComponentHandle Simulation::push_component(Component component)
+{
+	// Appending behind the last component never disturbs anything already there, so skip the full rebuild
+	auto idx = m_components.size();
+	mark_dirty(idx);
+	bool is_joint = !std::holds_alternative<Link>(component);
+	m_components.push_back(std::move(component));
+	m_parent.push_back(idx == 0 ? NO_PARENT : static_cast<std::uint32_t>(idx - 1));
+	m_mass_properties.emplace_back();
+	m_joint_column.push_back(static_cast<std::uint32_t>(m_joint_count));
+	m_joint_count += is_joint;
+	m_is_active.push_back(false);
+	activate(idx);
+	return m_handles.push_back();
+}
+ComponentHandle Simulation::insert_component(std::size_t idx, std::uint32_t parent, Component component)
+{
+	if (idx == m_components.size() && (idx == 0 || parent + std::size_t{1} == idx))
+		return push_component(std::move(component));
+	for (auto& p : m_parent)
+	{
+		if (p != NO_PARENT && p >= idx)
+			++p;
+	}
+	m_components.insert(m_components.begin() + static_cast<std::ptrdiff_t>(idx), std::move(component));
+	m_parent.insert(m_parent.begin() + static_cast<std::ptrdiff_t>(idx), parent);
+	m_mass_properties.insert(m_mass_properties.begin() + static_cast<std::ptrdiff_t>(idx), MassProperties{});
+	mark_dirty(idx);
+	rebuild_topology();
+	return m_handles.insert_at(idx);
+}
+void Simulation::rebuild_topology()
+{
+	m_joint_column.clear();
+	m_joint_count  = 0;
+	m_branch_count = 0;
+	for (std::size_t i = 0; i < m_components.size(); ++i)
+	{
+		m_joint_column.push_back(static_cast<std::uint32_t>(m_joint_count));
+		m_joint_count += !std::holds_alternative<Link>(m_components[i]);
+		m_branch_count += i > 0 && m_parent[i] + std::size_t{1} != i; // A second component on the base counts too
+	}
+	rebuild_active_set();
+}
+std::size_t Simulation::index_of(ComponentHandle handle) const
+{
+	auto idx = m_handles.find(handle);
+	if (!idx)
+		throw std::out_of_range("Component handle is stale");
+	return *idx;
+}
+void Simulation::mark_dirty(std::size_t idx)
+{
+	m_first_dirty = std::min(m_first_dirty, idx);
+}
+void Simulation::update_chain() const
+{
+	m_joints.resize(m_components.size());
+	if (m_first_dirty >= m_components.size())
+		return; // Nothing moved since the last evaluation
+	if (is_serial() && m_components.size() - m_first_dirty >= m_parallel_chain_threshold)
+	{
+		if (auto* pool = chain_pool())
+		{
+			update_chain_parallel(*pool);
+			m_first_dirty = m_components.size();
+			return;
+		}
+	}
+	RigidTransform joint = m_first_dirty == 0 ? RigidTransform{} : m_joints[m_first_dirty - 1];
+	if (is_serial())
+	{
+		// Every parent is the component before, no need to look at m_parent at all
+		for (std::size_t i = m_first_dirty; i < m_components.size(); ++i)
+		{
+			joint		= m_components[i].get_joint_transform(joint);
+			m_joints[i] = joint;
+		}
+	}
+	else
+	{
+		for (std::size_t i = m_first_dirty; i < m_components.size(); ++i)
+		{
+			// Most parents are still the component before, only branches go back to the stored transform
+			std::uint32_t parent = m_parent[i];
+			if (parent + std::size_t{1} != i)
+				joint = parent == NO_PARENT ? RigidTransform{} : m_joints[parent];
+			joint		= m_components[i].get_joint_transform(joint);
+			m_joints[i] = joint;
+		}
+	}
+	m_first_dirty = m_components.size();
+}
+ThreadPool* Simulation::chain_pool() const
+{
+	if (ThreadPool::is_running_task())
+		return nullptr;
+	std::size_t threads = m_chain_threads == 0 ? std::thread::hardware_concurrency() : m_chain_threads;
+	if (threads <= 1)
+		return nullptr;
+	if (!m_chain_pool.pool || m_chain_pool.pool->thread_count() != threads)
+		m_chain_pool.pool = std::make_unique<ThreadPool>(threads);
+	return m_chain_pool.pool.get();
+}
+void Simulation::update_chain_parallel(ThreadPool& pool) const
+{
+	// A few blocks per thread so the pool can even out threads that start late
+	constexpr std::size_t BLOCKS_PER_THREAD = 4;
+
+	const std::size_t first		  = m_first_dirty;
+	const std::size_t count		  = m_components.size() - first;
+	const std::size_t blocks	  = pool.thread_count() * BLOCKS_PER_THREAD;
+	const std::size_t block_size  = (count + blocks - 1) / blocks;
+	const std::size_t block_count = (count + block_size - 1) / block_size;
+	auto block_begin = [&](std::size_t block) { return first + block * block_size; };
+	auto block_end	 = [&](std::size_t block) { return std::min(block_begin(block + 1), m_components.size()); };
+
+	// Every joint transform is its parent times a local transform, so each block can be composed from the identity on
+	// its own. Only the first one starts from its real parent and is done after this
+	auto scan_blocks = [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t block = begin; block < end; ++block)
+		{
+			RigidTransform joint = block == 0 && first > 0 ? m_joints[first - 1] : RigidTransform{};
+			for (std::size_t i = block_begin(block); i < block_end(block); ++i)
+			{
+				joint		= m_components[i].get_joint_transform(joint);
+				m_joints[i] = joint;
+			}
+		}
+	};
+	pool.parallel_for(block_count, 1, scan_blocks);
+
+	// Where every block really starts, chained serially over the block totals
+	m_block_starts.resize(block_count);
+	RigidTransform start = m_joints[block_end(0) - 1];
+	for (std::size_t block = 1; block < block_count; ++block)
 	{
-		component.tick(dt);
+		m_block_starts[block] = start;
+		start				  = start * m_joints[block_end(block) - 1];
 	}
+	auto move_blocks = [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t block = begin + 1; block < end + 1; ++block)
+		{
+			for (std::size_t i = block_begin(block); i < block_end(block); ++i)
+				m_joints[i] = m_block_starts[block] * m_joints[i];
+		}
+	};
+	pool.parallel_for(block_count - 1, 1, move_blocks);
+}
+Simulation::ChainPool::ChainPool() = default;
+Simulation::ChainPool::ChainPool(const ChainPool&) {}
+Simulation::ChainPool::ChainPool(ChainPool&&) noexcept = default;
+Simulation::ChainPool& Simulation::ChainPool::operator=(const ChainPool&)
+{
+	return *this;
+}
+Simulation::ChainPool& Simulation::ChainPool::operator=(ChainPool&&) noexcept = default;
+Simulation::ChainPool::~ChainPool() = default;
+std::span<const RigidTransform> Simulation::get_chain() const
+{
+	update_chain();
+	return m_joints;
 }
 
 ComponentType to_enum(const Component& component)
@@ -90,72 +470,94 @@ ComponentType to_enum(const Component& component)
 	std::unreachable();
 }
 
-glm::vec3 get_translation(const glm::mat4& m)
-{
-	return glm::vec3(m[3]);
-}
-glm::mat3 get_rotation(const glm::mat4& m)
+RenderData Simulation::get_render_data() const
 {
-	return glm::mat3(m);
+	RenderData out;
+	get_render_data(out);
+	return out;
 }
-
-RenderData Simulation::get_render_data() const
+void Simulation::get_render_data(RenderData& out, RenderDataOptions options) const
 {
-	RenderData out{{}, glm::vec3{0.0f}, glm::vec3{0.0f}};
+	out.components.clear(); // Keeps the capacity of the previous frame
+	out.components.reserve(m_components.size());
 
-	out.components.reserve(m_components.size()); // Id prefer not to allocate at all
+	auto joints = get_chain();
 
-	struct AngularComponent
+	out.segment_motion.resize(options.compute_segment_motion ? m_components.size() : 0);
+	RigidTransform parent;
+	for (std::size_t i = 0; i < m_components.size(); ++i)
 	{
-		glm::vec3 pos;
-		glm::vec3 rot_axis;
-		float	  angular_velocity;
-	};
-	std::vector<AngularComponent> angular_components;
-
-	glm::mat4 joint_matrix{1.0f};
-	for (const auto& component : m_components)
+		if (m_parent[i] + std::size_t{1} != i)
+			parent = m_parent[i] == NO_PARENT ? RigidTransform{} : joints[m_parent[i]];
+		const auto& component = m_components[i];
+		out.components.emplace_back(to_enum(component), component.emit_model_matrix(parent, joints[i]));
+		if (options.compute_segment_motion)
+		{
+			const auto& parent_motion = m_parent[i] == NO_PARENT ? AT_REST : out.segment_motion[m_parent[i]];
+			out.segment_motion[i] = propagate_motion(parent_motion, joints[i].translation,
+													 component.get_joint_axis(joints[i]), component.velocity(), 0.0f);
+		}
+		parent = joints[i];
+	}
+	out.tip_pos = parent.translation;
+	out.tip_vel = glm::vec3{0.0f};
+	if (options.compute_tip_velocity)
 	{
-		auto [model, joint] = component.get_model_matrix(joint_matrix);
-		joint_matrix		= joint;
-		auto component_type = to_enum(component);
-		out.components.emplace_back(component_type, model);
-		// TODO reconsider choices
-		out.tip_pos = get_translation(joint_matrix);
-		if (component_type == ComponentType::Piston)
-		{
-			auto piston = std::get<Piston>(component);
-			if (piston.current_length == piston.target_length)
-				continue; // Not moving if we reached target
-			auto speed =
-				(static_cast<float>(piston.current_length < piston.target_length) - 0.5f) * 2.0f * Piston::PISTON_SPEED;
-			out.tip_vel += get_rotation(joint_matrix) * glm::vec3{0, speed, 0};
+		// Components at rest contribute nothing
+		TipVelocityAccumulator velocity;
+		if (is_serial())
+		{
+			for (auto idx : m_active)
+				m_components[idx].add_tip_velocity(velocity, joints[idx]);
 		}
-		else if (component_type == ComponentType::Swivel)
+		else
 		{
-			auto swivel = std::get<Swivel>(component);
-			if (swivel.rotational_speed == 0)
-				continue; // Not moving if we reached target
-			angular_components.emplace_back(get_translation(joint_matrix),
-											get_rotation(joint_matrix) * glm::vec3{0, 1, 0}, swivel.rotational_speed);
+			// Only the path from the base to the tip moves it
+			for (auto idx = static_cast<std::uint32_t>(m_components.size() - 1); idx != NO_PARENT; idx = m_parent[idx])
+			{
+				if (m_is_active[idx])
+					m_components[idx].add_tip_velocity(velocity, joints[idx]);
+			}
 		}
-		else if (component_type == ComponentType::Hinge)
-		{
-			auto hinge = std::get<Hinge>(component);
-			if (hinge.current_angle == hinge.target_angle)
-				continue; // Not moving if we reached target
-			float sign = (hinge.target_angle > hinge.current_angle) ? 1.0f : -1.0f;
-			angular_components.emplace_back(get_translation(joint_matrix),
-											get_rotation(joint_matrix) * glm::vec3{0, 0, 1},
-											sign * Hinge::ROTATION_SPEED);
+		out.tip_vel = velocity.velocity_at(out.tip_pos);
+	}
+	out.clearances.clear();
+	if (options.compute_clearance && m_environment && !m_environment->empty())
+	{
+		out.clearances.reserve(m_components.size());
+		const RigidTransform base;
+		for (std::size_t i = 0; i < m_components.size(); ++i)
+		{
+			const auto& parent_joint = m_parent[i] == NO_PARENT ? base : joints[m_parent[i]];
+			auto		capsule		 = make_capsule(m_components[i], parent_joint, joints[i]);
+			out.clearances.push_back(m_environment->clearance(capsule.a, capsule.b, capsule.radius));
 		}
 	}
-	for (auto angular_component : angular_components)
+}
+void Simulation::get_end_effectors(std::vector<EndEffector>& out) const
+{
+	out.clear();
+	auto joints = get_chain();
+	// Every component starts from the velocity terms of its parent, so the whole tree is one pass in storage order
+	m_path_velocities.resize(m_components.size());
+	for (std::size_t i = 0; i < m_components.size(); ++i)
 	{
-		auto omega = angular_component.rot_axis * angular_component.angular_velocity;
-		auto r	   = out.tip_pos - angular_component.pos;
-		out.tip_vel += glm::cross(omega, r); // We spin most really far out and at a 90° angle for example
+		auto& velocity = m_path_velocities[i];
+		velocity	   = m_parent[i] == NO_PARENT ? TipVelocityAccumulator{} : m_path_velocities[m_parent[i]];
+		if (m_is_active[i])
+			m_components[i].add_tip_velocity(velocity, joints[i]);
+		bool is_leaf = i + 1 == m_components.size() || m_parent[i + 1] != i;
+		if (is_leaf)
+		{
+			glm::vec3 position = joints[i].translation;
+			out.push_back({m_handles.handle_at(i), position, velocity.velocity_at(position)});
+		}
 	}
+}
+std::vector<EndEffector> Simulation::get_end_effectors() const
+{
+	std::vector<EndEffector> out;
+	get_end_effectors(out);
 	return out;
 }
 std::vector<ComponentType> Simulation::get_component_types() const
@@ -167,37 +569,265 @@ std::vector<ComponentType> Simulation::get_component_types() const
 void Simulation::set_piston_target_length(std::size_t idx, float f)
 {
 	auto& piston = std::get<Piston>(m_components.at(idx));
-	assert(piston.max_length >= f);
-	assert(Piston::MIN_LENGTH <= f);
+	if (!(f >= Piston::MIN_LENGTH && f <= piston.max_length))
+		throw std::invalid_argument("Piston target length out of range");
 	piston.target_length = f;
+	activate(idx);
 }
 void Simulation::set_hinge_target_angle(std::size_t idx, float f)
 {
 	auto& hinge		   = std::get<Hinge>(m_components.at(idx));
 	hinge.target_angle = f;
+	activate(idx);
 }
 void Simulation::set_swivel_rotation_speed(std::size_t idx, float f)
 {
 	auto& swivel			= std::get<Swivel>(m_components.at(idx));
 	swivel.rotational_speed = f;
+	activate(idx);
+}
+void Simulation::set_swivel_angle(std::size_t idx, float f)
+{
+	auto& swivel = std::get<Swivel>(m_components.at(idx));
+	swivel.angle = f;
+	mark_dirty(idx);
 }
 void Simulation::remove_component(std::size_t idx)
 {
-	m_components.erase(m_components.begin() + idx);
+	m_handles.erase_at(idx);
+	m_components.erase(m_components.begin() + static_cast<std::ptrdiff_t>(idx));
+	m_mass_properties.erase(m_mass_properties.begin() + static_cast<std::ptrdiff_t>(idx));
+	// Children move up to the parent of the removed component, which keeps the storage depth first
+	std::uint32_t removed_parent = m_parent[idx];
+	m_parent.erase(m_parent.begin() + static_cast<std::ptrdiff_t>(idx));
+	for (auto& parent : m_parent)
+	{
+		if (parent == idx)
+			parent = removed_parent;
+		else if (parent != NO_PARENT && parent > idx)
+			--parent;
+	}
+	mark_dirty(idx);
+	// Every index after idx shifted, rare enough to just start over
+	rebuild_topology();
+}
+void Simulation::clear()
+{
+	m_handles.clear();
+	m_components.clear();
+	m_parent.clear();
+	m_mass_properties.clear();
+	m_branch_count = 0;
+	m_joints.clear();
+	m_first_dirty = 0;
+	m_active.clear();
+	m_is_active.clear();
+	m_joint_column.clear();
+	m_joint_count	  = 0;
+	m_tick_statistics = {};
+}
+void Simulation::set_piston_target_length(ComponentHandle handle, float f)
+{
+	set_piston_target_length(index_of(handle), f);
+}
+void Simulation::set_hinge_target_angle(ComponentHandle handle, float f)
+{
+	set_hinge_target_angle(index_of(handle), f);
+}
+void Simulation::set_swivel_rotation_speed(ComponentHandle handle, float f)
+{
+	set_swivel_rotation_speed(index_of(handle), f);
 }
-void Simulation::add_piston(float max_length)
+void Simulation::set_swivel_angle(ComponentHandle handle, float f)
 {
-	m_components.emplace_back(Piston{Piston::MIN_LENGTH, Piston::MIN_LENGTH, max_length});
+	set_swivel_angle(index_of(handle), f);
 }
-void Simulation::add_hinge()
+void Simulation::remove_component(ComponentHandle handle)
 {
-	m_components.emplace_back(Hinge{0, 0});
+	remove_component(index_of(handle));
 }
-void Simulation::add_swivel()
+ComponentHandle Simulation::add_piston(float max_length)
 {
-	m_components.emplace_back(Swivel{0, 0});
+	return push_component(Piston{Piston::MIN_LENGTH, Piston::MIN_LENGTH, max_length});
 }
-void Simulation::add_link(float length)
+ComponentHandle Simulation::add_hinge()
 {
-	m_components.emplace_back(Link{length});
+	return push_component(Hinge{0, 0});
 }
+ComponentHandle Simulation::add_swivel()
+{
+	return push_component(Swivel{0, 0});
+}
+ComponentHandle Simulation::add_link(float length)
+{
+	return push_component(Link{length});
+}
+ComponentHandle Simulation::attach(Component component, ComponentHandle parent)
+{
+	if (parent.is_null())
+		return insert_component(m_components.size(), NO_PARENT, std::move(component));
+	std::size_t parent_idx = index_of(parent);
+	// The subtree of parent ends at the first component attached to something before parent
+	std::size_t end = parent_idx + 1;
+	while (end < m_components.size() && m_parent[end] != NO_PARENT && m_parent[end] >= parent_idx)
+		++end;
+	return insert_component(end, static_cast<std::uint32_t>(parent_idx), std::move(component));
+}
+void Simulation::set_mass_properties(std::size_t idx, const MassProperties& properties)
+{
+	m_mass_properties.at(idx) = properties;
+}
+void Simulation::set_mass_properties(ComponentHandle handle, const MassProperties& properties)
+{
+	set_mass_properties(index_of(handle), properties);
+}
+std::span<const Component> Simulation::get_components() const
+{
+	return m_components;
+}
+void Simulation::set_chain_threads(std::size_t thread_count, std::size_t threshold)
+{
+	m_chain_threads			   = thread_count;
+	m_parallel_chain_threshold = threshold;
+}
+std::size_t Simulation::get_joint_count() const
+{
+	return m_joint_count;
+}
+void Simulation::get_jacobian(std::span<JacobianColumn> jacobian) const
+{
+	if (!m_components.empty())
+		get_jacobian(jacobian, m_components.size() - 1);
+}
+void Simulation::get_jacobian(std::span<JacobianColumn> jacobian, std::size_t end_effector) const
+{
+	assert(jacobian.size() == m_joint_count);
+	auto	  joints = get_chain();
+	glm::vec3 tip	 = joints[end_effector].translation;
+	std::ranges::fill(jacobian, JacobianColumn{glm::vec3{0.0f}, glm::vec3{0.0f}});
+	// Walk from the tip to the base, which for a serial chain is every component
+	for (auto idx = static_cast<std::uint32_t>(end_effector); idx != NO_PARENT; idx = m_parent[idx])
+	{
+		std::visit(
+			[&](const auto& held)
+			{
+				if constexpr (requires { held.get_jacobian_column(joints[idx], tip); })
+					jacobian[m_joint_column[idx]] = held.get_jacobian_column(joints[idx], tip);
+			},
+			m_components[idx]);
+	}
+}
+void Simulation::get_joint_velocities(std::span<float> velocities) const
+{
+	assert(velocities.size() == m_joint_count);
+	std::ranges::fill(velocities, 0.0f); // Exactly the velocity of everything at rest
+	for (auto idx : m_active)
+	{
+		std::visit(
+			[&](const auto& held)
+			{
+				if constexpr (requires { held.velocity(); })
+					velocities[m_joint_column[idx]] = held.velocity();
+			},
+			m_components[idx]);
+	}
+}
+void Simulation::inverse_dynamics(std::span<const float> velocities, std::span<const float> accelerations,
+								  std::span<float> efforts) const
+{
+	assert(velocities.size() == m_joint_count && accelerations.size() == m_joint_count);
+	run_inverse_dynamics(velocities.data(), accelerations.data(), efforts);
+}
+void Simulation::get_joint_efforts(std::span<float> efforts) const
+{
+	run_inverse_dynamics(nullptr, nullptr, efforts);
+}
+void Simulation::run_inverse_dynamics(const float* velocities, const float* accelerations,
+									  std::span<float> efforts) const
+{
+	assert(efforts.size() == m_joint_count);
+	auto joints = get_chain();
+	m_dynamics.resize(m_components.size());
+
+	// Out from the base. Accelerating the base against gravity puts the weight of every body into its inertial force
+	SegmentMotion base		 = AT_REST;
+	base.linear_acceleration = -m_gravity;
+	for (std::size_t i = 0; i < m_components.size(); ++i)
+	{
+		const auto& parent	  = m_parent[i] == NO_PARENT ? base : m_dynamics[m_parent[i]].motion;
+		const auto& joint	  = joints[i];
+		const auto& component = m_components[i];
+		auto		col		  = m_joint_column[i];
+		bool		is_joint  = !std::holds_alternative<Link>(component);
+		float		rate	  = is_joint ? (velocities ? velocities[col] : component.velocity()) : 0.0f;
+		float		accel	  = is_joint && accelerations ? accelerations[col] : 0.0f;
+		auto&		body	  = m_dynamics[i];
+		body.motion = propagate_motion(parent, joint.translation, component.get_joint_axis(joint), rate, accel);
+		const auto& motion	  = body.motion;
+
+		const auto& mass			 = m_mass_properties[i];
+		glm::vec3	com_lever		 = joint.rotation * mass.center_of_mass;
+		glm::vec3	com_acceleration = motion.linear_acceleration + glm::cross(motion.angular_acceleration, com_lever)
+								   + glm::cross(motion.angular_velocity, glm::cross(motion.angular_velocity, com_lever));
+		// Inertia rotated into the world, applied as R I R^T w without building the matrix
+		auto world_inertia = [&](glm::vec3 w)
+		{ return joint.rotation * (mass.inertia * (glm::transpose(joint.rotation) * w)); };
+		body.force	= com_acceleration * mass.mass;
+		body.moment = world_inertia(motion.angular_acceleration)
+					+ glm::cross(motion.angular_velocity, world_inertia(motion.angular_velocity))
+					+ glm::cross(com_lever, body.force);
+	}
+
+	// Back to the base, children come after their parent so every body has its whole subtree summed up when reached
+	for (std::size_t i = m_components.size(); i-- > 0;)
+	{
+		const auto& joint = joints[i];
+		const auto& body  = m_dynamics[i];
+		if (!std::holds_alternative<Link>(m_components[i]))
+		{
+			auto axis				   = m_components[i].get_joint_axis(joint);
+			efforts[m_joint_column[i]] = glm::dot(axis.linear, body.force) + glm::dot(axis.angular, body.moment);
+		}
+		if (m_parent[i] != NO_PARENT)
+		{
+			auto& parent = m_dynamics[m_parent[i]];
+			parent.force += body.force;
+			parent.moment += body.moment + glm::cross(joint.translation - joints[m_parent[i]].translation, body.force);
+		}
+	}
+}
+
+void Simulation::get_joint_positions(std::span<float> positions) const
+{
+	if (positions.size() != m_joint_count)
+		throw std::invalid_argument("Expected one position per joint");
+	std::size_t joint = 0;
+	for (const auto& component : m_components)
+	{
+		std::visit(
+			[&](const auto& held)
+			{
+				if constexpr (requires { held.position(); })
+					positions[joint++] = held.position();
+			},
+			component);
+	}
+}
+void Simulation::set_joint_positions(std::span<const float> positions)
+{
+	if (positions.size() != m_joint_count)
+		throw std::invalid_argument("Expected one position per joint");
+	std::size_t joint = 0;
+	for (auto& component : m_components)
+	{
+		std::visit(
+			[&](auto& held)
+			{
+				if constexpr (requires { held.set_position(0.0f); })
+					held.set_position(positions[joint++]);
+			},
+			component);
+	}
+	mark_dirty(0);
+	rebuild_active_set(); // Everything but spinning Swivels is resting now
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <RobotArm/Simulation/SimulationBatch.hpp>
+
+double BatchStatistics::arm_ticks_per_second() const
+{
+	return tick_seconds > 0.0 ? static_cast<double>(arm_ticks) / tick_seconds : 0.0;
+}
+
+SimulationBatch::SimulationBatch(std::size_t thread_count)
+	: m_pool(thread_count)
+{
+}
+std::size_t SimulationBatch::grain() const
+{
+	// A few chunks per thread so stealing can even out arms of different length
+	return std::max<std::size_t>(1, m_simulations.size() / (m_pool.thread_count() * 8));
+}
+Simulation& SimulationBatch::add_simulation(Simulation simulation)
+{
+	return m_simulations.emplace_back(std::move(simulation));
+}
+Simulation& SimulationBatch::get_simulation(std::size_t idx)
+{
+	return m_simulations.at(idx);
+}
+std::size_t SimulationBatch::size() const
+{
+	return m_simulations.size();
+}
+void SimulationBatch::tick(float dt, std::size_t steps)
+{
+	auto start = std::chrono::steady_clock::now();
+	m_pool.parallel_for(m_simulations.size(), grain(),
+						[&](std::size_t begin, std::size_t end)
+						{
+							for (std::size_t i = begin; i < end; ++i)
+							{
+								for (std::size_t step = 0; step < steps; ++step)
+								{
+									m_simulations[i].tick(dt);
+								}
+							}
+						});
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	m_statistics.arm_ticks += m_simulations.size() * steps;
+	m_statistics.tick_seconds += elapsed.count();
+}
+void SimulationBatch::compute_render_data()
+{
+	m_render_data.resize(m_simulations.size());
+	m_pool.parallel_for(m_simulations.size(), grain(),
+						[&](std::size_t begin, std::size_t end)
+						{
+							for (std::size_t i = begin; i < end; ++i)
+							{
+								m_simulations[i].get_render_data(m_render_data[i]);
+							}
+						});
+}
+void SimulationBatch::solve_ik(std::span<const glm::vec3> targets, std::span<IkResult> results, IkSettings settings)
+{
+	assert(targets.size() == m_simulations.size() && results.size() == m_simulations.size());
+	m_pool.parallel_for(m_simulations.size(), grain(),
+						[&](std::size_t begin, std::size_t end)
+						{
+							IkSolver solver(settings); // One per chunk so the scratch buffers are shared by its arms
+							for (std::size_t i = begin; i < end; ++i)
+							{
+								results[i] = solver.solve(m_simulations[i], targets[i]);
+							}
+						});
+}
+std::span<const RenderData> SimulationBatch::get_render_data() const
+{
+	return m_render_data;
+}
+const BatchStatistics& SimulationBatch::get_statistics() const
+{
+	return m_statistics;
+}
+void SimulationBatch::reset_statistics()
+{
+	m_statistics = {};
+}
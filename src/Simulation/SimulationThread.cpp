@@ -0,0 +1,291 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <cassert>
+#include <RobotArm/Simulation/SimulationThread.hpp>
+#include <stdexcept>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+constexpr bool HAS_THREADS = false;
+#else
+constexpr bool HAS_THREADS = true;
+#endif
+
+void interpolate(const RenderData& from, const RenderData& to, float alpha, RenderData& out)
+{
+	out.components.clear();
+	if (from.components.size() != to.components.size())
+	{
+		out.components.assign(to.components.begin(), to.components.end());
+		out.tip_pos = to.tip_pos;
+		out.tip_vel = to.tip_vel;
+		out.clearances.assign(to.clearances.begin(), to.clearances.end());
+		out.segment_motion.assign(to.segment_motion.begin(), to.segment_motion.end());
+		return;
+	}
+	for (std::size_t i = 0; i < to.components.size(); ++i)
+	{
+		const auto& [type, to_model] = to.components[i];
+		const auto& from_model		 = from.components[i].second;
+		// Steps are short enough that blending the matrices directly doesn't visibly shear
+		glm::mat4 model;
+		for (int column = 0; column < 4; ++column)
+		{
+			model[column] = from_model[column] * (1.0f - alpha) + to_model[column] * alpha;
+		}
+		out.components.emplace_back(type, model);
+	}
+	out.tip_pos = from.tip_pos * (1.0f - alpha) + to.tip_pos * alpha;
+	out.tip_vel = from.tip_vel * (1.0f - alpha) + to.tip_vel * alpha;
+	// Blending clearances wouldn't keep the directions unit length, the newer step is close enough
+	out.clearances.assign(to.clearances.begin(), to.clearances.end());
+	if (from.segment_motion.size() != to.segment_motion.size())
+	{
+		out.segment_motion.assign(to.segment_motion.begin(), to.segment_motion.end());
+		return;
+	}
+	out.segment_motion.resize(to.segment_motion.size());
+	auto blend = [alpha](glm::vec3 a, glm::vec3 b) { return a * (1.0f - alpha) + b * alpha; };
+	for (std::size_t i = 0; i < to.segment_motion.size(); ++i)
+	{
+		const auto& a		   = from.segment_motion[i];
+		const auto& b		   = to.segment_motion[i];
+		out.segment_motion[i] = {blend(a.position, b.position), blend(a.linear_velocity, b.linear_velocity),
+								 blend(a.angular_velocity, b.angular_velocity),
+								 blend(a.linear_acceleration, b.linear_acceleration),
+								 blend(a.angular_acceleration, b.angular_acceleration)};
+	}
+}
+
+bool SimulationCommand::apply(Simulation& sim) const
+{
+	if (changes_topology() && type != Type::RemoveComponent)
+	{
+		ComponentHandle added;
+		switch (type)
+		{
+		case Type::AddPiston: added = sim.add_piston(value); break;
+		case Type::AddHinge: added = sim.add_hinge(); break;
+		case Type::AddSwivel: added = sim.add_swivel(); break;
+		default: added = sim.add_link(value); break;
+		}
+		assert(added == handle); // Predicted by the producer side
+		return true;
+	}
+	auto idx = sim.find(handle);
+	if (!idx)
+		return false;
+	switch (type)
+	{
+	case Type::SetPistonTargetLength:
+		// Runs on the simulation thread, where an exception would end the program
+		try
+		{
+			sim.set_piston_target_length(*idx, value);
+		}
+		catch (const std::invalid_argument&)
+		{
+			return false;
+		}
+		break;
+	case Type::SetHingeTargetAngle: sim.set_hinge_target_angle(*idx, value); break;
+	case Type::SetSwivelRotationSpeed: sim.set_swivel_rotation_speed(*idx, value); break;
+	case Type::SetSwivelAngle: sim.set_swivel_angle(*idx, value); break;
+	default: sim.remove_component(*idx); break;
+	}
+	return true;
+}
+
+std::size_t coalesce(std::vector<SimulationCommand>& batch)
+{
+	// Walk backwards so the last command to every component is the one kept, survivors are packed towards the end.
+	// Batches are a handful of slider updates, a linear search over what was kept is cheaper than hashing.
+	auto write = batch.end();
+	for (auto it = batch.rbegin(); it != batch.rend(); ++it)
+	{
+		const auto& command	   = *it;
+		bool		overridden = !command.changes_topology()
+							&& std::any_of(write, batch.end(),
+										   [&](const SimulationCommand& later)
+										   { return later.type == command.type && later.handle == command.handle; });
+		if (!overridden)
+			*--write = command;
+	}
+	auto dropped = static_cast<std::size_t>(write - batch.begin());
+	batch.erase(batch.begin(), write);
+	return dropped;
+}
+
+SimulationThread::SimulationThread(Simulation simulation, double tick_rate, std::size_t queue_capacity)
+	: m_simulation(std::move(simulation))
+	, m_step_seconds(1.0 / tick_rate)
+	, m_last_advance(Clock::now())
+	, m_commands(queue_capacity)
+	, m_producer_handles(m_simulation.get_handles())
+{
+	m_batch.reserve(m_commands.capacity());
+}
+SimulationThread::~SimulationThread()
+{
+	stop();
+}
+void SimulationThread::start()
+{
+	m_last_advance = Clock::now();
+	if constexpr (HAS_THREADS)
+	{
+		if (!m_thread.joinable())
+			m_thread = std::jthread([this](std::stop_token stop_token) { run(stop_token); });
+	}
+}
+void SimulationThread::stop()
+{
+	if (m_thread.joinable())
+	{
+		m_thread.request_stop();
+		m_thread.join();
+	}
+}
+void SimulationThread::set_tick_rate(double ticks_per_second)
+{
+	m_step_seconds.store(1.0 / ticks_per_second, std::memory_order_relaxed);
+}
+void SimulationThread::set_compute_segment_motion(bool enabled)
+{
+	m_compute_segment_motion.store(enabled, std::memory_order_relaxed);
+}
+bool SimulationThread::post(SimulationCommand command)
+{
+	assert(!command.changes_topology()); // Would get the producer handles out of sync, use add_* and remove_component
+	m_posting.fetch_add(1, std::memory_order_relaxed);
+	bool pushed = m_commands.try_push(command);
+	m_posting.fetch_sub(1, std::memory_order_relaxed);
+	return pushed;
+}
+ComponentHandle SimulationThread::post_add(SimulationCommand::Type type, float value)
+{
+	// Only claim the handle once the command is in, the simulation must see the exact same sequence of adds and removes
+	ComponentHandle handle = m_producer_handles.next_handle();
+	if (!m_commands.try_push({type, handle, value}))
+		return {};
+	return m_producer_handles.push_back();
+}
+ComponentHandle SimulationThread::add_piston(float max_length)
+{
+	return post_add(SimulationCommand::Type::AddPiston, max_length);
+}
+ComponentHandle SimulationThread::add_hinge()
+{
+	return post_add(SimulationCommand::Type::AddHinge);
+}
+ComponentHandle SimulationThread::add_swivel()
+{
+	return post_add(SimulationCommand::Type::AddSwivel);
+}
+ComponentHandle SimulationThread::add_link(float length)
+{
+	return post_add(SimulationCommand::Type::AddLink, length);
+}
+bool SimulationThread::remove_component(ComponentHandle handle)
+{
+	auto idx = m_producer_handles.find(handle);
+	if (!idx || !m_commands.try_push({SimulationCommand::Type::RemoveComponent, handle}))
+		return false;
+	m_producer_handles.erase_at(*idx);
+	return true;
+}
+void SimulationThread::set_simulation(Simulation simulation)
+{
+	assert(m_posting.load(std::memory_order_relaxed) == 0); // Commands from other threads could target either arm
+	bool running = m_thread.joinable();
+	stop();
+	apply_commands();
+	m_simulation	   = std::move(simulation);
+	m_producer_handles = m_simulation.get_handles();
+	assert(m_posting.load(std::memory_order_relaxed) == 0);
+	// Publish the new arm right away instead of interpolating from the old one on the next step
+	m_simulation.get_render_data(
+		m_current, {.compute_segment_motion = m_compute_segment_motion.load(std::memory_order_relaxed)});
+	m_previous		  = m_current;
+	auto& snapshot	  = m_snapshots.write_buffer();
+	snapshot.previous = m_previous;
+	snapshot.current  = m_current;
+	snapshot.time	  = Clock::now();
+	m_snapshots.publish();
+	if (running)
+		start();
+}
+CommandStatistics SimulationThread::get_command_statistics() const
+{
+	return {.depth	   = m_commands.depth(),
+			.capacity  = m_commands.capacity(),
+			.dropped   = m_commands.dropped(),
+			.applied   = m_applied.load(std::memory_order_relaxed),
+			.coalesced = m_coalesced.load(std::memory_order_relaxed),
+			.stale	   = m_stale.load(std::memory_order_relaxed)};
+}
+void SimulationThread::get_render_data(RenderData& out, Clock::time_point now)
+{
+	if (!m_thread.joinable())
+		advance_to(now); // No simulation thread, step on the render thread instead
+
+	m_snapshots.update();
+	const auto& snapshot = m_snapshots.read_buffer();
+	double		step	 = m_step_seconds.load(std::memory_order_relaxed);
+	// Render one step in the past, blending from previous to current as the next step approaches
+	double since_step = std::chrono::duration<double>(now - snapshot.time).count();
+	float  alpha	  = static_cast<float>(std::clamp(since_step / step, 0.0, 1.0));
+	interpolate(snapshot.previous, snapshot.current, alpha, out);
+}
+void SimulationThread::run(std::stop_token stop_token)
+{
+	while (!stop_token.stop_requested())
+	{
+		advance_to(Clock::now());
+		double step = m_step_seconds.load(std::memory_order_relaxed);
+		std::this_thread::sleep_until(m_last_advance + std::chrono::duration<double>(step - m_accumulator));
+	}
+}
+void SimulationThread::advance_to(Clock::time_point now)
+{
+	double step = m_step_seconds.load(std::memory_order_relaxed);
+	m_accumulator += std::min(std::chrono::duration<double>(now - m_last_advance).count(), MAX_FRAME_TIME);
+	m_last_advance = now;
+
+	apply_commands();
+	bool stepped = false;
+	while (m_accumulator >= step)
+	{
+		m_simulation.tick(static_cast<float>(step));
+		m_accumulator -= step;
+		std::swap(m_previous, m_current);
+		m_simulation.get_render_data(
+			m_current, {.compute_segment_motion = m_compute_segment_motion.load(std::memory_order_relaxed)});
+		stepped = true;
+	}
+	if (!stepped)
+		return;
+
+	auto& snapshot	  = m_snapshots.write_buffer();
+	snapshot.previous = m_previous; // Copy assignment keeps the capacity of the snapshot buffers
+	snapshot.current  = m_current;
+	// The last step happened m_accumulator seconds ago in simulated time
+	snapshot.time = now - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_accumulator));
+	m_snapshots.publish();
+}
+void SimulationThread::apply_commands()
+{
+	if (m_commands.drain(m_batch) == 0)
+		return;
+	std::size_t coalesced = coalesce(m_batch);
+	std::size_t applied	  = 0;
+	for (const auto& command : m_batch)
+	{
+		applied += command.apply(m_simulation);
+	}
+	m_applied.fetch_add(applied, std::memory_order_relaxed);
+	m_stale.fetch_add(m_batch.size() - applied, std::memory_order_relaxed);
+	m_coalesced.fetch_add(coalesced, std::memory_order_relaxed);
+	m_batch.clear();
+}
@@ -0,0 +1,82 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <cassert>
+#include <RobotArm/Simulation/SlotMap.hpp>
+
+ComponentHandle SlotMap::push_back()
+{
+	return insert_at(m_slot_of.size());
+}
+ComponentHandle SlotMap::insert_at(std::size_t index)
+{
+	assert(index <= m_slot_of.size());
+	std::uint32_t slot = m_free;
+	if (slot == ComponentHandle::NULL_SLOT)
+	{
+		slot = static_cast<std::uint32_t>(m_slots.size());
+		m_slots.emplace_back();
+	}
+	else
+	{
+		m_free = m_slots[slot].index;
+	}
+	m_slot_of.insert(m_slot_of.begin() + static_cast<std::ptrdiff_t>(index), slot);
+	for (std::size_t i = index; i < m_slot_of.size(); ++i)
+	{
+		m_slots[m_slot_of[i]].index = static_cast<std::uint32_t>(i);
+	}
+	return {slot, m_slots[slot].generation};
+}
+ComponentHandle SlotMap::next_handle() const
+{
+	if (m_free == ComponentHandle::NULL_SLOT)
+		return {static_cast<std::uint32_t>(m_slots.size()), 0};
+	return {m_free, m_slots[m_free].generation};
+}
+void SlotMap::erase_at(std::size_t index)
+{
+	assert(index < m_slot_of.size());
+	std::uint32_t slot = m_slot_of[index];
+	++m_slots[slot].generation;
+	m_slots[slot].index = m_free;
+	m_free				= slot;
+
+	m_slot_of.erase(m_slot_of.begin() + static_cast<std::ptrdiff_t>(index));
+	for (std::size_t i = index; i < m_slot_of.size(); ++i)
+	{
+		m_slots[m_slot_of[i]].index = static_cast<std::uint32_t>(i);
+	}
+}
+void SlotMap::clear()
+{
+	for (std::uint32_t slot : m_slot_of)
+	{
+		++m_slots[slot].generation;
+		m_slots[slot].index = m_free;
+		m_free				= slot;
+	}
+	m_slot_of.clear();
+}
+std::optional<std::size_t> SlotMap::find(ComponentHandle handle) const
+{
+	// A freed slot already carries the generation of its next element, so a handle from another arm or from after a
+	// restored snapshot can match it. Only a slot its element points back to is in use
+	if (handle.slot >= m_slots.size() || m_slots[handle.slot].generation != handle.generation)
+		return std::nullopt;
+	std::uint32_t index = m_slots[handle.slot].index;
+	if (index >= m_slot_of.size() || m_slot_of[index] != handle.slot)
+		return std::nullopt;
+	return index;
+}
+ComponentHandle SlotMap::handle_at(std::size_t index) const
+{
+	std::uint32_t slot = m_slot_of.at(index);
+	return {slot, m_slots[slot].generation};
+}
+void SlotMap::assign(std::span<const Slot> slots, std::span<const std::uint32_t> slot_of, std::uint32_t free_slot)
+{
+	m_slots.assign(slots.begin(), slots.end());
+	m_slot_of.assign(slot_of.begin(), slot_of.end());
+	m_free = free_slot;
+}
@@ -0,0 +1,206 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <cmath>
+#include <ranges>
+#include <RobotArm/Simulation/SoASimulation.hpp>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+constexpr float TWO_PI = 3.141592f * 2.0f;
+
+// Branch-free equivalent of std::fmod so the swivel loop still vectorizes
+float wrap_angle(float angle)
+{
+	return angle - TWO_PI * std::trunc(angle / TWO_PI);
+}
+
+template <class T>
+void erase_at(std::vector<T>& values, std::uint32_t slot)
+{
+	values.erase(values.begin() + slot);
+}
+} // namespace
+
+void SoASimulation::tick(float dt)
+{
+	{
+		const float step = Piston::PISTON_SPEED * dt;
+		float*		current	   = m_pistons.current_length.data();
+		const float* target	   = m_pistons.target_length.data();
+		const float* max_length = m_pistons.max_length.data();
+		for (std::size_t i = 0; i < m_pistons.current_length.size(); ++i)
+		{
+			float length = current[i] + std::min(std::max(target[i] - current[i], -step), step);
+			current[i]	 = std::min(std::max(length, Piston::MIN_LENGTH), max_length[i]);
+		}
+	}
+	{
+		const float step	= Hinge::ROTATION_SPEED * dt;
+		float*		current = m_hinges.current_angle.data();
+		const float* target = m_hinges.target_angle.data();
+		for (std::size_t i = 0; i < m_hinges.current_angle.size(); ++i)
+		{
+			current[i] += std::min(std::max(target[i] - current[i], -step), step);
+		}
+	}
+	{
+		float*		 angle = m_swivels.angle.data();
+		const float* speed = m_swivels.rotational_speed.data();
+		for (std::size_t i = 0; i < m_swivels.angle.size(); ++i)
+		{
+			angle[i] = wrap_angle(angle[i] + speed[i] * dt);
+		}
+	}
+	// Links never move
+}
+
+RenderData SoASimulation::get_render_data() const
+{
+	RenderData out;
+	get_render_data(out);
+	return out;
+}
+void SoASimulation::get_render_data(RenderData& out, RenderDataOptions options) const
+{
+	out.components.clear();
+	out.components.reserve(m_chain.size());
+
+	// Straight from the arrays of each type, the same kinematics as get_joint_transform, emit_model_matrix and
+	// add_tip_velocity of the components in Simulation.cpp
+	TipVelocityAccumulator velocity;
+	RigidTransform		   joint;
+	for (auto [type, slot] : m_chain)
+	{
+		switch (type)
+		{
+			case ComponentType::Piston:
+			{
+				float length = m_pistons.current_length[slot];
+				out.components.emplace_back(type, joint.translated_y(length / 2.0f).to_mat4({0.3f, length, 0.3f}));
+				joint = joint.translated_y(length);
+				float target = std::clamp(m_pistons.target_length[slot], Piston::MIN_LENGTH, m_pistons.max_length[slot]);
+				if (options.compute_tip_velocity && length != target)
+				{
+					float speed = (static_cast<float>(length < target) - 0.5f) * 2.0f * Piston::PISTON_SPEED;
+					velocity.add_linear(joint.rotation[1] * speed);
+				}
+				break;
+			}
+			case ComponentType::Hinge:
+			{
+				float angle = m_hinges.current_angle[slot];
+				joint		= joint.rotated_z(angle);
+				out.components.emplace_back(type, joint.to_mat4());
+				float target = m_hinges.target_angle[slot];
+				if (options.compute_tip_velocity && angle != target)
+				{
+					float speed = target > angle ? Hinge::ROTATION_SPEED : -Hinge::ROTATION_SPEED;
+					velocity.add_angular(joint.translation, joint.rotation[2] * speed);
+				}
+				break;
+			}
+			case ComponentType::Swivel:
+			{
+				out.components.emplace_back(type, joint.to_mat4({0.35f, 0.3f, 0.35f}));
+				joint	   = joint.translated_y(Swivel::JOINT_HEIGHT).rotated_y(m_swivels.angle[slot]);
+				float speed = m_swivels.rotational_speed[slot];
+				if (options.compute_tip_velocity && speed != 0)
+					velocity.add_angular(joint.translation, joint.rotation[1] * speed);
+				break;
+			}
+			case ComponentType::Link:
+			{
+				float length = m_link_lengths[slot];
+				out.components.emplace_back(type, joint.translated_y(length / 2.0f).to_mat4({0.3f, length, 0.3f}));
+				joint = joint.translated_y(length);
+				break;
+			}
+		}
+	}
+	out.tip_pos = joint.translation;
+	out.tip_vel = options.compute_tip_velocity ? velocity.velocity_at(out.tip_pos) : glm::vec3{0.0f};
+}
+std::vector<ComponentType> SoASimulation::get_component_types() const
+{
+	namespace v = std::views;
+	namespace r = std::ranges;
+	return m_chain | v::transform(&ChainEntry::type) | r::to<std::vector>();
+}
+std::uint32_t SoASimulation::slot_of(std::size_t idx, ComponentType type) const
+{
+	auto entry = m_chain.at(idx);
+	if (entry.type != type)
+		throw std::invalid_argument("Component at index has a different type");
+	return entry.slot;
+}
+void SoASimulation::set_piston_target_length(std::size_t idx, float f)
+{
+	auto slot = slot_of(idx, ComponentType::Piston);
+	if (!(f >= Piston::MIN_LENGTH && f <= m_pistons.max_length[slot]))
+		throw std::invalid_argument("Piston target length out of range");
+	m_pistons.target_length[slot] = f;
+}
+void SoASimulation::set_hinge_target_angle(std::size_t idx, float f)
+{
+	m_hinges.target_angle[slot_of(idx, ComponentType::Hinge)] = f;
+}
+void SoASimulation::set_swivel_rotation_speed(std::size_t idx, float f)
+{
+	m_swivels.rotational_speed[slot_of(idx, ComponentType::Swivel)] = f;
+}
+void SoASimulation::remove_component(std::size_t idx)
+{
+	auto [type, slot] = m_chain.at(idx);
+	switch (type)
+	{
+		case ComponentType::Piston:
+			erase_at(m_pistons.current_length, slot);
+			erase_at(m_pistons.target_length, slot);
+			erase_at(m_pistons.max_length, slot);
+			break;
+		case ComponentType::Hinge:
+			erase_at(m_hinges.current_angle, slot);
+			erase_at(m_hinges.target_angle, slot);
+			break;
+		case ComponentType::Swivel:
+			erase_at(m_swivels.rotational_speed, slot);
+			erase_at(m_swivels.angle, slot);
+			break;
+		case ComponentType::Link: erase_at(m_link_lengths, slot); break;
+	}
+	m_chain.erase(m_chain.begin() + static_cast<std::ptrdiff_t>(idx));
+	// Arrays stay in chain order, so every later component of the same type moved down by one
+	for (auto& entry : m_chain | std::views::drop(idx))
+	{
+		if (entry.type == type)
+			--entry.slot;
+	}
+}
+void SoASimulation::add_piston(float max_length)
+{
+	m_chain.emplace_back(ComponentType::Piston, static_cast<std::uint32_t>(m_pistons.current_length.size()));
+	m_pistons.current_length.push_back(Piston::MIN_LENGTH);
+	m_pistons.target_length.push_back(Piston::MIN_LENGTH);
+	m_pistons.max_length.push_back(max_length);
+}
+void SoASimulation::add_hinge()
+{
+	m_chain.emplace_back(ComponentType::Hinge, static_cast<std::uint32_t>(m_hinges.current_angle.size()));
+	m_hinges.current_angle.push_back(0);
+	m_hinges.target_angle.push_back(0);
+}
+void SoASimulation::add_swivel()
+{
+	m_chain.emplace_back(ComponentType::Swivel, static_cast<std::uint32_t>(m_swivels.angle.size()));
+	m_swivels.rotational_speed.push_back(0);
+	m_swivels.angle.push_back(0);
+}
+void SoASimulation::add_link(float length)
+{
+	m_chain.emplace_back(ComponentType::Link, static_cast<std::uint32_t>(m_link_lengths.size()));
+	m_link_lengths.push_back(length);
+}
@@ -0,0 +1,161 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <RobotArm/Simulation/ThreadPool.hpp>
+#include <utility>
+
+namespace
+{
+thread_local const ThreadPool* t_running_pool = nullptr;
+
+// Marks the calling thread as running tasks of pool for its lifetime, restores the outer pool after nested loops
+class RunningScope
+{
+	const ThreadPool* m_outer;
+
+public:
+	explicit RunningScope(const ThreadPool* pool)
+		: m_outer(std::exchange(t_running_pool, pool))
+	{
+	}
+	~RunningScope() { t_running_pool = m_outer; }
+	RunningScope(const RunningScope&)			 = delete;
+	RunningScope& operator=(const RunningScope&) = delete;
+};
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t thread_count)
+{
+	thread_count = std::max<std::size_t>(thread_count, 1);
+	for (std::size_t i = 0; i < thread_count; ++i)
+	{
+		m_queues.push_back(std::make_unique<WorkQueue>());
+	}
+	for (std::size_t i = 0; i + 1 < thread_count; ++i)
+	{
+		m_threads.emplace_back([this, i] { worker_loop(i); });
+	}
+}
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(m_wake_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	m_threads.clear(); // Join before the condition variable goes away
+}
+void ThreadPool::parallel_for(std::size_t count, std::size_t grain, const RangeTask& body)
+{
+	if (count == 0)
+		return;
+	grain = std::max<std::size_t>(grain, 1);
+	if (m_threads.empty() || count <= grain || t_running_pool == this)
+	{
+		RunningScope scope(this);
+		body(0, count); // Not worth waking anyone, or already inside a loop of this pool
+		return;
+	}
+
+	std::lock_guard submit_lock(m_submit_mutex);
+	const std::size_t chunk_count = (count + grain - 1) / grain;
+	m_body						  = &body;
+	m_pending.store(chunk_count);
+	for (std::size_t chunk = 0; chunk < chunk_count; ++chunk)
+	{
+		auto&		 queue = *m_queues[chunk % m_queues.size()];
+		std::size_t begin = chunk * grain;
+		std::lock_guard lock(queue.mutex);
+		queue.ranges.push_back({begin, std::min(begin + grain, count)});
+	}
+	{
+		std::lock_guard lock(m_wake_mutex);
+		++m_generation;
+	}
+	m_wake.notify_all();
+	run_until_done(m_queues.size() - 1);
+	// Nobody can be in body any more once m_pending is zero
+	m_body = nullptr;
+	if (m_failed.exchange(false))
+		std::rethrow_exception(std::exchange(m_error, nullptr));
+}
+std::size_t ThreadPool::thread_count() const
+{
+	return m_queues.size();
+}
+bool ThreadPool::try_pop(std::size_t queue, Range& out)
+{
+	{
+		auto&			own = *m_queues[queue];
+		std::lock_guard lock(own.mutex);
+		if (!own.ranges.empty())
+		{
+			out = own.ranges.back();
+			own.ranges.pop_back();
+			return true;
+		}
+	}
+	for (std::size_t offset = 1; offset < m_queues.size(); ++offset)
+	{
+		auto&			victim = *m_queues[(queue + offset) % m_queues.size()];
+		std::lock_guard lock(victim.mutex);
+		if (!victim.ranges.empty())
+		{
+			out = victim.ranges.front();
+			victim.ranges.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+bool ThreadPool::is_running_task()
+{
+	return t_running_pool != nullptr;
+}
+void ThreadPool::run_until_done(std::size_t queue)
+{
+	RunningScope scope(this);
+	while (m_pending.load(std::memory_order_acquire) != 0)
+	{
+		Range range;
+		if (try_pop(queue, range))
+		{
+			// After a failure the remaining chunks are only counted down, parallel_for rethrows
+			if (!m_failed.load(std::memory_order_relaxed))
+			{
+				try
+				{
+					(*m_body)(range.begin, range.end);
+				}
+				catch (...)
+				{
+					std::lock_guard lock(m_error_mutex);
+					if (!m_error)
+						m_error = std::current_exception();
+					m_failed.store(true, std::memory_order_relaxed);
+				}
+			}
+			m_pending.fetch_sub(1, std::memory_order_acq_rel);
+		}
+		else
+		{
+			std::this_thread::yield(); // Last chunks are still running somewhere else
+		}
+	}
+}
+void ThreadPool::worker_loop(std::size_t queue)
+{
+	std::uint64_t seen_generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock lock(m_wake_mutex);
+			m_wake.wait(lock, [&] { return m_stopping || m_generation != seen_generation; });
+			if (m_stopping)
+				return;
+			seen_generation = m_generation;
+		}
+		run_until_done(queue);
+	}
+}
@@ -0,0 +1,420 @@
+//
+// Created by chris on 10/18/26.
+//
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <RobotArm/Simulation/Trajectory.hpp>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little, "Trajectory logs are written in native byte order");
+
+namespace
+{
+constexpr char			MAGIC[8]		   = {'R', 'A', 'T', 'R', 'A', 'J', '\0', '\0'};
+constexpr std::uint32_t VERSION			   = 1;
+constexpr std::size_t	INITIAL_SIZE	   = 1 << 20;
+constexpr std::size_t	MAX_VARINT_BYTES   = 10;
+constexpr std::size_t	TIP_VALUE_COUNT	   = 6; // Position and velocity
+constexpr std::size_t	VELOCITY_VALUES_AT = 3; // Tip velocity are the last three values
+
+struct FileHeader
+{
+	char		  magic[8];
+	std::uint32_t version;
+	std::uint32_t component_count;
+	std::uint32_t joint_count;
+	std::uint32_t keyframe_interval;
+	float		  dt;
+	float		  position_resolution;
+	float		  velocity_resolution;
+	std::uint32_t finished;
+	std::uint64_t frame_count;
+	std::uint64_t stream_offset;
+	std::uint64_t index_offset;
+	std::uint64_t keyframe_count;
+};
+static_assert(sizeof(FileHeader) == 72);
+
+struct ComponentRecord
+{
+	std::uint32_t type;
+	float		  parameter; // Link length or Piston max length
+};
+
+std::size_t mask_bytes(std::size_t value_count)
+{
+	return (value_count + 7) / 8;
+}
+
+std::uint64_t zigzag(std::int64_t value)
+{
+	return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+std::int64_t unzigzag(std::uint64_t value)
+{
+	return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+std::byte* write_varint(std::byte* out, std::uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		*out++ = static_cast<std::byte>(value | 0x80);
+		value >>= 7;
+	}
+	*out++ = static_cast<std::byte>(value);
+	return out;
+}
+std::uint64_t read_varint(std::span<const std::byte> bytes, std::size_t& offset)
+{
+	std::uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (offset >= bytes.size())
+			throw std::runtime_error("trajectory frame stream is truncated");
+		auto byte = static_cast<std::uint64_t>(bytes[offset++]);
+		value |= (byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+	throw std::runtime_error("trajectory frame stream is corrupt");
+}
+
+template <class T>
+T read_struct(std::span<const std::byte> bytes, std::size_t offset)
+{
+	if (offset + sizeof(T) > bytes.size())
+		throw std::runtime_error("trajectory log is truncated");
+	T value;
+	std::memcpy(&value, bytes.data() + offset, sizeof(T));
+	return value;
+}
+
+float resolution_of(const TrajectorySettings& settings, std::size_t value, std::size_t value_count)
+{
+	return value >= value_count - VELOCITY_VALUES_AT ? settings.velocity_resolution : settings.position_resolution;
+}
+} // namespace
+
+TrajectoryRecorder::TrajectoryRecorder(const std::filesystem::path& path, const Simulation& sim,
+									   TrajectorySettings settings)
+	: m_file(MappedFile::create(path, INITIAL_SIZE))
+	, m_settings(settings)
+	, m_component_count(sim.get_components().size())
+	, m_joint_count(sim.get_joint_count())
+{
+	if (m_settings.keyframe_interval == 0)
+		throw std::invalid_argument("keyframe_interval must be at least 1");
+	if (!sim.is_serial())
+		throw std::invalid_argument("Only serial arms can be recorded, the file has no room for parents");
+	std::size_t value_count = m_joint_count + TIP_VALUE_COUNT;
+	m_previous.resize(value_count);
+	m_before_previous.resize(value_count);
+	m_residuals.resize(value_count);
+	m_values.resize(value_count);
+	m_inverse_resolution.resize(value_count);
+	for (std::size_t i = 0; i < value_count; ++i)
+		m_inverse_resolution[i] = 1.0f / resolution_of(m_settings, i, value_count);
+
+	m_write_offset = sizeof(FileHeader);
+	reserve(m_component_count * sizeof(ComponentRecord));
+	for (const auto& component : sim.get_components())
+	{
+		ComponentRecord record{static_cast<std::uint32_t>(component.index()), 0.0f};
+		if (const auto* link = std::get_if<Link>(&component))
+			record.parameter = link->length;
+		else if (const auto* piston = std::get_if<Piston>(&component))
+			record.parameter = piston->max_length;
+		std::memcpy(m_file.bytes().data() + m_write_offset, &record, sizeof(record));
+		m_write_offset += sizeof(record);
+	}
+}
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+	try
+	{
+		finish();
+	}
+	catch (...)
+	{
+		// Nothing sensible to do about a full disk in a destructor, the log just stays unreadable
+	}
+}
+void TrajectoryRecorder::reserve(std::size_t bytes)
+{
+	if (m_write_offset + bytes <= m_file.size())
+		return;
+	m_file.resize(std::max(m_file.size() * 2, m_write_offset + bytes));
+}
+void TrajectoryRecorder::flush_zero_run()
+{
+	if (m_zero_run == 0)
+		return;
+	std::size_t mask_size = mask_bytes(m_values.size());
+	reserve(mask_size + MAX_VARINT_BYTES);
+	std::byte* out = m_file.bytes().data() + m_write_offset;
+	std::memset(out, 0, mask_size); // An empty mask marks a run
+	out			   = write_varint(out + mask_size, m_zero_run);
+	m_write_offset = static_cast<std::size_t>(out - m_file.bytes().data());
+	m_zero_run	   = 0;
+}
+void TrajectoryRecorder::record(const Simulation& sim)
+{
+	if (m_finished)
+		throw std::logic_error("trajectory was already finished");
+	auto components = sim.get_components();
+	if (components.size() != m_component_count)
+		throw std::logic_error("arm changed its topology while recording");
+
+	// One pass over the cached chain for joint positions and tip velocity
+	auto				   chain = sim.get_chain();
+	TipVelocityAccumulator velocity;
+	std::size_t			   joint = 0;
+	for (std::size_t i = 0; i < components.size(); ++i)
+	{
+		std::visit(
+			[&](const auto& held)
+			{
+				if constexpr (requires { held.position(); })
+				{
+					if (joint == m_joint_count)
+						throw std::logic_error("arm changed its topology while recording");
+					m_values[joint++] = held.position();
+				}
+				held.add_tip_velocity(velocity, chain[i]);
+			},
+			components[i]);
+	}
+	if (joint != m_joint_count)
+		throw std::logic_error("arm changed its topology while recording");
+	glm::vec3 tip		   = chain.empty() ? glm::vec3{0.0f} : chain.back().translation;
+	glm::vec3 tip_velocity = velocity.velocity_at(tip);
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		m_values[m_joint_count + axis]						= tip[axis];
+		m_values[m_joint_count + VELOCITY_VALUES_AT + axis] = tip_velocity[axis];
+	}
+
+	std::size_t value_count = m_values.size();
+	bool		is_keyframe = m_frame_count % m_settings.keyframe_interval == 0;
+	bool		predicted	= true;
+	for (std::size_t i = 0; i < value_count; ++i)
+	{
+		auto quantized = std::llround(m_values[i] * m_inverse_resolution[i]);
+		m_residuals[i] = is_keyframe ? quantized : quantized - (2 * m_previous[i] - m_before_previous[i]);
+		predicted &= m_residuals[i] == 0;
+		// After a keyframe both history entries hold the same value, the first prediction is a plain delta
+		m_before_previous[i] = is_keyframe ? quantized : m_previous[i];
+		m_previous[i]		 = quantized;
+	}
+	++m_frame_count;
+
+	if (predicted && !is_keyframe)
+	{
+		++m_zero_run;
+		return;
+	}
+	flush_zero_run();
+	std::size_t mask_size = is_keyframe ? 0 : mask_bytes(value_count);
+	reserve(mask_size + value_count * MAX_VARINT_BYTES);
+	if (is_keyframe)
+		m_index.push_back({m_frame_count - 1, m_write_offset});
+
+	std::byte* out = m_file.bytes().data() + m_write_offset;
+	std::memset(out, 0, mask_size);
+	std::byte* values = out + mask_size;
+	for (std::size_t i = 0; i < value_count; ++i)
+	{
+		if (!is_keyframe)
+		{
+			if (m_residuals[i] == 0)
+				continue;
+			out[i / 8] |= static_cast<std::byte>(1u << (i % 8));
+		}
+		values = write_varint(values, zigzag(m_residuals[i]));
+	}
+	m_write_offset = static_cast<std::size_t>(values - m_file.bytes().data());
+}
+void TrajectoryRecorder::finish()
+{
+	if (m_finished)
+		return;
+	flush_zero_run();
+
+	std::size_t index_offset = (m_write_offset + 7) & ~std::size_t{7};
+	std::size_t index_size	 = m_index.size() * sizeof(TrajectoryKeyframe);
+	reserve(index_offset - m_write_offset + index_size);
+	if (index_size > 0)
+		std::memcpy(m_file.bytes().data() + index_offset, m_index.data(), index_size);
+
+	FileHeader header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version			   = VERSION;
+	header.component_count	   = static_cast<std::uint32_t>(m_component_count);
+	header.joint_count		   = static_cast<std::uint32_t>(m_joint_count);
+	header.keyframe_interval   = m_settings.keyframe_interval;
+	header.dt				   = m_settings.dt;
+	header.position_resolution = m_settings.position_resolution;
+	header.velocity_resolution = m_settings.velocity_resolution;
+	header.finished			   = 1;
+	header.frame_count		   = m_frame_count;
+	header.stream_offset	   = sizeof(FileHeader) + m_component_count * sizeof(ComponentRecord);
+	header.index_offset		   = index_offset;
+	header.keyframe_count	   = m_index.size();
+	std::memcpy(m_file.bytes().data(), &header, sizeof(header));
+
+	m_file.resize(index_offset + index_size);
+	m_write_offset = index_offset + index_size;
+	m_finished	   = true;
+}
+
+TrajectoryPlayer::TrajectoryPlayer(const std::filesystem::path& path)
+	: m_file(MappedFile::open_read(path))
+{
+	auto header = read_struct<FileHeader>(m_file.bytes(), 0);
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+		throw std::runtime_error(path.string() + " is not a trajectory log");
+	if (!header.finished)
+		throw std::runtime_error(path.string() + " was not finished, the recording was interrupted");
+
+	m_settings		 = {header.dt, header.keyframe_interval, header.position_resolution, header.velocity_resolution};
+	m_frame_count	 = header.frame_count;
+	m_keyframe_count = header.keyframe_count;
+	m_index_offset	 = header.index_offset;
+	m_joint_count	 = header.joint_count;
+	if (m_index_offset + m_keyframe_count * sizeof(TrajectoryKeyframe) > m_file.size())
+		throw std::runtime_error(path.string() + " is truncated");
+
+	for (std::uint32_t i = 0; i < header.component_count; ++i)
+	{
+		auto record = read_struct<ComponentRecord>(m_file.bytes(), sizeof(FileHeader) + i * sizeof(ComponentRecord));
+		switch (record.type)
+		{
+			case 0: m_arm.add_piston(record.parameter); break;
+			case 1: m_arm.add_hinge(); break;
+			case 2: m_arm.add_swivel(); break;
+			case 3: m_arm.add_link(record.parameter); break;
+			default: throw std::runtime_error(path.string() + " has an unknown component type");
+		}
+	}
+	if (m_arm.get_joint_count() != m_joint_count)
+		throw std::runtime_error(path.string() + " has an inconsistent arm description");
+
+	std::size_t value_count = m_joint_count + TIP_VALUE_COUNT;
+	m_previous.resize(value_count);
+	m_before_previous.resize(value_count);
+	m_values.resize(value_count);
+	if (m_frame_count > 0)
+		seek_frame(0);
+}
+double TrajectoryPlayer::duration() const
+{
+	return m_frame_count == 0 ? 0.0 : static_cast<double>(m_frame_count - 1) * m_settings.dt;
+}
+TrajectoryKeyframe TrajectoryPlayer::keyframe(std::uint64_t i) const
+{
+	return read_struct<TrajectoryKeyframe>(m_file.bytes(), m_index_offset + i * sizeof(TrajectoryKeyframe));
+}
+void TrajectoryPlayer::decode_keyframe(const TrajectoryKeyframe& keyframe)
+{
+	m_read_offset = keyframe.offset;
+	for (std::size_t i = 0; i < m_previous.size(); ++i)
+	{
+		m_previous[i]		 = unzigzag(read_varint(m_file.bytes(), m_read_offset));
+		m_before_previous[i] = m_previous[i];
+	}
+	m_frame	   = keyframe.frame;
+	m_zero_run = 0;
+}
+void TrajectoryPlayer::decode_next()
+{
+	++m_frame;
+	if (m_frame % m_settings.keyframe_interval == 0)
+	{
+		decode_keyframe({m_frame, m_read_offset});
+		return;
+	}
+
+	std::size_t value_count = m_previous.size();
+	std::size_t mask_size	= mask_bytes(value_count);
+	if (m_zero_run == 0)
+	{
+		if (m_read_offset + mask_size > m_index_offset)
+			throw std::runtime_error("trajectory frame stream is truncated");
+		const std::byte* mask  = m_file.bytes().data() + m_read_offset;
+		bool			 empty = std::all_of(mask, mask + mask_size, [](std::byte b) { return b == std::byte{0}; });
+		m_read_offset += mask_size;
+		if (!empty)
+		{
+			for (std::size_t i = 0; i < value_count; ++i)
+			{
+				std::int64_t residual = 0;
+				if ((mask[i / 8] & static_cast<std::byte>(1u << (i % 8))) != std::byte{0})
+					residual = unzigzag(read_varint(m_file.bytes(), m_read_offset));
+				auto value			 = 2 * m_previous[i] - m_before_previous[i] + residual;
+				m_before_previous[i] = m_previous[i];
+				m_previous[i]		 = value;
+			}
+			return;
+		}
+		m_zero_run = read_varint(m_file.bytes(), m_read_offset);
+	}
+	--m_zero_run;
+	for (std::size_t i = 0; i < value_count; ++i)
+	{
+		auto value			 = 2 * m_previous[i] - m_before_previous[i];
+		m_before_previous[i] = m_previous[i];
+		m_previous[i]		 = value;
+	}
+}
+void TrajectoryPlayer::seek_frame(std::uint64_t frame)
+{
+	if (m_frame_count == 0)
+		return;
+	frame = std::min(frame, m_frame_count - 1);
+	if (!m_valid || frame < m_frame || frame / m_settings.keyframe_interval != m_frame / m_settings.keyframe_interval)
+	{
+		// Last keyframe at or before frame
+		std::uint64_t low = 0, high = m_keyframe_count;
+		while (high - low > 1)
+		{
+			std::uint64_t middle = low + (high - low) / 2;
+			if (keyframe(middle).frame <= frame)
+				low = middle;
+			else
+				high = middle;
+		}
+		decode_keyframe(keyframe(low));
+		m_valid = true;
+	}
+	while (m_frame < frame)
+		decode_next();
+
+	std::size_t value_count = m_values.size();
+	for (std::size_t i = 0; i < value_count; ++i)
+		m_values[i] = static_cast<float>(m_previous[i]) * resolution_of(m_settings, i, value_count);
+	m_arm.set_joint_positions(std::span<const float>(m_values.data(), m_joint_count));
+}
+void TrajectoryPlayer::seek(double time)
+{
+	seek_frame(static_cast<std::uint64_t>(std::max(0.0, std::round(time / m_settings.dt))));
+}
+glm::vec3 TrajectoryPlayer::tip_position() const
+{
+	return {m_values[m_joint_count], m_values[m_joint_count + 1], m_values[m_joint_count + 2]};
+}
+glm::vec3 TrajectoryPlayer::tip_velocity() const
+{
+	std::size_t at = m_joint_count + VELOCITY_VALUES_AT;
+	return {m_values[at], m_values[at + 1], m_values[at + 2]};
+}
+void TrajectoryPlayer::get_render_data(RenderData& out, double time)
+{
+	seek(time);
+	m_arm.get_render_data(out, {.compute_tip_velocity = false});
+	out.tip_pos = tip_position();
+	out.tip_vel = tip_velocity();
+}
@@ -1,10 +1,15 @@
 #include <QApplication>
 #include <QHBoxLayout>
 #include <QMainWindow>
+#include <QStatusBar>
 #include <QSurfaceFormat>
 #include <QTabWidget>
+#include <fstream>
+#include <optional>
 #include <RobotArm/Qt/GLWindow.hpp>
 #include <RobotArm/Qt/ShaderControls.hpp>
+#include <RobotArm/Simulation/ArmScript.hpp>
+#include <RobotArm/Simulation/ArmSnapshot.hpp>
 
 #include "RobotArm/Qt/RobotArmControls.hpp"
 
@@ -34,7 +39,39 @@ int main(int argc, char* argv[]) {
     layout->setContentsMargins(0, 0, 0, 0);
     layout->setSpacing(0);
 
+    auto* statusBar = mainWindow.statusBar();
+
     auto* glWindow = new GLWindow();
+    // robot_arm --replay log.rtraj plays back a recording, e.g. one from robot_arm_sim --record
+    auto args = QApplication::arguments();
+    if (auto replay = args.indexOf("--replay"); replay >= 0 && replay + 1 < args.size()) {
+        try {
+            glWindow->get_scene().replay(args[replay + 1].toStdString());
+        } catch (const std::exception& error) {
+            qWarning() << "Could not replay" << args[replay + 1] << ":" << error.what();
+        }
+    }
+    // robot_arm --segment-velocities draws the velocity of every joint frame next to the tip one
+    if (args.contains("--segment-velocities"))
+        glWindow->get_scene().show_segment_velocities(true);
+    // robot_arm --arm arm.rsnap|arm.txt starts with that arm instead of the example one
+    std::optional<Simulation> arm;
+    if (auto path = args.indexOf("--arm"); path >= 0 && path + 1 < args.size()) {
+        try {
+            std::filesystem::path file = args[path + 1].toStdString();
+            if (file.extension() == ".rsnap") {
+                arm = ArmSnapshot::load(file).to_simulation();
+            } else {
+                std::ifstream in(file);
+                if (!in) throw std::runtime_error("cannot be opened");
+                arm = parse_arm_description(in);
+            }
+        } catch (const std::exception& error) {
+            qWarning() << "Could not load arm" << args[path + 1] << ":" << error.what();
+            statusBar->showMessage(QString("Could not load arm %1: %2, showing the example arm")
+                                       .arg(args[path + 1], error.what()));
+        }
+    }
     auto* glContainer = QWidget::createWindowContainer(glWindow, central);
     glContainer->setMinimumSize(400, 400);
     glContainer->setFocusPolicy(Qt::StrongFocus);
@@ -54,62 +91,84 @@ int main(int argc, char* argv[]) {
     mainWindow.setCentralWidget(central);
 
     QObject::connect(glWindow, &GLWindow::initialized, glWindow, [=]() {
-        auto& sim = glWindow->get_scene().get_simulation();
-
+        auto& simulation = glWindow->get_scene().get_simulation();
+        if (arm) {
+            // The restored arm runs as is, positions, targets, mass properties and branches included, and keeps its
+            // handles. The widgets only mirror the targets
+            auto components = arm->get_components();
+            for (std::size_t i = 0; i < components.size(); ++i) {
+                auto handle = arm->get_handle(i);
+                if (const auto* piston = std::get_if<Piston>(&components[i]))
+                    armControls->addPistonWidget(handle, piston->max_length, piston->target_length);
+                else if (const auto* hinge = std::get_if<Hinge>(&components[i]))
+                    armControls->addHingeWidget(handle, hinge->target_angle);
+                else if (const auto* swivel = std::get_if<Swivel>(&components[i]))
+                    armControls->addSwivelWidget(handle, swivel->rotational_speed);
+                else
+                    armControls->addLinkWidget(handle, std::get<Link>(components[i]).length);
+            }
+            if (!arm->is_serial())
+                statusBar->showMessage("Branched arm: the controls list every branch in storage order, "
+                                       "added components attach to the last one");
+            simulation.set_simulation(*arm);
+            return;
+        }
         // Initialize with some example components
-        sim.add_link(2.0f);
-        sim.add_hinge();
-        sim.add_piston(3.0f);
-        sim.add_swivel();
-        sim.add_link(1.5f);
-
-        armControls->addLinkWidget(2.0f);
-        armControls->addHingeWidget(0.0f);
-        armControls->addPistonWidget(3.0f);
-        armControls->addSwivelWidget(0.0f);
-        armControls->addLinkWidget(1.5f);
+        armControls->addLinkWidget(simulation.add_link(2.0f), 2.0f);
+        armControls->addHingeWidget(simulation.add_hinge(), 0.0f);
+        armControls->addPistonWidget(simulation.add_piston(3.0f), 3.0f);
+        armControls->addSwivelWidget(simulation.add_swivel(), 0.0f);
+        armControls->addLinkWidget(simulation.add_link(1.5f), 1.5f);
     });
 
-    // Component addition signals
+    // Component addition signals, widgets only appear if the command made it into the queue
     QObject::connect(armControls, &RobotArmControls::pistonAdded,
-        [glWindow](float maxLength) {
-            glWindow->get_scene().get_simulation().add_piston(maxLength);
+        [glWindow, armControls](float maxLength) {
+            auto handle = glWindow->get_scene().get_simulation().add_piston(maxLength);
+            if (!handle.is_null()) armControls->addPistonWidget(handle, maxLength);
         });
 
     QObject::connect(armControls, &RobotArmControls::hingeAdded,
-        [glWindow]() {
-            glWindow->get_scene().get_simulation().add_hinge();
+        [glWindow, armControls]() {
+            auto handle = glWindow->get_scene().get_simulation().add_hinge();
+            if (!handle.is_null()) armControls->addHingeWidget(handle);
         });
 
     QObject::connect(armControls, &RobotArmControls::swivelAdded,
-        [glWindow]() {
-            glWindow->get_scene().get_simulation().add_swivel();
+        [glWindow, armControls]() {
+            auto handle = glWindow->get_scene().get_simulation().add_swivel();
+            if (!handle.is_null()) armControls->addSwivelWidget(handle);
         });
 
     QObject::connect(armControls, &RobotArmControls::linkAdded,
-        [glWindow](float length) {
-            glWindow->get_scene().get_simulation().add_link(length);
+        [glWindow, armControls](float length) {
+            auto handle = glWindow->get_scene().get_simulation().add_link(length);
+            if (!handle.is_null()) armControls->addLinkWidget(handle, length);
         });
 
     // Component control signals
     QObject::connect(armControls, &RobotArmControls::pistonTargetLengthChanged,
-        [glWindow](std::size_t index, float length) {
-            glWindow->get_scene().get_simulation().set_piston_target_length(index, length);
+        [glWindow](ComponentHandle handle, float length) {
+            glWindow->get_scene().get_simulation().post({SimulationCommand::Type::SetPistonTargetLength, handle, length});
         });
 
     QObject::connect(armControls, &RobotArmControls::hingeTargetAngleChanged,
-        [glWindow](std::size_t index, float angle) {
-            glWindow->get_scene().get_simulation().set_hinge_target_angle(index, angle);
+        [glWindow](ComponentHandle handle, float angle) {
+            glWindow->get_scene().get_simulation().post({SimulationCommand::Type::SetHingeTargetAngle, handle, angle});
         });
 
     QObject::connect(armControls, &RobotArmControls::swivelRotationalSpeedChanged,
-        [glWindow](std::size_t index, float speed) {
-            glWindow->get_scene().get_simulation().set_swivel_rotation_speed(index, speed);
+        [glWindow](ComponentHandle handle, float speed) {
+            glWindow->get_scene().get_simulation().post({SimulationCommand::Type::SetSwivelRotationSpeed, handle, speed});
         });
 
-    QObject::connect(armControls, &RobotArmControls::componentRemoved,
-        [glWindow](std::size_t index) {
-            glWindow->get_scene().get_simulation().remove_component(index);
+    // Like additions, the widget only goes away if the removal made it into the queue
+    QObject::connect(armControls, &RobotArmControls::componentRemoveRequested,
+        [glWindow, armControls, statusBar](ComponentHandle handle) {
+            if (glWindow->get_scene().get_simulation().remove_component(handle))
+                armControls->removeComponentWidget(handle);
+            else
+                statusBar->showMessage("Could not remove the component, the command queue is full. Try again");
         });
 
 	QObject::connect(shaderControls, &ShaderControls::settingsChanged,
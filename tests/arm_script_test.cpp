@@ -0,0 +1,63 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <RobotArm/Simulation/ArmScript.hpp>
+#include <sstream>
+#include <stdexcept>
+
+SCENARIO("Arm descriptions and command scripts are parsed from text")
+{
+	GIVEN("An arm description with comments and blank lines")
+	{
+		std::istringstream in("# base\nlink 2.0\nhinge\n\npiston 3.0 # extends\nswivel\nlink 1.5\n");
+
+		WHEN("it is parsed")
+		{
+			auto sim = parse_arm_description(in);
+
+			THEN("the components are added in order")
+			{
+				std::vector expected{ComponentType::Link, ComponentType::Hinge, ComponentType::Piston,
+									 ComponentType::Swivel, ComponentType::Link};
+				REQUIRE(sim.get_component_types() == expected);
+				REQUIRE(std::get<Piston>(sim.get_components()[2]).max_length == 3.0f);
+			}
+		}
+	}
+
+	GIVEN("A command script")
+	{
+		std::istringstream in("0 hinge 1 0.5\n0.25 swivel_speed 3 1.0\n1 reach 1 2 3\n");
+
+		WHEN("it is parsed")
+		{
+			auto commands = parse_command_script(in);
+
+			THEN("every command keeps its time, target and value")
+			{
+				REQUIRE(commands.size() == 3);
+				REQUIRE(commands[0].type == ScriptCommandType::HingeTarget);
+				REQUIRE(commands[0].index == 1);
+				REQUIRE(commands[0].value == 0.5f);
+				REQUIRE(commands[1].time == 0.25f);
+				REQUIRE(commands[2].type == ScriptCommandType::Reach);
+				REQUIRE(commands[2].target == glm::vec3{1, 2, 3});
+			}
+		}
+	}
+
+	GIVEN("Malformed input")
+	{
+		THEN("parsing fails with the line number")
+		{
+			std::istringstream unknown("link 1\nelbow\n");
+			REQUIRE_THROWS_AS(parse_arm_description(unknown), std::runtime_error);
+			std::istringstream unsorted("1 hinge 0 1\n0 hinge 0 2\n");
+			REQUIRE_THROWS_AS(parse_command_script(unsorted), std::runtime_error);
+			std::istringstream trailing("0 hinge 0 1 2\n");
+			REQUIRE_THROWS_AS(parse_command_script(trailing), std::runtime_error);
+		}
+	}
+}
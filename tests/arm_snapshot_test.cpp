@@ -0,0 +1,145 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <RobotArm/Simulation/ArmScript.hpp>
+#include <RobotArm/Simulation/ArmSnapshot.hpp>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+// Branched arm with every component type mid motion, masses and a removed component so the handle table has history
+Simulation make_arm(ComponentHandle& piston, ComponentHandle& removed)
+{
+	Simulation sim;
+	sim.add_link(1.0f);
+	auto swivel = sim.add_swivel();
+	removed		= sim.add_hinge();
+	piston		= sim.add_piston(3.0f);
+	auto hinge	= sim.add_hinge();
+	auto link	= sim.add_link(0.5f);
+	sim.attach(Link{0.7f}, swivel);
+	sim.remove_component(removed);
+	sim.set_swivel_rotation_speed(swivel, 0.4f);
+	sim.set_piston_target_length(piston, 2.5f);
+	sim.set_hinge_target_angle(hinge, 1.0f);
+	sim.set_mass_properties(link, MassProperties::rod(2.0f, 0.5f));
+	sim.set_gravity({0.0f, -1.62f, 0.0f});
+	sim.tick(0.05f);
+	return sim;
+}
+
+bool same_state(const Simulation& lhs, const Simulation& rhs)
+{
+	auto joints		  = lhs.get_chain();
+	auto other_joints = rhs.get_chain();
+	for (std::size_t i = 0; i < joints.size(); ++i)
+	{
+		if (joints[i].translation != other_joints[i].translation)
+			return false;
+	}
+	return lhs.get_component_types() == rhs.get_component_types()
+		&& std::ranges::equal(lhs.get_parents(), rhs.get_parents()) && lhs.get_gravity() == rhs.get_gravity()
+		&& lhs.get_active_count() == rhs.get_active_count()
+		&& lhs.get_mass_properties()[4].inertia == rhs.get_mass_properties()[4].inertia;
+}
+} // namespace
+
+SCENARIO("Snapshots restore the whole state of an arm", "[snapshot]")
+{
+	GIVEN("A branched arm in motion")
+	{
+		ComponentHandle piston, removed;
+		auto			sim = make_arm(piston, removed);
+		ArmSnapshot		snapshot;
+		snapshot.capture(sim);
+
+		THEN("A simulation made from it matches and keeps the handles")
+		{
+			auto copy = snapshot.to_simulation();
+			REQUIRE(snapshot.component_count() == 6);
+			REQUIRE(same_state(copy, sim));
+			REQUIRE(copy.find(piston) == sim.find(piston));
+			REQUIRE_FALSE(copy.find(removed).has_value());
+			REQUIRE(copy.add_hinge() == sim.add_hinge()); // Same free list too
+		}
+		WHEN("The arm moves on and is rolled back")
+		{
+			Simulation reference = snapshot.to_simulation();
+			for (int i = 0; i < 10; ++i)
+				sim.tick(0.05f);
+			sim.remove_component(piston);
+			snapshot.restore(sim);
+
+			THEN("It is back where it was and ticks on the same way")
+			{
+				REQUIRE(same_state(sim, reference));
+				sim.tick(0.05f);
+				reference.tick(0.05f);
+				REQUIRE(same_state(sim, reference));
+				REQUIRE(sim.find(piston).has_value());
+			}
+		}
+		WHEN("A component added after the snapshot is rolled back")
+		{
+			auto added = sim.add_piston(2.0f);
+			snapshot.restore(sim);
+
+			THEN("Its handle is stale even though its slot is free again with the same generation")
+			{
+				REQUIRE(added.slot == removed.slot);
+				REQUIRE(added.generation == removed.generation + 1);
+				REQUIRE_FALSE(sim.find(added).has_value());
+				REQUIRE_THROWS_AS(sim.set_piston_target_length(added, 1.5f), std::out_of_range);
+				REQUIRE(sim.add_piston(2.0f) == added);
+				REQUIRE(sim.find(added) == 6);
+			}
+		}
+		WHEN("It is saved and loaded")
+		{
+			auto path = std::filesystem::temp_directory_path() / "arm_snapshot_test.rsnap";
+			snapshot.save(path);
+			auto loaded = ArmSnapshot::load(path);
+
+			THEN("The file holds the same bytes and restores the same arm")
+			{
+				REQUIRE(std::ranges::equal(loaded.bytes(), snapshot.bytes()));
+				REQUIRE(same_state(loaded.to_simulation(), sim));
+			}
+			THEN("Damaged files are rejected")
+			{
+				std::filesystem::resize_file(path, snapshot.bytes().size() - 4);
+				REQUIRE_THROWS_AS(ArmSnapshot::load(path), std::runtime_error);
+				std::ofstream(path, std::ios::binary) << "not a snapshot at all, but long enough for a header";
+				REQUIRE_THROWS_AS(ArmSnapshot::load(path), std::runtime_error);
+			}
+			std::filesystem::remove(path);
+		}
+		WHEN("It is written as text")
+		{
+			std::stringstream text;
+			write_arm_description(text, sim);
+			auto parsed = parse_arm_description(text);
+
+			THEN("Parsing the text gives the same arm")
+			{
+				REQUIRE(same_state(parsed, sim));
+				std::stringstream again;
+				write_arm_description(again, parsed);
+				REQUIRE(again.str() == text.str());
+			}
+		}
+	}
+	GIVEN("Text that isn't depth first")
+	{
+		std::istringstream in("link 1\nhinge\nlink 1 parent 0\nlink 1 parent 1\n");
+		THEN("Parsing fails")
+		{
+			REQUIRE_THROWS_AS(parse_arm_description(in), std::runtime_error);
+		}
+	}
+}
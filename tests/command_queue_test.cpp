@@ -0,0 +1,192 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <RobotArm/Simulation/CommandQueue.hpp>
+#include <RobotArm/Simulation/SimulationThread.hpp>
+#include <thread>
+#include <vector>
+
+SCENARIO("The command queue hands values over in order without ever blocking")
+{
+	GIVEN("A queue with room for four values")
+	{
+		CommandQueue<int> queue(4);
+		REQUIRE(queue.capacity() == 4);
+
+		WHEN("it is filled past its capacity")
+		{
+			std::vector<bool> pushed;
+			for (int i = 0; i < 6; ++i)
+				pushed.push_back(queue.try_push(i));
+
+			THEN("the extra values are dropped and counted")
+			{
+				REQUIRE(pushed == std::vector<bool>{true, true, true, true, false, false});
+				REQUIRE(queue.depth() == 4);
+				REQUIRE(queue.dropped() == 2);
+			}
+			THEN("draining returns the accepted values in order and frees the slots")
+			{
+				std::vector<int> out;
+				REQUIRE(queue.drain(out) == 4);
+				REQUIRE(out == std::vector<int>{0, 1, 2, 3});
+				REQUIRE(queue.depth() == 0);
+				REQUIRE(queue.try_push(7));
+				REQUIRE(queue.try_pop() == 7);
+				REQUIRE_FALSE(queue.try_pop().has_value());
+			}
+		}
+	}
+
+	GIVEN("Several producers and one consumer")
+	{
+		constexpr int	  PRODUCERS = 4;
+		constexpr int	  PER_PRODUCER = 10'000;
+		CommandQueue<int> queue(64);
+
+		WHEN("every producer retries until all its values went through")
+		{
+			std::vector<std::jthread> producers;
+			for (int p = 0; p < PRODUCERS; ++p)
+			{
+				producers.emplace_back(
+					[&queue, p]
+					{
+						for (int i = 0; i < PER_PRODUCER; ++i)
+						{
+							while (!queue.try_push(p * PER_PRODUCER + i))
+								std::this_thread::yield();
+						}
+					});
+			}
+			std::vector<int> last(PRODUCERS, -1);
+			bool			 in_order = true;
+			int				 received = 0;
+			while (received < PRODUCERS * PER_PRODUCER)
+			{
+				auto value = queue.try_pop();
+				if (!value)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				int producer = *value / PER_PRODUCER;
+				in_order	 = in_order && *value % PER_PRODUCER == last[producer] + 1;
+				last[producer] = *value % PER_PRODUCER;
+				++received;
+			}
+
+			THEN("nothing is lost and every producer's values stay in order")
+			{
+				REQUIRE(in_order);
+				REQUIRE(last == std::vector<int>(PRODUCERS, PER_PRODUCER - 1));
+			}
+		}
+	}
+}
+
+SCENARIO("Commands to the same component within one batch coalesce")
+{
+	using enum SimulationCommand::Type;
+
+	GIVEN("A batch of slider updates with a topology change in between")
+	{
+		ComponentHandle				   hinge{1, 0};
+		ComponentHandle				   piston{2, 0};
+		ComponentHandle				   swivel{3, 0};
+		std::vector<SimulationCommand> batch{
+			{SetHingeTargetAngle, hinge, 0.1f}, {SetPistonTargetLength, piston, 1.0f},
+			{SetHingeTargetAngle, hinge, 0.2f}, {AddLink, {4, 0}, 1.0f},
+			{SetHingeTargetAngle, hinge, 0.3f}, {SetSwivelAngle, swivel, 0.5f},
+			{AddLink, {5, 0}, 1.0f},
+		};
+
+		WHEN("it is coalesced")
+		{
+			std::size_t dropped = coalesce(batch);
+
+			THEN("only the last command per component and kind survives, in the original order")
+			{
+				REQUIRE(dropped == 2);
+				REQUIRE(batch.size() == 5);
+				REQUIRE(batch[0].type == SetPistonTargetLength);
+				REQUIRE(batch[1].type == AddLink);
+				REQUIRE(batch[2].value == 0.3f);
+				REQUIRE(batch[3].type == SetSwivelAngle);
+				REQUIRE(batch[4].handle == ComponentHandle{5, 0});
+			}
+		}
+	}
+
+	GIVEN("A simulation thread that is driven manually")
+	{
+		Simulation sim;
+		sim.add_link(2.0f);
+		auto hinge = sim.add_hinge();
+		SimulationThread thread(sim, 100.0, 16);
+
+		WHEN("a burst of updates is posted before the next step")
+		{
+			for (int i = 1; i <= 10; ++i)
+				REQUIRE(thread.post({SetHingeTargetAngle, hinge, 0.1f * static_cast<float>(i)}));
+			auto link = thread.add_link(1.5f);
+			REQUIRE(thread.get_command_statistics().depth == 11);
+
+			RenderData out;
+			thread.get_render_data(out, SimulationThread::Clock::now() + std::chrono::milliseconds(15));
+
+			THEN("they are applied in one batch with the slider updates merged")
+			{
+				auto statistics = thread.get_command_statistics();
+				REQUIRE_FALSE(link.is_null());
+				REQUIRE(out.components.size() == 3);
+				REQUIRE(statistics.depth == 0);
+				REQUIRE(statistics.applied == 2);
+				REQUIRE(statistics.coalesced == 9);
+				REQUIRE(statistics.dropped == 0);
+			}
+		}
+
+		WHEN("a component is removed while commands to it are still queued")
+		{
+			auto piston = thread.add_piston(3.0f);
+			REQUIRE(thread.post({SetPistonTargetLength, piston, 2.0f}));
+			RenderData out;
+			auto	   now = SimulationThread::Clock::now();
+			thread.get_render_data(out, now + std::chrono::milliseconds(15));
+			REQUIRE(thread.post({SetPistonTargetLength, piston, 2.5f}));
+			REQUIRE(thread.remove_component(hinge));
+			REQUIRE(thread.post({SetHingeTargetAngle, hinge, 1.0f}));
+			REQUIRE(thread.post({SetPistonTargetLength, piston, 3.0f}));
+			auto link = thread.add_link(1.0f);
+			thread.get_render_data(out, now + std::chrono::milliseconds(30));
+
+			THEN("the rest still reach the right component and the stale one is skipped")
+			{
+				auto statistics = thread.get_command_statistics();
+				REQUIRE(link.slot == hinge.slot); // The freed slot is reused under a new generation
+				REQUIRE(link != hinge);
+				REQUIRE(out.components.size() == 3);
+				REQUIRE(statistics.stale == 1);
+				REQUIRE(statistics.coalesced == 1);
+				REQUIRE_FALSE(thread.remove_component(hinge));
+			}
+		}
+
+		WHEN("more is posted than the queue holds")
+		{
+			int accepted = 0;
+			for (int i = 0; i < 20; ++i)
+				accepted += thread.post({SetHingeTargetAngle, hinge, 0.0f});
+
+			THEN("posting fails instead of waiting and the drops are visible")
+			{
+				REQUIRE(accepted == 16);
+				REQUIRE(thread.get_command_statistics().dropped == 4);
+				REQUIRE(thread.add_hinge().is_null());
+			}
+		}
+	}
+}
@@ -0,0 +1,116 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <filesystem>
+#include <RobotArm/Simulation/DesignSweep.hpp>
+#include <vector>
+
+SCENARIO("Design sweeps evaluate metrics for every candidate", "[design_sweep]")
+{
+	GIVEN("Three link lengths, a hinge or a swivel and two pistons")
+	{
+		DesignSpace space;
+		space.slots.push_back(link_options(1.0f, 2.0f, 3));
+		space.slots.push_back({{ComponentType::Hinge}, {ComponentType::Swivel}});
+		space.slots.push_back(piston_options(1.5f, 2.5f, 2));
+		space.slots.push_back({{ComponentType::Link, 0.5f}});
+
+		// Listed first so it would spoil reach if the metrics shared the arm
+		DesignMetric shorten{"shorten", [](Simulation& sim)
+							 {
+								 sim.remove_component(std::size_t{0});
+								 return static_cast<float>(sim.get_components().size());
+							 }};
+		std::vector<ScriptCommand> script{{.time = 0.0f, .type = ScriptCommandType::HingeTarget, .index = 1, .value = 1.0f}};
+		std::vector<DesignMetric>  metrics{shorten, reach_metric(), cycle_time_metric(script, 0.001f)};
+		auto path = std::filesystem::temp_directory_path() / "design_sweep_test.rsweep";
+
+		THEN("Candidates are counted with the first slot changing fastest")
+		{
+			REQUIRE(space.candidate_count() == 12);
+			std::vector<std::uint32_t> choices(4);
+			space.decode(7, choices);
+			REQUIRE(choices == std::vector<std::uint32_t>{1, 0, 1, 0});
+		}
+		WHEN("Every candidate is enumerated in small batches")
+		{
+			auto statistics = run_design_sweep(space, metrics, path, {.batch_size = 5, .thread_count = 4});
+			auto results	= DesignSweepResults::load(path);
+
+			THEN("There is one row per candidate in order with every metric")
+			{
+				REQUIRE(statistics.candidates == 12);
+				REQUIRE(results.metric_names == std::vector<std::string>{"shorten", "reach", "cycle_time"});
+				REQUIRE(results.candidates.size() == 12);
+				for (std::uint64_t candidate = 0; candidate < 12; ++candidate)
+				{
+					REQUIRE(results.candidates[candidate] == candidate);
+					float link	 = 1.0f + 0.5f * static_cast<float>(results.choices[0][candidate]);
+					float piston = 1.5f + static_cast<float>(results.choices[2][candidate]);
+					REQUIRE(results.metrics[0][candidate] == 3.0f);
+					float swivel = results.choices[1][candidate] == 1 ? 0.15f : 0.0f; // Swivels have some height
+					REQUIRE(results.metrics[1][candidate] == Catch::Approx(link + swivel + piston + 0.5f));
+				}
+			}
+			THEN("Metrics that throw are recorded as NaN")
+			{
+				REQUIRE(statistics.failures == 6);
+				for (std::uint64_t candidate = 0; candidate < 12; ++candidate)
+				{
+					if (results.choices[1][candidate] == 0)
+						REQUIRE(results.metrics[2][candidate] == Catch::Approx(1.0f / Hinge::ROTATION_SPEED).margin(2e-3));
+					else
+						REQUIRE(std::isnan(results.metrics[2][candidate]));
+				}
+			}
+			THEN("One thread writes the same columns")
+			{
+				auto serial_path = std::filesystem::temp_directory_path() / "design_sweep_test_serial.rsweep";
+				run_design_sweep(space, metrics, serial_path, {.batch_size = 7, .thread_count = 1});
+				auto serial = DesignSweepResults::load(serial_path);
+				REQUIRE(serial.candidates == results.candidates);
+				REQUIRE(serial.choices == results.choices);
+				REQUIRE(serial.metrics[1] == results.metrics[1]);
+				std::filesystem::remove(serial_path);
+			}
+			std::filesystem::remove(path);
+		}
+		WHEN("Candidates are sampled")
+		{
+			std::vector<DesignMetric> reach{reach_metric()};
+			run_design_sweep(space, reach, path, {.samples = 40, .seed = 3, .batch_size = 16, .thread_count = 2});
+			auto results = DesignSweepResults::load(path);
+
+			THEN("Every sample names a valid candidate and its choices")
+			{
+				REQUIRE(results.candidates.size() == 40);
+				std::vector<std::uint32_t> choices(4);
+				for (std::size_t row = 0; row < 40; ++row)
+				{
+					REQUIRE(results.candidates[row] < 12);
+					space.decode(results.candidates[row], choices);
+					REQUIRE(choices[0] == results.choices[0][row]);
+					REQUIRE(choices[2] == results.choices[2][row]);
+				}
+			}
+			std::filesystem::remove(path);
+		}
+		WHEN("A script sets a piston past its maximum length")
+		{
+			std::vector<ScriptCommand> too_long{
+				{.time = 0.5f, .type = ScriptCommandType::PistonTarget, .index = 2, .value = 2.0f}};
+			auto	   cycle_time = cycle_time_metric(too_long, 0.01f);
+			Simulation sim;
+			space.build(std::vector<std::uint32_t>{0, 0, 0, 0}, sim);
+
+			THEN("The metric throws instead of asserting")
+			{
+				REQUIRE_THROWS_AS(cycle_time.evaluate(sim), std::invalid_argument);
+			}
+		}
+	}
+}
@@ -0,0 +1,165 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <RobotArm/Simulation/DistanceField.hpp>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+
+namespace
+{
+// Unit cube around the origin as 12 triangles, half of them wound the wrong way round on purpose
+MeshObstacle make_cube_mesh()
+{
+	MeshObstacle mesh;
+	for (int i = 0; i < 8; ++i)
+		mesh.vertices.emplace_back(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+	mesh.indices = {0, 1, 3, 0, 3, 2, 4, 7, 5, 4, 6, 7, 0, 5, 1, 0, 4, 5,
+					2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3};
+	return mesh;
+}
+
+RigidTransform at(glm::vec3 translation)
+{
+	RigidTransform pose;
+	pose.translation = translation;
+	return pose;
+}
+} // namespace
+
+SCENARIO("Signed distance to obstacles", "[distance_field]")
+{
+	GIVEN("A box, a cylinder and a cube mesh, all two units wide")
+	{
+		Obstacle box	  = BoxObstacle{{}, glm::vec3{1.0f}};
+		Obstacle rotated  = BoxObstacle{RigidTransform{}.rotated_z(0.7f), glm::vec3{1.0f}};
+		Obstacle cylinder = CylinderObstacle{{}, 1.0f, 1.0f};
+		Obstacle mesh	  = make_cube_mesh();
+
+		THEN("Distances are exact outside and negative inside")
+		{
+			REQUIRE(signed_distance(box, {3.0f, 0.0f, 0.0f}) == Catch::Approx(2.0f));
+			REQUIRE(signed_distance(box, {2.0f, 2.0f, 1.0f}) == Catch::Approx(std::sqrt(2.0f)));
+			REQUIRE(signed_distance(box, {0.0f, 0.5f, 0.0f}) == Catch::Approx(-0.5f));
+			REQUIRE(signed_distance(cylinder, {0.0f, 0.0f, 3.0f}) == Catch::Approx(2.0f));
+			REQUIRE(signed_distance(cylinder, {0.0f, 3.0f, 0.0f}) == Catch::Approx(2.0f));
+			REQUIRE(signed_distance(cylinder, {0.0f, 0.0f, 0.0f}) == Catch::Approx(-1.0f));
+		}
+		THEN("Rotating a box around its center keeps the distance of points on the rotation axis")
+		{
+			REQUIRE(signed_distance(rotated, {0.0f, 0.0f, 3.0f}) == Catch::Approx(2.0f));
+		}
+		THEN("The mesh agrees with the box even though some triangles are flipped")
+		{
+			for (glm::vec3 point : {glm::vec3{3.0f, 0.0f, 0.0f}, glm::vec3{2.0f, 2.0f, 1.0f}, glm::vec3{0.0f, 0.5f, 0.0f},
+									glm::vec3{-0.2f, 0.3f, 0.9f}})
+				REQUIRE(signed_distance(mesh, point) == Catch::Approx(signed_distance(box, point)).margin(1e-5));
+		}
+	}
+}
+
+SCENARIO("Baked distance fields", "[distance_field]")
+{
+	GIVEN("A field of two obstacles baked on one thread")
+	{
+		std::vector<Obstacle> obstacles{BoxObstacle{at({2.0f, 1.0f, 0.0f}), glm::vec3{0.5f}},
+										CylinderObstacle{at({-2.0f, 0.0f, 0.0f}), 0.5f, 1.0f}};
+		DistanceFieldSettings settings{.voxel_size = 0.1f, .padding = 1.0f, .thread_count = 1};
+		auto				  field = DistanceField::bake(obstacles, settings);
+		auto				  exact = [&](glm::vec3 point)
+		{
+			return std::min(signed_distance(obstacles[0], point), signed_distance(obstacles[1], point));
+		};
+
+		THEN("Samples on grid points are exact and the ones in between within a voxel")
+		{
+			glm::vec3 grid_point = field.origin() + glm::vec3{12.0f, 9.0f, 10.0f} * field.voxel_size();
+			REQUIRE(field.sample(grid_point).distance == Catch::Approx(exact(grid_point)).margin(1e-5));
+			for (glm::vec3 point : {glm::vec3{0.33f, 1.07f, -0.21f}, glm::vec3{-1.23f, 0.5f, 0.44f}})
+				REQUIRE(std::abs(field.sample(point).distance - exact(point)) < settings.voxel_size);
+		}
+		THEN("The gradient points away from the nearest obstacle")
+		{
+			auto sample = field.sample({3.0f, 1.0f, 0.0f});
+			REQUIRE(sample.distance == Catch::Approx(0.5f).margin(0.02f));
+			REQUIRE(sample.gradient.x == Catch::Approx(1.0f).margin(0.05f));
+			REQUIRE(std::abs(sample.gradient.y) < 0.05f);
+		}
+		THEN("Outside the grid the distance keeps growing")
+		{
+			REQUIRE(field.sample({20.0f, 1.0f, 0.0f}).distance == Catch::Approx(17.5f).margin(0.05f));
+		}
+		THEN("Baking on several threads gives the same values")
+		{
+			settings.thread_count = 4;
+			auto parallel		  = DistanceField::bake(obstacles, settings);
+			REQUIRE(std::ranges::equal(parallel.values(), field.values()));
+		}
+		WHEN("It is cached to disk")
+		{
+			auto path = std::filesystem::temp_directory_path() / "distance_field_test.rsdf";
+			std::filesystem::remove(path);
+			auto baked	   = DistanceField::load_or_bake(path, obstacles, settings);
+			auto written   = std::filesystem::last_write_time(path);
+			auto cached	   = DistanceField::load_or_bake(path, obstacles, settings);
+			auto unchanged = std::filesystem::last_write_time(path) == written;
+
+			THEN("The second call loads the same field instead of baking")
+			{
+				REQUIRE(unchanged);
+				REQUIRE(cached.key() == baked.key());
+				REQUIRE(cached.size() == field.size());
+				REQUIRE(std::ranges::equal(cached.values(), field.values()));
+			}
+			THEN("Moving an obstacle bakes again")
+			{
+				obstacles[0] = BoxObstacle{at({3.0f, 1.0f, 0.0f}), glm::vec3{0.5f}};
+				auto moved	 = DistanceField::load_or_bake(path, obstacles, settings);
+				REQUIRE(moved.key() != baked.key());
+				REQUIRE(moved.sample({3.0f, 1.0f, 0.0f}).distance < 0.0f);
+				REQUIRE(DistanceField::load(path).key() == moved.key());
+			}
+			std::filesystem::remove(path);
+		}
+	}
+}
+
+SCENARIO("Render data reports the clearance of every component", "[distance_field]")
+{
+	GIVEN("An upright link with a wall to its right")
+	{
+		Simulation sim;
+		sim.add_link(1.0f);
+		sim.add_hinge();
+		std::vector<Obstacle> obstacles{BoxObstacle{at({2.0f, 0.5f, 0.0f}), {0.5f, 2.0f, 2.0f}}};
+
+		THEN("Without an environment there are no clearances")
+		{
+			REQUIRE(sim.get_render_data().clearances.empty());
+		}
+		WHEN("The wall is set as environment")
+		{
+			sim.set_environment(std::make_shared<const DistanceField>(
+				DistanceField::bake(obstacles, {.voxel_size = 0.05f, .padding = 2.0f, .thread_count = 1})));
+			auto render_data = sim.get_render_data();
+
+			THEN("Every segment knows how far the wall is and in which direction")
+			{
+				REQUIRE(render_data.clearances.size() == 2);
+				const auto& link = render_data.clearances[0];
+				REQUIRE(link.distance == Catch::Approx(1.5f - 0.15f).margin(0.01f));
+				REQUIRE(link.direction.x == Catch::Approx(1.0f).margin(0.01f));
+				REQUIRE(render_data.clearances[1].distance == Catch::Approx(1.5f - 0.33f).margin(0.01f));
+			}
+			THEN("Clearances can be skipped")
+			{
+				sim.get_render_data(render_data, {.compute_clearance = false});
+				REQUIRE(render_data.clearances.empty());
+			}
+		}
+	}
+}
@@ -0,0 +1,99 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <RobotArm/Simulation/JointTrajectory.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+Simulation make_arm()
+{
+	Simulation sim;
+	sim.add_link(2.0f);
+	sim.add_hinge();
+	sim.add_piston(3.0f);
+	sim.add_swivel();
+	sim.add_link(1.0f);
+	return sim;
+}
+
+// Hinge, Piston, Swivel per waypoint
+const std::vector<float> WAYPOINTS{
+	1.0f, 2.0f, 0.5f,
+	1.5f, 2.8f, 1.5f,
+	-0.5f, 1.2f, 1.5f,
+};
+
+
+// Goes through every waypoint within the speed limits and an executor leaves the arm on the last one
+void check_plan(SplineOrder order)
+{
+	Simulation sim		  = make_arm();
+	auto	   trajectory = plan_trajectory(sim, WAYPOINTS, {.order = order});
+	REQUIRE(trajectory.segment_count() == 3);
+
+	std::vector<float> positions(trajectory.stride());
+	trajectory.evaluate(0.0f, positions);
+	REQUIRE(positions[0] == Catch::Approx(0.0f).margin(1e-6));
+	REQUIRE(positions[1] == Catch::Approx(Piston::MIN_LENGTH).margin(1e-6));
+	trajectory.evaluate(trajectory.duration(), positions);
+	for (std::size_t j = 0; j < 3; ++j)
+		REQUIRE(positions[j] == Catch::Approx(WAYPOINTS[6 + j]).margin(1e-4));
+
+	std::vector<float> velocities(trajectory.stride());
+	float			   hinge_peak = 0.0f, piston_peak = 0.0f;
+	for (float time = 0.0f; time < trajectory.duration(); time += 0.001f)
+	{
+		trajectory.evaluate_velocity(trajectory.find_segment(time), time, velocities);
+		hinge_peak	= std::max(hinge_peak, std::abs(velocities[0]));
+		piston_peak = std::max(piston_peak, std::abs(velocities[1]));
+	}
+	REQUIRE(hinge_peak <= Hinge::ROTATION_SPEED * 1.001f);
+	REQUIRE(piston_peak <= Piston::PISTON_SPEED * 1.001f);
+
+	TrajectoryExecutor executor;
+	executor.run(sim, trajectory);
+	while (executor.is_running(sim))
+	{
+		executor.tick(0.01f);
+		sim.tick(0.01f);
+	}
+	sim.get_joint_positions(std::span(positions).first(3));
+	for (std::size_t j = 0; j < 3; ++j)
+		REQUIRE(positions[j] == WAYPOINTS[6 + j]);
+}
+} // namespace
+
+SCENARIO("Joint space trajectories go through every waypoint within the speed limits")
+{
+	GIVEN("A cubic plan")
+	{
+		THEN("it stays within the limits and ends on the last waypoint")
+		{
+			check_plan(SplineOrder::Cubic);
+		}
+	}
+
+	GIVEN("A quintic plan")
+	{
+		THEN("it stays within the limits and ends on the last waypoint")
+		{
+			check_plan(SplineOrder::Quintic);
+		}
+	}
+
+	GIVEN("A piston waypoint beyond its max length")
+	{
+		Simulation sim = make_arm();
+		THEN("planning refuses it")
+		{
+			std::vector<float> waypoint{0.0f, 3.5f, 0.0f};
+			REQUIRE_THROWS_AS(plan_trajectory(sim, waypoint), std::invalid_argument);
+		}
+	}
+}
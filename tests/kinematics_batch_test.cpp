@@ -0,0 +1,135 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <RobotArm/Simulation/KinematicsBatch.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+// Every component type on the main chain and a second finger on the last hinge
+Simulation make_branched_arm()
+{
+	Simulation sim;
+	sim.add_link(1.0f);
+	sim.add_swivel();
+	sim.add_hinge();
+	sim.add_piston(3.0f);
+	auto wrist = sim.add_hinge();
+	sim.add_link(0.5f);
+	sim.add_swivel();
+	sim.attach(Link{0.25f}, wrist);
+	sim.attach(Hinge{}, sim.get_handle(sim.get_components().size() - 1));
+	return sim;
+}
+
+// Random pose of the arm, Piston lengths within their range and angles well past a full turn
+std::vector<float> random_positions(const Simulation& sim, std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> angle(-20.0f, 20.0f);
+	std::uniform_real_distribution<float> length(Piston::MIN_LENGTH, 3.0f);
+	std::vector<float>					  positions;
+	for (const auto& component : sim.get_components())
+	{
+		if (std::holds_alternative<Piston>(component))
+			positions.push_back(length(rng));
+		else if (!std::holds_alternative<Link>(component))
+			positions.push_back(angle(rng));
+	}
+	return positions;
+}
+
+bool approx_equal(const RigidTransform& lhs, const RigidTransform& rhs, float tolerance = 1e-4f)
+{
+	for (int column = 0; column < 3; ++column)
+	{
+		if (glm::length(lhs.rotation[column] - rhs.rotation[column]) > tolerance)
+			return false;
+	}
+	return glm::length(lhs.translation - rhs.translation) <= tolerance;
+}
+} // namespace
+
+SCENARIO("Batched forward kinematics matches the scalar simulation", "[simulation][kinematics]")
+{
+	GIVEN("Arms sharing a branched topology in random poses, not filling the last lane group")
+	{
+		auto					arm = make_branched_arm();
+		std::mt19937			rng(7);
+		std::vector<Simulation> arms;
+		for (int i = 0; i < 37; ++i)
+		{
+			arms.push_back(arm);
+			arms.back().set_joint_positions(random_positions(arm, rng));
+		}
+
+		for (std::size_t lanes : {std::size_t{4}, std::size_t{8}, std::size_t{16}})
+		{
+			WHEN("they are computed " + std::to_string(lanes) + " at a time")
+			{
+				KinematicsBatch batch(arm, lanes);
+				for (const auto& sim : arms)
+					batch.add_arm(sim);
+				batch.compute();
+
+				THEN("every joint and tip agrees with the simulation")
+				{
+					REQUIRE(batch.size() == arms.size());
+					bool joints_match = true;
+					bool tips_match	  = true;
+					for (std::size_t a = 0; a < arms.size(); ++a)
+					{
+						auto chain = arms[a].get_chain();
+						for (std::size_t i = 0; i < chain.size(); ++i)
+							joints_match = joints_match && approx_equal(batch.get_joint(a, i), chain[i]);
+						tips_match = tips_match
+								  && glm::length(batch.get_tip_position(a) - arms[a].get_render_data().tip_pos) < 1e-4f;
+					}
+					REQUIRE(joints_match);
+					REQUIRE(tips_match);
+				}
+			}
+		}
+
+		WHEN("the poses change after the first compute")
+		{
+			KinematicsBatch batch(arm);
+			for (const auto& sim : arms)
+				batch.add_arm(sim);
+			batch.compute();
+			auto positions = random_positions(arm, rng);
+			batch.set_joint_positions(5, positions);
+			arms[5].set_joint_positions(positions);
+			batch.compute();
+
+			THEN("the next compute follows them")
+			{
+				REQUIRE(glm::length(batch.get_tip_position(5) - arms[5].get_render_data().tip_pos) < 1e-4f);
+			}
+		}
+	}
+
+	GIVEN("A batch built from one arm")
+	{
+		KinematicsBatch batch(make_branched_arm());
+
+		THEN("arms with another topology or link length are rejected")
+		{
+			auto longer = make_branched_arm();
+			longer.add_link(1.0f);
+			REQUIRE_THROWS_AS(batch.add_arm(longer), std::invalid_argument);
+
+			Simulation other;
+			other.add_link(2.0f);
+			REQUIRE_THROWS_AS(batch.add_arm(other), std::invalid_argument);
+			REQUIRE(batch.size() == 0);
+		}
+		THEN("only 4, 8 and 16 lanes exist")
+		{
+			REQUIRE_THROWS_AS(KinematicsBatch(make_branched_arm(), 6), std::invalid_argument);
+		}
+	}
+}
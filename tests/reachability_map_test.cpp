@@ -0,0 +1,145 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <RobotArm/Simulation/ReachabilityMap.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <numeric>
+
+namespace
+{
+// The tip moves on a circle of radius 1 around (0, 1, 0) in the XY plane
+Simulation make_arm()
+{
+	Simulation sim;
+	sim.add_link(1.0f);
+	sim.add_hinge();
+	sim.add_link(1.0f);
+	return sim;
+}
+
+std::uint64_t total_hits(const ReachabilityMap& map)
+{
+	return std::accumulate(map.voxels().begin(), map.voxels().end(), std::uint64_t{0},
+						   [](std::uint64_t sum, const ReachabilityVoxel& voxel) { return sum + voxel.hits; });
+}
+} // namespace
+
+SCENARIO("Morton codes", "[reachability]")
+{
+	GIVEN("Voxel coordinates on both sides of the origin")
+	{
+		glm::ivec3 voxel{-3, 17, -1000};
+		THEN("They survive encoding and decoding")
+		{
+			REQUIRE(ReachabilityMap::morton_decode(ReachabilityMap::morton_encode(voxel)) == voxel);
+		}
+		THEN("Bit 0 holds x, bit 1 y and bit 2 z")
+		{
+			auto origin = ReachabilityMap::morton_encode({0, 0, 0});
+			REQUIRE(ReachabilityMap::morton_encode({1, 0, 0}) == (origin | 1));
+			REQUIRE(ReachabilityMap::morton_encode({0, 1, 0}) == (origin | 2));
+			REQUIRE(ReachabilityMap::morton_encode({0, 0, 1}) == (origin | 4));
+		}
+	}
+}
+
+SCENARIO("Reachability map of a single hinge arm", "[reachability]")
+{
+	GIVEN("A map sampled on one thread")
+	{
+		auto sim = make_arm();
+		auto map = ReachabilityMap::generate(sim, {.voxel_size = 0.1f, .samples = 5000, .thread_count = 1});
+		THEN("Every sample landed in a voxel on the circle")
+		{
+			REQUIRE(map.sample_count() == 5000);
+			REQUIRE(total_hits(map) == 5000);
+			for (const auto& voxel : map.voxels())
+			{
+				auto center = map.voxel_center(voxel.morton);
+				REQUIRE(std::abs(std::hypot(center.x, center.y - 1.0f) - 1.0f) < 0.1f);
+				REQUIRE(voxel.min_manipulability <= voxel.mean_manipulability);
+				REQUIRE(voxel.mean_manipulability <= voxel.max_manipulability);
+			}
+		}
+		THEN("Voxels are sorted by Morton code and can be looked up")
+		{
+			REQUIRE(std::ranges::is_sorted(map.voxels(), {}, &ReachabilityVoxel::morton));
+			REQUIRE(map.find({0.05f, 1.95f, 0.0f}) != nullptr);
+			REQUIRE(map.find({0.0f, 1.0f, 0.0f}) == nullptr);
+		}
+		WHEN("Sampling the same arm on several threads")
+		{
+			auto parallel = ReachabilityMap::generate(sim, {.voxel_size = 0.1f, .samples = 5000, .thread_count = 4});
+			THEN("The hits are identical")
+			{
+				REQUIRE(parallel.voxels().size() == map.voxels().size());
+				for (std::size_t i = 0; i < map.voxels().size(); ++i)
+				{
+					REQUIRE(parallel.voxels()[i].morton == map.voxels()[i].morton);
+					REQUIRE(parallel.voxels()[i].hits == map.voxels()[i].hits);
+					REQUIRE(parallel.voxels()[i].mean_manipulability
+							== Catch::Approx(map.voxels()[i].mean_manipulability));
+				}
+			}
+		}
+		WHEN("Saving and loading it again")
+		{
+			auto path = std::filesystem::temp_directory_path() / "reachability_map_test.rmap";
+			map.save(path);
+			auto loaded = ReachabilityMap::load(path);
+			THEN("Nothing changed")
+			{
+				REQUIRE(loaded.voxel_size() == map.voxel_size());
+				REQUIRE(loaded.sample_count() == map.sample_count());
+				REQUIRE(loaded.voxels().size() == map.voxels().size());
+				REQUIRE(std::ranges::equal(loaded.voxels(), map.voxels(),
+										   [](const ReachabilityVoxel& lhs, const ReachabilityVoxel& rhs)
+										   { return lhs.morton == rhs.morton && lhs.hits == rhs.hits; }));
+				REQUIRE(loaded.find({0.05f, 1.95f, 0.0f}) != nullptr);
+			}
+			std::filesystem::remove(path);
+		}
+	}
+	GIVEN("Stratified sampling with a sample count that isn't a full grid")
+	{
+		Simulation sim = make_arm();
+		sim.add_hinge();
+		sim.add_link(1.0f);
+		auto map = ReachabilityMap::generate(sim, {.samples = 1000, .thread_count = 2});
+		THEN("Every requested sample is taken")
+		{
+			REQUIRE(map.sample_count() == 1000);
+			REQUIRE(total_hits(map) == 1000);
+		}
+	}
+	GIVEN("Stratified sampling of more joints than a grid of the sample count could split")
+	{
+		// 20 joints, a full grid of 1000 samples would have a single stratum per joint. The Swivels only spin the
+		// piston about its own axis, so the tip height is the piston length plus the Swivel heights
+		Simulation sim;
+		sim.add_piston(3.0f);
+		for (int i = 0; i < 19; ++i)
+			sim.add_swivel();
+		constexpr float VOXEL_SIZE = 0.25f;
+		constexpr float STRATUM	   = 2.0f / 1000.0f;
+		const float		offset	   = 19.0f * Swivel::JOINT_HEIGHT;
+		auto map = ReachabilityMap::generate(sim, {.voxel_size = VOXEL_SIZE, .samples = 1000, .thread_count = 2});
+		THEN("Every stratum of the piston is hit once, so each voxel gets its share up to the strata it cuts")
+		{
+			REQUIRE(map.sample_count() == 1000);
+			REQUIRE(total_hits(map) == 1000);
+			for (const auto& voxel : map.voxels())
+			{
+				float bottom   = map.voxel_center(voxel.morton).y - VOXEL_SIZE / 2.0f;
+				float overlap  = std::min(bottom + VOXEL_SIZE, offset + 3.0f) - std::max(bottom, offset + 1.0f);
+				float expected = overlap / STRATUM;
+				REQUIRE(std::abs(static_cast<float>(voxel.hits) - expected) <= 2.0f);
+			}
+		}
+	}
+}
@@ -0,0 +1,99 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <RobotArm/Simulation/SelfCollision.hpp>
+#include <numbers>
+
+namespace
+{
+// Link, then three Link + Hinge pairs, each hinge folding the arm back by the given angle
+Simulation make_folding_arm(float angle)
+{
+	Simulation sim;
+	sim.add_link(1.0f);
+	for (int i = 0; i < 3; ++i)
+	{
+		sim.add_hinge();
+		sim.add_link(1.0f);
+	}
+	std::vector<float> positions{angle, angle, angle};
+	sim.set_joint_positions(positions);
+	return sim;
+}
+} // namespace
+
+SCENARIO("Self collision between arm segments", "[simulation][collision]")
+{
+	SelfCollisionDetector detector;
+	GIVEN("A stretched out arm")
+	{
+		auto sim = make_folding_arm(0.0f);
+		WHEN("Checking for contacts")
+		{
+			auto contacts = detector.detect(sim);
+			THEN("Touching neighbours are ignored")
+			{
+				REQUIRE(contacts.empty());
+				REQUIRE(detector.get_capsules().size() == 7);
+			}
+		}
+	}
+	GIVEN("An arm folded back onto itself")
+	{
+		auto sim = make_folding_arm(std::numbers::pi_v<float>);
+		WHEN("Checking for contacts")
+		{
+			auto contacts = detector.detect(sim);
+			THEN("The links lying on top of each other are reported")
+			{
+				REQUIRE(!contacts.empty());
+				bool first_and_third = false;
+				for (const auto& contact : contacts)
+				{
+					REQUIRE(contact.first < contact.second);
+					REQUIRE(contact.depth > 0.0f);
+					first_and_third |= contact.first == 0 && contact.second == 4;
+				}
+				REQUIRE(first_and_third);
+			}
+		}
+	}
+}
+
+SCENARIO("Self collision between branches", "[simulation][collision]")
+{
+	SelfCollisionDetector detector;
+	GIVEN("A V of two branches on hinges at the fork, the left one with a hinge halfway")
+	{
+		Simulation sim;
+		auto	   base = sim.add_link(1.0f);
+		auto	   fold = sim.attach(Hinge{}, sim.attach(Link{1.5f}, sim.attach(Hinge{}, base)));
+		sim.attach(Link{2.0f}, fold);
+		sim.attach(Link{1.5f}, sim.attach(Hinge{}, base));
+
+		WHEN("the left branch is stretched out")
+		{
+			std::vector<float> positions{0.6f, 0.0f, -0.6f};
+			sim.set_joint_positions(positions);
+			auto contacts = detector.detect(sim);
+			THEN("the segments meeting at the fork are ignored")
+			{
+				REQUIRE(contacts.empty());
+			}
+		}
+		WHEN("the left branch folds across the right one")
+		{
+			std::vector<float> positions{0.6f, -2.63f, -0.6f};
+			sim.set_joint_positions(positions);
+			auto contacts = detector.detect(sim);
+			THEN("the folded segment hits the other branch")
+			{
+				REQUIRE(contacts.size() == 1);
+				REQUIRE(contacts[0].first == 4);
+				REQUIRE(contacts[0].second == 6);
+			}
+		}
+	}
+}
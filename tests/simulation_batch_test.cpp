@@ -0,0 +1,123 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <RobotArm/Simulation/SimulationBatch.hpp>
+#include <RobotArm/Simulation/ThreadPool.hpp>
+#include <stdexcept>
+
+namespace
+{
+// Arms of different length in different motion, so chunks take different time and get stolen
+void fill_batch(SimulationBatch& batch)
+{
+	for (int arm = 0; arm < 97; ++arm)
+	{
+		auto& sim = batch.add_simulation();
+		for (int i = 0; i <= arm % 7; ++i)
+		{
+			sim.add_link(1.0f);
+			auto hinge = sim.add_hinge();
+			sim.set_hinge_target_angle(hinge, 0.1f * static_cast<float>(arm % 11) - 0.5f);
+			auto piston = sim.add_piston(3.0f);
+			sim.set_piston_target_length(piston, 1.0f + 0.02f * static_cast<float>(arm));
+			auto swivel = sim.add_swivel();
+			sim.set_swivel_rotation_speed(swivel, 0.3f * static_cast<float>(i));
+		}
+	}
+}
+
+bool exactly_equal(const RenderData& lhs, const RenderData& rhs)
+{
+	return lhs.components == rhs.components && lhs.tip_pos == rhs.tip_pos && lhs.tip_vel == rhs.tip_vel;
+}
+} // namespace
+
+SCENARIO("Batch results don't depend on the thread count", "[simulation][batch]")
+{
+	GIVEN("The same arms in a batch on one thread and in a batch on several")
+	{
+		SimulationBatch serial(1);
+		SimulationBatch parallel(4);
+		fill_batch(serial);
+		fill_batch(parallel);
+
+		WHEN("both are ticked and render the same frames")
+		{
+			bool every_frame_matches = true;
+			for (int frame = 0; frame < 20; ++frame)
+			{
+				serial.tick(0.01f, 3);
+				parallel.tick(0.01f, 3);
+				serial.compute_render_data();
+				parallel.compute_render_data();
+				for (std::size_t i = 0; i < serial.size(); ++i)
+				{
+					every_frame_matches = every_frame_matches
+									   && exactly_equal(serial.get_render_data()[i], parallel.get_render_data()[i]);
+				}
+			}
+
+			THEN("the render data is bit for bit the same")
+			{
+				REQUIRE(parallel.get_render_data().size() == serial.size());
+				REQUIRE(every_frame_matches);
+			}
+		}
+	}
+}
+
+SCENARIO("Parallel loops hand exceptions back and nest without deadlocking", "[batch]")
+{
+	GIVEN("A pool with several threads")
+	{
+		ThreadPool pool(4);
+
+		WHEN("one chunk of a loop throws")
+		{
+			auto run = [&]
+			{
+				pool.parallel_for(64, 1,
+								  [](std::size_t begin, std::size_t)
+								  {
+									  if (begin == 17)
+										  throw std::runtime_error("chunk failed");
+								  });
+			};
+
+			THEN("parallel_for rethrows it and the pool keeps working")
+			{
+				REQUIRE_THROWS_AS(run(), std::runtime_error);
+
+				std::atomic<std::size_t> visited{0};
+				pool.parallel_for(64, 1, [&](std::size_t begin, std::size_t end) { visited += end - begin; });
+				REQUIRE(visited == 64);
+			}
+		}
+
+		WHEN("a loop body starts another loop on the same pool")
+		{
+			std::atomic<std::size_t> visited{0};
+			std::atomic<std::size_t> outside{0}; // Inner chunks that didn't know they run inside a loop
+			pool.parallel_for(8, 1,
+							  [&](std::size_t, std::size_t)
+							  {
+								  pool.parallel_for(16, 1,
+													[&](std::size_t begin, std::size_t end)
+													{
+														outside += !ThreadPool::is_running_task();
+														visited += end - begin;
+													});
+							  });
+
+			THEN("the inner loop runs inline instead of waiting on the pool forever")
+			{
+				REQUIRE(visited == 8 * 16);
+				REQUIRE(outside == 0);
+				REQUIRE_FALSE(ThreadPool::is_running_task());
+			}
+		}
+	}
+}
@@ -0,0 +1,947 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <array>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <glm/ext/matrix_transform.hpp>
+#include <numbers>
+#include <RobotArm/Simulation/InverseKinematics.hpp>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <RobotArm/Simulation/SimulationBatch.hpp>
+#include <RobotArm/Simulation/SimulationThread.hpp>
+#include <RobotArm/Simulation/StaticSimulation.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+bool approx_equal(const glm::mat4& lhs, const glm::mat4& rhs, float tolerance = 1e-4f)
+{
+	for (int column = 0; column < 4; ++column)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			if (std::abs(lhs[column][row] - rhs[column][row]) > tolerance)
+				return false;
+		}
+	}
+	return true;
+}
+
+// Same components in the same state, but with a cold chain cache
+Simulation rebuild(const Simulation& sim)
+{
+	Simulation fresh;
+	auto	   parents = sim.get_parents();
+	for (std::size_t i = 0; i < parents.size(); ++i)
+	{
+		auto parent = parents[i] == Simulation::NO_PARENT ? ComponentHandle{} : fresh.get_handle(parents[i]);
+		fresh.attach(sim.get_components()[i], parent);
+	}
+	return fresh;
+}
+
+// The cached chain has to be exactly what evaluating everything from the base gives
+bool matches_fresh_chain(const Simulation& sim)
+{
+	auto fresh	  = rebuild(sim);
+	auto cached	  = sim.get_chain();
+	auto expected = fresh.get_chain();
+	if (cached.size() != expected.size())
+		return false;
+	for (std::size_t i = 0; i < cached.size(); ++i)
+	{
+		if (cached[i].rotation != expected[i].rotation || cached[i].translation != expected[i].translation)
+			return false;
+	}
+	return sim.get_render_data().tip_pos == fresh.get_render_data().tip_pos;
+}
+} // namespace
+
+SCENARIO("The rigid transform chain matches the mat4 reference", "[simulation]")
+{
+	GIVEN("A chain with every component type in a non trivial pose")
+	{
+		std::vector<Component> components;
+		for (int i = 0; i < 8; ++i)
+		{
+			float f = static_cast<float>(i);
+			components.emplace_back(Link{1.0f + 0.25f * f});
+			components.emplace_back(Hinge{0.3f * f - 1.0f, 0.0f});
+			components.emplace_back(Piston{1.0f + 0.2f * f, 1.0f, 3.0f});
+			components.emplace_back(Swivel{0.0f, 0.7f * f});
+		}
+
+		WHEN("both chains are evaluated")
+		{
+			glm::mat4	   reference_joint{1.0f};
+			RigidTransform joint;
+			bool		   all_models_match = true;
+			bool		   all_joints_match = true;
+			for (const auto& component : components)
+			{
+				auto [reference_model, next_reference_joint] = component.get_model_matrix(reference_joint);
+				auto next_joint = component.get_joint_transform(joint);
+				all_models_match &= approx_equal(component.emit_model_matrix(joint, next_joint), reference_model);
+				joint = next_joint;
+				reference_joint	 = next_reference_joint;
+				all_joints_match &= approx_equal(joint.to_mat4(), reference_joint);
+			}
+
+			THEN("every model and joint matrix agrees within tolerance")
+			{
+				REQUIRE(all_models_match);
+				REQUIRE(all_joints_match);
+			}
+		}
+	}
+}
+
+SCENARIO("The geometric Jacobian agrees with the tip velocity", "[simulation][jacobian]")
+{
+	GIVEN("An arm with every joint type in motion")
+	{
+		Simulation sim;
+		sim.add_link(2.0f);
+		sim.add_hinge();
+		sim.add_piston(3.0f);
+		sim.add_swivel();
+		sim.add_hinge();
+		sim.add_link(1.5f);
+		sim.set_hinge_target_angle(1, 1.0f);
+		sim.set_piston_target_length(2, 2.5f);
+		sim.set_swivel_rotation_speed(3, 0.8f);
+		sim.set_hinge_target_angle(4, -1.0f);
+		sim.tick(0.1f);
+
+		std::vector<JacobianColumn> jacobian(sim.get_joint_count());
+		std::vector<float>			rates(sim.get_joint_count());
+		sim.get_jacobian(jacobian);
+		sim.get_joint_velocities(rates);
+
+		WHEN("the joint rates are mapped through the Jacobian")
+		{
+			auto twist		 = map_joint_velocities(jacobian, rates);
+			auto render_data = sim.get_render_data();
+
+			THEN("the linear part is the tip velocity")
+			{
+				REQUIRE(sim.get_joint_count() == 4);
+				REQUIRE(twist.linear.x == Catch::Approx(render_data.tip_vel.x).margin(1e-4));
+				REQUIRE(twist.linear.y == Catch::Approx(render_data.tip_vel.y).margin(1e-4));
+				REQUIRE(twist.linear.z == Catch::Approx(render_data.tip_vel.z).margin(1e-4));
+			}
+		}
+
+		WHEN("the velocity ellipsoid is computed")
+		{
+			auto ellipsoid = velocity_ellipsoid(jacobian);
+
+			THEN("its volume matches the translational manipulability")
+			{
+				REQUIRE(ellipsoid.radii.x >= ellipsoid.radii.y);
+				REQUIRE(ellipsoid.radii.y >= ellipsoid.radii.z);
+				REQUIRE(ellipsoid.radii.x * ellipsoid.radii.y * ellipsoid.radii.z ==
+						Catch::Approx(translational_manipulability(jacobian)).epsilon(1e-3));
+				REQUIRE(manipulability(jacobian) == 0.0f); // Only 4 joints
+			}
+		}
+	}
+}
+
+SCENARIO("The IK solver reaches a reachable target within the joint limits", "[simulation][ik]")
+{
+	GIVEN("The example arm and a target taken from another pose of it")
+	{
+		Simulation sim;
+		sim.add_link(2.0f);
+		sim.add_hinge();
+		sim.add_piston(3.0f);
+		sim.add_swivel();
+		sim.add_hinge();
+		sim.add_link(1.5f);
+
+		Simulation posed = sim;
+		posed.set_hinge_target_angle(1, 0.6f);
+		posed.set_piston_target_length(2, 2.2f);
+		posed.set_swivel_angle(3, 1.2f);
+		posed.set_hinge_target_angle(4, -0.8f);
+		posed.tick(5.0f);
+		glm::vec3 target = posed.get_render_data().tip_pos;
+
+		WHEN("the solver runs")
+		{
+			IkSolver solver;
+			auto	 result = solver.solve(sim, target);
+
+			THEN("the targets it wrote move the tip onto the target")
+			{
+				REQUIRE(result.converged);
+				sim.tick(5.0f);
+				REQUIRE(glm::length(sim.get_render_data().tip_pos - target) < 1e-2f);
+				auto piston = std::get<Piston>(sim.get_components()[2]);
+				REQUIRE(piston.target_length >= Piston::MIN_LENGTH);
+				REQUIRE(piston.target_length <= piston.max_length);
+			}
+		}
+	}
+
+	GIVEN("A branched arm whose other finger is on its way to a target")
+	{
+		Simulation sim;
+		sim.add_link(1.0f);
+		auto shoulder = sim.add_hinge();
+		auto finger	  = sim.attach(Hinge{}, shoulder);
+		auto piston	  = sim.attach(Piston{1.0f, 1.0f, 3.0f}, shoulder);
+		sim.attach(Link{1.0f}, piston);
+		sim.set_hinge_target_angle(finger, 1.0f);
+		sim.tick(0.1f);
+
+		Simulation posed = sim;
+		posed.set_hinge_target_angle(shoulder, -0.5f);
+		posed.set_piston_target_length(piston, 2.0f);
+		posed.tick(5.0f);
+		glm::vec3 target = posed.get_render_data().tip_pos;
+
+		WHEN("the solver moves the tip")
+		{
+			IkSolver		   solver;
+			std::vector<float> solution(sim.get_joint_count());
+			auto			   untouched = solver.solve(std::as_const(sim), target, solution);
+			auto			   result	 = solver.solve(sim, target);
+
+			THEN("only the joints on the path to the tip get new targets")
+			{
+				REQUIRE(untouched.converged);
+				REQUIRE(result.converged);
+				auto other = std::get<Hinge>(sim.get_components()[*sim.find(finger)]);
+				REQUIRE(other.target_angle == 1.0f);
+				REQUIRE(other.current_angle < 1.0f);
+				REQUIRE(solution[1] == other.current_angle);
+
+				sim.tick(5.0f);
+				REQUIRE(glm::length(sim.get_render_data().tip_pos - target) < 1e-2f);
+				REQUIRE(std::get<Hinge>(sim.get_components()[*sim.find(finger)]).current_angle == 1.0f);
+			}
+		}
+	}
+}
+
+SCENARIO("The simulation thread steps at a fixed rate and interpolates for the renderer")
+{
+	GIVEN("A simulation thread that is driven manually")
+	{
+		Simulation sim;
+		sim.add_link(2.0f);
+		sim.add_hinge();
+		sim.add_link(1.0f);
+		sim.set_hinge_target_angle(1, 1.0f);
+		SimulationThread thread(sim, 100.0);
+
+		WHEN("two steps are interpolated halfway")
+		{
+			RenderData from = sim.get_render_data();
+			sim.tick(0.01f);
+			RenderData to = sim.get_render_data();
+			RenderData halfway;
+			interpolate(from, to, 0.5f, halfway);
+
+			THEN("the tip lies between both steps")
+			{
+				glm::vec3 expected = (from.tip_pos + to.tip_pos) * 0.5f;
+				REQUIRE(glm::length(halfway.tip_pos - expected) < 1e-5f);
+				REQUIRE(halfway.components.size() == to.components.size());
+			}
+		}
+
+		WHEN("the arm changes shape between two steps")
+		{
+			RenderData from = sim.get_render_data();
+			sim.add_piston(1.0f);
+			RenderData to = sim.get_render_data();
+			RenderData out;
+			interpolate(from, to, 0.5f, out);
+
+			THEN("the newer step is used as is")
+			{
+				REQUIRE(out.components.size() == to.components.size());
+				REQUIRE(out.tip_pos == to.tip_pos);
+			}
+		}
+
+		WHEN("rendering without starting the thread")
+		{
+			RenderData out;
+			auto	   start = SimulationThread::Clock::now();
+			thread.get_render_data(out, start + std::chrono::milliseconds(55));
+
+			THEN("the reader drives the fixed steps itself")
+			{
+				REQUIRE(out.components.size() == 3);
+				REQUIRE(out.tip_pos != sim.get_render_data().tip_pos);
+			}
+		}
+
+		WHEN("a restored arm is swapped in")
+		{
+			Simulation restored;
+			restored.add_link(1.0f);
+			auto piston = restored.add_piston(3.0f);
+			restored.set_joint_positions(std::vector<float>{2.0f});
+			thread.set_simulation(restored);
+			thread.post({SimulationCommand::Type::SetPistonTargetLength, piston, 2.5f});
+			RenderData out;
+			thread.get_render_data(out);
+
+			THEN("it keeps its state and handles instead of starting from defaults")
+			{
+				REQUIRE(out.components.size() == 2);
+				REQUIRE(out.tip_pos.y >= 3.0f - 1e-5f);
+				REQUIRE(thread.get_command_statistics().applied == 1);
+				REQUIRE(thread.get_command_statistics().stale == 0);
+			}
+		}
+
+		WHEN("a component is added to an arm that is then replaced by one where its slot is free")
+		{
+			thread.remove_component(thread.add_piston(2.0f));
+			auto	   added	   = thread.add_piston(2.0f);
+			Simulation replacement = sim;
+			replacement.remove_component(replacement.add_piston(2.0f));
+			thread.set_simulation(replacement);
+
+			THEN("its handle is stale for the new arm")
+			{
+				REQUIRE(added == ComponentHandle{3, 1});
+				REQUIRE_FALSE(thread.remove_component(added));
+				REQUIRE(thread.post({SimulationCommand::Type::SetPistonTargetLength, added, 1.5f}));
+				RenderData out;
+				thread.get_render_data(out, SimulationThread::Clock::now() + std::chrono::milliseconds(55));
+				REQUIRE(thread.get_command_statistics().stale == 1);
+			}
+		}
+
+		WHEN("a piston target out of range is posted")
+		{
+			auto piston = thread.add_piston(2.0f);
+			thread.post({SimulationCommand::Type::SetPistonTargetLength, piston, 5.0f});
+			RenderData out;
+			thread.get_render_data(out, SimulationThread::Clock::now() + std::chrono::milliseconds(55));
+
+			THEN("the simulation thread drops it instead of throwing")
+			{
+				REQUIRE(out.components.size() == 4);
+				REQUIRE(thread.get_command_statistics().stale == 1);
+			}
+		}
+	}
+}
+
+SCENARIO("A compile time arm behaves like the dynamic one")
+{
+	GIVEN("The same Link, Hinge, Piston, Swivel, Link arm built both ways")
+	{
+		Simulation sim;
+		sim.add_link(2.0f);
+		sim.add_hinge();
+		sim.add_piston(3.0f);
+		sim.add_swivel();
+		sim.add_link(1.5f);
+		StaticSimulation<Link, Hinge, Piston, Swivel, Link> static_sim{
+			Link{2.0f}, Hinge{}, Piston{Piston::MIN_LENGTH, Piston::MIN_LENGTH, 3.0f}, Swivel{}, Link{1.5f}};
+
+		WHEN("both get the same commands and ticks")
+		{
+			sim.set_hinge_target_angle(1, 0.7f);
+			sim.set_piston_target_length(2, 2.5f);
+			sim.set_swivel_rotation_speed(3, 1.3f);
+			static_sim.set_hinge_target_angle(1, 0.7f);
+			static_sim.set_piston_target_length(2, 2.5f);
+			static_sim.set_swivel_rotation_speed(3, 1.3f);
+			for (int i = 0; i < 20; ++i)
+			{
+				sim.tick(0.016f);
+				static_sim.tick(0.016f);
+			}
+
+			THEN("render data, Jacobian and joint velocities match exactly")
+			{
+				auto expected = sim.get_render_data();
+				auto actual	  = static_sim.get_render_data();
+				REQUIRE(actual.components.size() == expected.components.size());
+				for (std::size_t i = 0; i < expected.components.size(); ++i)
+				{
+					REQUIRE(actual.components[i].first == expected.components[i].first);
+					REQUIRE(actual.components[i].second == expected.components[i].second);
+				}
+				REQUIRE(actual.tip_pos == expected.tip_pos);
+				REQUIRE(actual.tip_vel == expected.tip_vel);
+				REQUIRE(static_sim.get_component_types() == sim.get_component_types());
+
+				STATIC_REQUIRE(decltype(static_sim)::get_joint_count() == 3);
+				std::vector<JacobianColumn> expected_jacobian(3), actual_jacobian(3);
+				sim.get_jacobian(expected_jacobian);
+				static_sim.get_jacobian(actual_jacobian);
+				for (std::size_t i = 0; i < 3; ++i)
+				{
+					REQUIRE(actual_jacobian[i].linear == expected_jacobian[i].linear);
+					REQUIRE(actual_jacobian[i].angular == expected_jacobian[i].angular);
+				}
+			}
+		}
+
+		WHEN("a setter targets a component of a different type")
+		{
+			THEN("it throws like the dynamic arm does")
+			{
+				REQUIRE_THROWS_AS(static_sim.set_hinge_target_angle(0, 1.0f), std::invalid_argument);
+				REQUIRE_THROWS_AS(static_sim.set_hinge_target_angle(5, 1.0f), std::out_of_range);
+			}
+		}
+
+		WHEN("a piston target is outside the piston's range")
+		{
+			THEN("both throw and keep the old target")
+			{
+				REQUIRE_THROWS_AS(sim.set_piston_target_length(2, 3.5f), std::invalid_argument);
+				REQUIRE_THROWS_AS(sim.set_piston_target_length(2, 0.0f), std::invalid_argument);
+				REQUIRE_THROWS_AS(static_sim.set_piston_target_length(2, 3.5f), std::invalid_argument);
+				REQUIRE_THROWS_AS(static_sim.set_piston_target_length(2, 0.0f), std::invalid_argument);
+				REQUIRE(std::get<Piston>(sim.get_components()[2]).target_length == Piston::MIN_LENGTH);
+				REQUIRE(sim.is_at_rest());
+			}
+		}
+	}
+
+	GIVEN("A compile time arm built with a piston target past the end of the stroke")
+	{
+		StaticSimulation<Piston, Link> static_sim{Piston{Piston::MIN_LENGTH, 5.0f, 3.0f}, Link{1.0f}};
+
+		WHEN("it runs long enough to reach the end")
+		{
+			for (int i = 0; i < 30; ++i)
+				static_sim.tick(0.016f);
+
+			THEN("the piston stops there instead of reporting speed forever")
+			{
+				std::array<float, 1> velocities{};
+				static_sim.get_joint_velocities(velocities);
+				REQUIRE(velocities[0] == 0.0f);
+				REQUIRE(static_sim.get_render_data().tip_vel == glm::vec3{0.0f});
+				REQUIRE(static_sim.get_render_data().tip_pos.y == 4.0f);
+			}
+		}
+	}
+}
+
+SCENARIO("The chain cache only recomputes what changed", "[simulation]")
+{
+	GIVEN("An arm whose chain was evaluated once")
+	{
+		Simulation sim;
+		for (int i = 0; i < 4; ++i)
+		{
+			sim.add_link(1.0f);
+			sim.add_hinge();
+			sim.add_piston(3.0f);
+			sim.add_swivel();
+		}
+		REQUIRE(matches_fresh_chain(sim));
+
+		WHEN("a joint in the middle gets a target, the arm ticks and a component is removed")
+		{
+			sim.set_hinge_target_angle(9, 0.8f);
+			bool after_target = matches_fresh_chain(sim);
+			sim.tick(0.1f);
+			bool after_tick = matches_fresh_chain(sim);
+			sim.set_piston_target_length(6, 2.5f);
+			sim.tick(0.1f);
+			bool after_second_tick = matches_fresh_chain(sim);
+			sim.remove_component(5);
+			bool after_removal = matches_fresh_chain(sim);
+			sim.tick(0.1f);
+			bool after_last_tick = matches_fresh_chain(sim);
+
+			THEN("the cached chain and tip match a freshly built arm after every step")
+			{
+				REQUIRE(after_target);
+				REQUIRE(after_tick);
+				REQUIRE(after_second_tick);
+				REQUIRE(after_removal);
+				REQUIRE(after_last_tick);
+			}
+		}
+	}
+}
+
+SCENARIO("Only moving components are ticked", "[simulation]")
+{
+	GIVEN("A freshly built arm")
+	{
+		Simulation sim;
+		sim.add_link(2.0f);
+		sim.add_hinge();
+		sim.add_piston(3.0f);
+		sim.add_swivel();
+		sim.add_link(1.5f);
+		THEN("it is at rest and ticking visits nothing")
+		{
+			REQUIRE(sim.is_at_rest());
+			sim.tick(0.016f);
+			REQUIRE(sim.get_tick_statistics().ticks == 1);
+			REQUIRE(sim.get_tick_statistics().active_components == 0);
+			REQUIRE(sim.get_tick_statistics().total_components == 5);
+		}
+
+		WHEN("the hinge gets a target and the swivel a speed")
+		{
+			sim.set_hinge_target_angle(1, 0.1f);
+			sim.set_swivel_rotation_speed(3, 1.0f);
+			REQUIRE(sim.get_active_count() == 2);
+
+			THEN("the hinge leaves once it arrived while the swivel keeps spinning")
+			{
+				for (int i = 0; i < 10; ++i)
+					sim.tick(0.016f);
+				REQUIRE(std::get<Hinge>(sim.get_components()[1]).current_angle == 0.1f);
+				REQUIRE(sim.get_active_count() == 1);
+
+				std::vector<float> velocities(3);
+				sim.get_joint_velocities(velocities);
+				REQUIRE(velocities == std::vector<float>{0.0f, 0.0f, 1.0f});
+			}
+			THEN("stopping the swivel and removing the hinge leaves the arm at rest")
+			{
+				sim.set_swivel_rotation_speed(3, 0.0f);
+				sim.tick(0.016f);
+				sim.remove_component(1);
+				REQUIRE(sim.is_at_rest());
+				REQUIRE(sim.get_joint_count() == 2);
+			}
+		}
+
+		WHEN("the piston is placed past the end of its stroke")
+		{
+			sim.set_joint_positions(std::array{0.0f, 5.0f, 0.0f});
+			REQUIRE(sim.get_active_count() == 1);
+			sim.tick(0.016f);
+
+			THEN("it is pinned at max length and comes to rest there")
+			{
+				REQUIRE(std::get<Piston>(sim.get_components()[2]).current_length == 3.0f);
+				REQUIRE(sim.is_at_rest());
+				REQUIRE(sim.get_render_data().tip_vel == glm::vec3{0.0f});
+			}
+		}
+	}
+}
+
+SCENARIO("Component handles survive removing other components")
+{
+	GIVEN("A Link, Hinge, Piston, Swivel arm addressed by handles")
+	{
+		Simulation sim;
+		auto	   link	  = sim.add_link(1.0f);
+		auto	   hinge  = sim.add_hinge();
+		auto	   piston = sim.add_piston(3.0f);
+		auto	   swivel = sim.add_swivel();
+
+		WHEN("a component in the middle is removed")
+		{
+			sim.remove_component(hinge);
+
+			THEN("later components moved down but their handles still find them")
+			{
+				REQUIRE(sim.find(link) == 0);
+				REQUIRE(sim.find(piston) == 1);
+				REQUIRE(sim.find(swivel) == 2);
+				REQUIRE(sim.get_handle(1) == piston);
+				sim.set_piston_target_length(piston, 2.0f);
+				REQUIRE(std::get<Piston>(sim.get_components()[1]).target_length == 2.0f);
+			}
+			THEN("the removed handle is stale, even once its slot is reused")
+			{
+				REQUIRE_FALSE(sim.find(hinge).has_value());
+				auto reused = sim.add_hinge();
+				REQUIRE(reused.slot == hinge.slot);
+				REQUIRE_FALSE(sim.find(hinge).has_value());
+				REQUIRE(sim.find(reused) == 3);
+				REQUIRE_THROWS_AS(sim.set_hinge_target_angle(hinge, 1.0f), std::out_of_range);
+			}
+		}
+
+		WHEN("components are removed by index")
+		{
+			sim.remove_component(std::size_t{0});
+
+			THEN("handles stay in sync with the chain")
+			{
+				REQUIRE_FALSE(sim.find(link).has_value());
+				REQUIRE(sim.find(hinge) == 0);
+				REQUIRE_FALSE(sim.find(ComponentHandle{}).has_value());
+			}
+		}
+
+		WHEN("the arm is cleared and built again")
+		{
+			sim.clear();
+			auto rebuilt = sim.add_piston(2.0f);
+
+			THEN("it starts over as a fresh arm and every old handle is stale")
+			{
+				REQUIRE(sim.get_components().size() == 1);
+				REQUIRE(sim.get_joint_count() == 1);
+				REQUIRE(sim.is_serial());
+				REQUIRE(sim.find(rebuilt) == 0);
+				for (auto handle : {link, hinge, piston, swivel})
+					REQUIRE_FALSE(sim.find(handle).has_value());
+				REQUIRE(sim.get_render_data().tip_pos.y == Catch::Approx(Piston::MIN_LENGTH));
+			}
+		}
+
+		WHEN("joint positions don't have one entry per joint")
+		{
+			std::array<float, 2> too_few{};
+			std::array<float, 4> too_many{};
+
+			THEN("getting and setting them throws before touching anything")
+			{
+				REQUIRE_THROWS_AS(sim.get_joint_positions(too_few), std::invalid_argument);
+				REQUIRE_THROWS_AS(sim.set_joint_positions(too_few), std::invalid_argument);
+				REQUIRE_THROWS_AS(sim.set_joint_positions(too_many), std::invalid_argument);
+				REQUIRE(sim.is_at_rest());
+			}
+		}
+	}
+}
+
+SCENARIO("Arms can branch into several end effectors")
+{
+	GIVEN("A link and a hinge carrying two fingers, one of them extended by a piston")
+	{
+		Simulation sim;
+		sim.add_link(1.0f);
+		auto hinge	= sim.add_hinge();
+		auto finger = sim.attach(Link{0.5f}, hinge);
+		auto other	= sim.attach(Link{0.5f}, hinge);
+		auto piston = sim.attach(Piston{Piston::MIN_LENGTH, Piston::MIN_LENGTH, 3.0f}, finger);
+
+		THEN("the storage is depth first with the piston right behind its finger")
+		{
+			auto parents = sim.get_parents();
+			REQUIRE(std::vector<std::uint32_t>(parents.begin(), parents.end())
+					== std::vector<std::uint32_t>{Simulation::NO_PARENT, 0, 1, 2, 1});
+			REQUIRE(sim.find(piston) == 3);
+			REQUIRE(sim.find(other) == 4);
+			REQUIRE_FALSE(sim.is_serial());
+		}
+		THEN("both branches start from the hinge")
+		{
+			auto chain = sim.get_chain();
+			REQUIRE(glm::length(chain[4].translation - glm::vec3{0.0f, 1.5f, 0.0f}) < 1e-5f);
+			REQUIRE(glm::length(chain[3].translation - glm::vec3{0.0f, 2.5f, 0.0f}) < 1e-5f);
+		}
+
+		WHEN("only the piston extends")
+		{
+			sim.set_piston_target_length(piston, 2.0f);
+			auto effectors = sim.get_end_effectors();
+
+			THEN("only its end effector moves")
+			{
+				REQUIRE(effectors.size() == 2);
+				REQUIRE(effectors[0].handle == piston);
+				REQUIRE(effectors[1].handle == other);
+				REQUIRE(glm::length(effectors[0].velocity - glm::vec3{0.0f, Piston::PISTON_SPEED, 0.0f}) < 1e-4f);
+				REQUIRE(glm::length(effectors[1].velocity) == 0.0f);
+				REQUIRE(sim.get_render_data().tip_vel == effectors[1].velocity); // The tip is the last component
+			}
+		}
+
+		WHEN("the hinge turns")
+		{
+			sim.set_hinge_target_angle(hinge, 1.0f);
+			auto effectors = sim.get_end_effectors();
+
+			THEN("both end effectors move around it")
+			{
+				REQUIRE(glm::length(effectors[0].velocity) > 0.0f);
+				REQUIRE(glm::length(effectors[1].velocity) > 0.0f);
+			}
+		}
+
+		WHEN("the Jacobian of the other finger is taken")
+		{
+			std::vector<JacobianColumn> jacobian(sim.get_joint_count());
+			sim.get_jacobian(jacobian, 4);
+
+			THEN("the piston on the other branch has no influence")
+			{
+				REQUIRE(jacobian.size() == 2);
+				REQUIRE(glm::length(jacobian[0].angular) > 0.0f);
+				REQUIRE(glm::length(jacobian[1].linear) == 0.0f);
+			}
+		}
+
+		WHEN("the first finger is removed")
+		{
+			sim.remove_component(finger);
+
+			THEN("the piston moves up to the hinge")
+			{
+				auto parents = sim.get_parents();
+				REQUIRE(std::vector<std::uint32_t>(parents.begin(), parents.end())
+						== std::vector<std::uint32_t>{Simulation::NO_PARENT, 0, 1, 1});
+				REQUIRE(glm::length(sim.get_chain()[2].translation - glm::vec3{0.0f, 2.0f, 0.0f}) < 1e-5f);
+			}
+		}
+	}
+
+	GIVEN("A serial arm built by attaching every component to the one before")
+	{
+		Simulation added;
+		added.add_link(2.0f);
+		added.add_hinge();
+		added.add_piston(3.0f);
+		Simulation attached;
+		auto	   link	 = attached.attach(Link{2.0f}, {});
+		auto	   hinge = attached.attach(Hinge{}, link);
+		attached.attach(Piston{Piston::MIN_LENGTH, Piston::MIN_LENGTH, 3.0f}, hinge);
+
+		THEN("it is the same arm")
+		{
+			REQUIRE(attached.is_serial());
+			REQUIRE(attached.get_render_data().tip_pos == added.get_render_data().tip_pos);
+			REQUIRE(attached.get_end_effectors().size() == 1);
+		}
+	}
+}
+
+SCENARIO("Inverse dynamics gives the joint efforts", "[simulation][dynamics]")
+{
+	GIVEN("A vertical piston carrying a horizontal link on a hinge")
+	{
+		Simulation sim;
+		auto	   piston = sim.add_piston(3.0f);
+		sim.add_hinge();
+		auto link = sim.add_link(2.0f);
+		sim.set_joint_positions(std::array{2.0f, -std::numbers::pi_v<float> / 2.0f});
+		sim.set_mass_properties(piston, {.mass = 1.0f});
+		sim.set_mass_properties(link, MassProperties::rod(3.0f, 2.0f));
+		std::array<float, 2> efforts{};
+
+		WHEN("it holds still")
+		{
+			sim.get_joint_efforts(efforts);
+			THEN("the piston carries the weight of both and the hinge the moment of the link")
+			{
+				REQUIRE(efforts[0] == Catch::Approx(4.0f * 9.81f));
+				REQUIRE(efforts[1] == Catch::Approx(3.0f * 9.81f * 1.0f));
+			}
+		}
+		WHEN("the piston is removed")
+		{
+			sim.remove_component(piston);
+			std::array<float, 1> hinge{};
+			sim.get_joint_efforts(hinge);
+			THEN("the link keeps its mass")
+			{
+				REQUIRE(sim.get_mass_properties()[1].mass == 3.0f);
+				REQUIRE(hinge[0] == Catch::Approx(3.0f * 9.81f));
+			}
+		}
+	}
+
+	GIVEN("A planar two link arm with point masses at the ends and no gravity")
+	{
+		constexpr float L1 = 1.0f, L2 = 0.8f, M1 = 2.0f, M2 = 1.5f;
+		Simulation		sim;
+		sim.set_gravity(glm::vec3{0.0f});
+		sim.add_hinge();
+		auto first = sim.add_link(L1);
+		sim.add_hinge();
+		auto second = sim.add_link(L2);
+		sim.set_mass_properties(first, {.mass = M1});
+		sim.set_mass_properties(second, {.mass = M2});
+		std::array<float, 2> q{0.3f, 0.7f}, dq{1.1f, -0.4f}, ddq{0.5f, 2.0f}, efforts{};
+		sim.set_joint_positions(q);
+
+		WHEN("both hinges accelerate")
+		{
+			sim.inverse_dynamics(dq, ddq, efforts);
+			THEN("the efforts match the closed form of the double pendulum")
+			{
+				float c2  = std::cos(q[1]);
+				float s2  = std::sin(q[1]);
+				float m11 = M1 * L1 * L1 + M2 * (L1 * L1 + 2.0f * L1 * L2 * c2 + L2 * L2);
+				float m12 = M2 * (L1 * L2 * c2 + L2 * L2);
+				float m22 = M2 * L2 * L2;
+				float h	  = M2 * L1 * L2 * s2;
+				REQUIRE(efforts[0]
+						== Catch::Approx(m11 * ddq[0] + m12 * ddq[1] - h * (2.0f * dq[0] * dq[1] + dq[1] * dq[1]))
+							   .margin(1e-4));
+				REQUIRE(efforts[1] == Catch::Approx(m12 * ddq[0] + m22 * ddq[1] + h * dq[0] * dq[0]).margin(1e-4));
+			}
+		}
+	}
+}
+
+SCENARIO("Render data carries the motion of every segment", "[simulation]")
+{
+	GIVEN("A piston extending on a bent hinge while a swivel spins below them")
+	{
+		Simulation sim;
+		sim.add_link(1.0f);
+		auto swivel = sim.add_swivel();
+		auto hinge	= sim.add_hinge();
+		auto piston = sim.add_piston(3.0f);
+		sim.add_link(0.5f);
+		sim.set_joint_positions(std::array{0.0f, 0.3f, 1.0f});
+		sim.set_swivel_rotation_speed(swivel, 0.8f);
+		sim.set_hinge_target_angle(hinge, 2.5f);
+		sim.set_piston_target_length(piston, 3.0f);
+
+		WHEN("three steps are taken")
+		{
+			constexpr float			 DT = 0.01f;
+			std::array<RenderData, 3> steps;
+			for (auto& step : steps)
+			{
+				sim.get_render_data(step, {.compute_segment_motion = true});
+				sim.tick(DT);
+			}
+
+			THEN("velocities and accelerations match finite differences of the positions")
+			{
+				const auto& middle = steps[1].segment_motion;
+				REQUIRE(middle.size() == 5);
+				for (std::size_t i = 0; i < middle.size(); ++i)
+				{
+					glm::vec3 before = steps[0].segment_motion[i].position;
+					glm::vec3 after	 = steps[2].segment_motion[i].position;
+					glm::vec3 velocity	   = (after - before) / (2.0f * DT);
+					glm::vec3 acceleration = (after - 2.0f * middle[i].position + before) / (DT * DT);
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						REQUIRE(middle[i].linear_velocity[axis] == Catch::Approx(velocity[axis]).margin(1e-2));
+						REQUIRE(middle[i].linear_acceleration[axis] == Catch::Approx(acceleration[axis]).margin(5e-2));
+					}
+				}
+			}
+			THEN("the last segment moves with the tip")
+			{
+				const auto& last = steps[1].segment_motion.back();
+				REQUIRE(last.position.y == Catch::Approx(steps[1].tip_pos.y));
+				REQUIRE(glm::length(last.linear_velocity - steps[1].tip_vel) < 1e-4f);
+				REQUIRE(last.angular_velocity.y == Catch::Approx(0.8f).margin(1e-2));
+			}
+		}
+		THEN("segment motion is off by default")
+		{
+			REQUIRE(sim.get_render_data().segment_motion.empty());
+		}
+	}
+}
+
+SCENARIO("Long serial chains are evaluated as a parallel scan", "[simulation]")
+{
+	GIVEN("A snake of 20000 segments curling in every direction, once kept serial and once scanned on 4 threads")
+	{
+		Simulation serial;
+		serial.set_chain_threads(1);
+		for (int i = 0; i < 5000; ++i)
+		{
+			serial.add_link(0.1f);
+			serial.add_hinge();
+			serial.add_piston(2.0f);
+			serial.add_swivel();
+		}
+		std::vector<float> positions(serial.get_joint_count());
+		for (std::size_t i = 0; i < positions.size(); ++i)
+		{
+			auto f		 = static_cast<float>(i);
+			positions[i] = i % 3 == 1 ? 1.0f + 0.5f * std::sin(0.1f * f) : 0.3f * std::cos(0.37f * f); // Pistons are 1
+		}
+		serial.set_joint_positions(positions);
+		auto parallel = serial;
+		parallel.set_chain_threads(4);
+
+		// Both accumulate rounding along the snake, so the tolerance grows with the distance along it
+		auto matches = [&](const Simulation& sim)
+		{
+			auto  expected = serial.get_chain();
+			auto  actual   = sim.get_chain();
+			float distance = 0.0f;
+			for (std::size_t i = 0; i < expected.size(); ++i)
+			{
+				if (i > 0)
+					distance += glm::length(expected[i].translation - expected[i - 1].translation);
+				if (glm::length(actual[i].translation - expected[i].translation) > 1e-5f + 1e-6f * distance
+					|| glm::length(actual[i].rotation[1] - expected[i].rotation[1]) > 1e-4f)
+					return false;
+			}
+			return true;
+		};
+
+		THEN("every joint matches the serial pass")
+		{
+			REQUIRE(matches(parallel));
+			REQUIRE(parallel.get_render_data().tip_pos == parallel.get_chain().back().translation);
+		}
+		THEN("an arm left at the default of one thread per core matches as well")
+		{
+			auto automatic = serial;
+			automatic.set_chain_threads(0);
+			REQUIRE(matches(automatic));
+		}
+		WHEN("only the far half of the snake moves")
+		{
+			REQUIRE(matches(parallel));
+			// Above the threshold, so the scan has to start from the joint before the first dirty one
+			serial.set_swivel_angle(serial.get_components().size() / 2 - 1, 1.0f);
+			parallel.set_swivel_angle(parallel.get_components().size() / 2 - 1, 1.0f);
+
+			THEN("it still matches")
+			{
+				REQUIRE(matches(parallel));
+			}
+		}
+		WHEN("the scanned arm is copied and the copy moves")
+		{
+			REQUIRE(matches(parallel));
+			auto copy = parallel;
+			serial.set_swivel_angle(3, 0.5f);
+			copy.set_swivel_angle(3, 0.5f);
+
+			THEN("the copy scans on a pool of its own")
+			{
+				REQUIRE(matches(copy));
+				parallel.set_swivel_angle(3, 0.5f);
+				REQUIRE(matches(parallel));
+			}
+		}
+		WHEN("the scanned arm is ticked by a batch on another pool")
+		{
+			SimulationBatch batch(2);
+			batch.add_simulation(parallel);
+			batch.add_simulation(parallel);
+			for (std::size_t i = 0; i < batch.size(); ++i)
+				batch.get_simulation(i).set_hinge_target_angle(1, 0.5f);
+			serial.set_hinge_target_angle(1, 0.5f);
+			batch.tick(0.01f);
+			serial.tick(0.01f);
+			batch.compute_render_data();
+
+			THEN("the chain stays on the batch thread and matches the serial pass exactly")
+			{
+				auto expected = serial.get_render_data().tip_pos;
+				REQUIRE(batch.get_render_data()[0].tip_pos == expected);
+				REQUIRE(batch.get_render_data()[1].tip_pos == expected);
+			}
+		}
+	}
+}
@@ -0,0 +1,159 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <RobotArm/Simulation/Simulation.hpp>
+#include <RobotArm/Simulation/SoASimulation.hpp>
+
+namespace
+{
+bool approx_equal(const glm::mat4& lhs, const glm::mat4& rhs, float tolerance = 1e-4f)
+{
+	for (int column = 0; column < 4; ++column)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			if (std::abs(lhs[column][row] - rhs[column][row]) > tolerance)
+				return false;
+		}
+	}
+	return true;
+}
+
+bool approx_equal(const RenderData& lhs, const RenderData& rhs)
+{
+	if (lhs.components.size() != rhs.components.size())
+		return false;
+	for (std::size_t i = 0; i < lhs.components.size(); ++i)
+	{
+		if (lhs.components[i].first != rhs.components[i].first
+			|| !approx_equal(lhs.components[i].second, rhs.components[i].second))
+			return false;
+	}
+	return glm::length(lhs.tip_pos - rhs.tip_pos) < 1e-4f && glm::length(lhs.tip_vel - rhs.tip_vel) < 1e-4f;
+}
+
+// Builds the same arm in both engines, every component type a few times over
+template <class Sim>
+void build_arm(Sim& sim)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		sim.add_link(1.0f + 0.25f * static_cast<float>(i));
+		sim.add_swivel();
+		sim.add_hinge();
+		sim.add_piston(3.0f);
+	}
+}
+
+// Targets by chain index, so both engines get the same commands
+template <class Sim>
+void set_targets(Sim& sim)
+{
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		sim.set_swivel_rotation_speed(i * 4 + 1, 0.5f - 0.3f * static_cast<float>(i));
+		sim.set_hinge_target_angle(i * 4 + 2, 1.0f - 0.4f * static_cast<float>(i));
+		sim.set_piston_target_length(i * 4 + 3, 1.5f + 0.5f * static_cast<float>(i));
+	}
+}
+} // namespace
+
+SCENARIO("SoASimulation matches Simulation", "[simulation][soa]")
+{
+	GIVEN("The same arm built in both engines with the same targets")
+	{
+		Simulation	  sim;
+		SoASimulation soa;
+		build_arm(sim);
+		build_arm(soa);
+		set_targets(sim);
+		set_targets(soa);
+
+		THEN("both agree before the first tick")
+		{
+			REQUIRE(soa.get_component_types() == sim.get_component_types());
+			REQUIRE(approx_equal(soa.get_render_data(), sim.get_render_data()));
+		}
+
+		WHEN("both are ticked past the point where some joints reach their targets")
+		{
+			bool every_tick_matches = true;
+			for (int i = 0; i < 120; ++i)
+			{
+				sim.tick(0.01f);
+				soa.tick(0.01f);
+				every_tick_matches = every_tick_matches && approx_equal(soa.get_render_data(), sim.get_render_data());
+			}
+
+			THEN("tip position, tip velocity and every model matrix agree on every tick")
+			{
+				REQUIRE(every_tick_matches);
+			}
+		}
+
+		WHEN("a component is removed from the middle of both")
+		{
+			sim.tick(0.1f);
+			soa.tick(0.1f);
+			sim.remove_component(6);
+			soa.remove_component(6);
+			sim.tick(0.1f);
+			soa.tick(0.1f);
+
+			THEN("they still agree")
+			{
+				REQUIRE(soa.get_component_types() == sim.get_component_types());
+				REQUIRE(approx_equal(soa.get_render_data(), sim.get_render_data()));
+			}
+		}
+
+		WHEN("a piston target is outside the piston's range")
+		{
+			THEN("both throw")
+			{
+				REQUIRE_THROWS_AS(sim.set_piston_target_length(3, 3.5f), std::invalid_argument);
+				REQUIRE_THROWS_AS(soa.set_piston_target_length(3, 3.5f), std::invalid_argument);
+			}
+		}
+	}
+}
+
+SCENARIO("Render data is written into the caller's buffer", "[simulation][soa]")
+{
+	GIVEN("A buffer that already held a frame of each engine")
+	{
+		Simulation	  sim;
+		SoASimulation soa;
+		build_arm(sim);
+		build_arm(soa);
+		set_targets(sim);
+		set_targets(soa);
+		RenderData sim_out;
+		RenderData soa_out;
+		sim.get_render_data(sim_out);
+		soa.get_render_data(soa_out);
+		const auto* sim_storage = sim_out.components.data();
+		const auto* soa_storage = soa_out.components.data();
+
+		WHEN("the next frames are written into the same buffers")
+		{
+			for (int i = 0; i < 10; ++i)
+			{
+				sim.tick(0.01f);
+				soa.tick(0.01f);
+				sim.get_render_data(sim_out);
+				soa.get_render_data(soa_out);
+			}
+
+			THEN("the component storage is reused instead of reallocated")
+			{
+				REQUIRE(sim_out.components.data() == sim_storage);
+				REQUIRE(soa_out.components.data() == soa_storage);
+				REQUIRE(approx_equal(soa_out, sim_out));
+			}
+		}
+	}
+}
@@ -0,0 +1,114 @@
+//
+// Created by chris on 10/18/26.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <RobotArm/Simulation/Trajectory.hpp>
+#include <vector>
+
+namespace
+{
+Simulation make_arm()
+{
+	Simulation sim;
+	sim.add_link(2.0f);
+	sim.add_hinge();
+	sim.add_piston(3.0f);
+	sim.add_swivel();
+	sim.add_hinge();
+	sim.add_link(1.5f);
+	sim.set_hinge_target_angle(1, 0.8f);
+	sim.set_piston_target_length(2, 2.5f);
+	sim.set_swivel_rotation_speed(3, 1.0f);
+	sim.set_hinge_target_angle(4, -0.5f);
+	return sim;
+}
+
+std::filesystem::path temporary_log(const char* name)
+{
+	return std::filesystem::temp_directory_path() / name;
+}
+} // namespace
+
+SCENARIO("Trajectories are recorded and replayed")
+{
+	GIVEN("A recording of a moving arm")
+	{
+		auto			   path = temporary_log("robot_arm_trajectory_test.rtraj");
+		TrajectorySettings settings{.dt = 0.001f, .keyframe_interval = 100};
+		Simulation		   sim = make_arm();
+		// Joint positions of every frame, to compare the replay against
+		std::vector<std::vector<float>> expected;
+		std::vector<glm::vec3>			expected_tips;
+		{
+			TrajectoryRecorder recorder(path, sim, settings);
+			for (int i = 0; i < 1500; ++i)
+			{
+				if (i == 700)
+					sim.set_hinge_target_angle(1, -0.3f); // Reverses mid recording
+				recorder.record(sim);
+				auto& positions = expected.emplace_back(sim.get_joint_count());
+				sim.get_joint_positions(positions);
+				expected_tips.push_back(sim.get_chain().back().translation);
+				sim.tick(settings.dt);
+			}
+		}
+
+		WHEN("it is opened for playback")
+		{
+			TrajectoryPlayer player(path);
+
+			THEN("every frame comes back within the quantization step, in any seek order")
+			{
+				REQUIRE(player.frame_count() == 1500);
+				std::vector<float> positions(player.get_simulation().get_joint_count());
+				for (std::uint64_t frame : {0ull, 1499ull, 650ull, 651ull, 99ull, 100ull, 1234ull, 5ull})
+				{
+					player.seek_frame(frame);
+					player.get_simulation().get_joint_positions(positions);
+					for (std::size_t i = 0; i < positions.size(); ++i)
+						REQUIRE(std::abs(positions[i] - expected[frame][i]) <= settings.position_resolution);
+					REQUIRE(glm::length(player.tip_position() - expected_tips[frame]) < 1e-4f);
+				}
+			}
+
+			THEN("the replayed arm renders where the recorded tip was")
+			{
+				RenderData out;
+				player.get_render_data(out, 1.0);
+				auto tip = player.get_simulation().get_chain().back().translation;
+				REQUIRE(glm::length(tip - out.tip_pos) < 1e-3f);
+			}
+		}
+		std::filesystem::remove(path);
+	}
+
+	GIVEN("A resting arm recorded for a long time")
+	{
+		auto	   path = temporary_log("robot_arm_idle_test.rtraj");
+		Simulation sim;
+		sim.add_link(2.0f);
+		sim.add_hinge();
+		sim.add_piston(3.0f);
+		sim.add_swivel();
+		std::size_t size = 0;
+		{
+			TrajectoryRecorder recorder(path, sim);
+			for (int i = 0; i < 60'000; ++i)
+				recorder.record(sim);
+			recorder.finish();
+			size = recorder.bytes_written();
+		}
+
+		THEN("a minute at 1 kHz takes a few kilobytes")
+		{
+			INFO(size);
+			REQUIRE(size < 8 * 1024);
+			TrajectoryPlayer player(path);
+			player.seek(59.0);
+			REQUIRE(glm::length(player.tip_position() - sim.get_chain().back().translation) < 1e-4f);
+		}
+		std::filesystem::remove(path);
+	}
+}